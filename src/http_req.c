@@ -8,16 +8,33 @@
 #include "http_req.h"
 #include <stddef.h>
 #include <string.h>
+#include <strings.h>
+#include <ctype.h>
 
-http_req_info_t
-http_req_parse(char* const p_req_buf)
-{
-    static const char g_two_crlf[] = "\r\n\r\n";
-    static const char g_two_lf[]   = "\n\n";
-    static const char g_one_crlf[] = "\r\n";
-    static const char g_one_lf[]   = "\n";
+#define HTTP_REQ_DECIMAL_BASE (10U)
+
+#define HTTP_REQ_HTTP_DATE_EXAMPLE  "Sun, 06 Nov 1994 08:49:37 GMT"
+#define HTTP_REQ_SECONDS_PER_MINUTE (60)
+#define HTTP_REQ_SECONDS_PER_HOUR   (60 * HTTP_REQ_SECONDS_PER_MINUTE)
+#define HTTP_REQ_SECONDS_PER_DAY    (24 * HTTP_REQ_SECONDS_PER_HOUR)
+#define HTTP_REQ_NUM_MONTHS         (12U)
+
+#define HTTP_REQ_FNV1A_OFFSET_BASIS (2166136261U)
+#define HTTP_REQ_FNV1A_PRIME        (16777619U)
+#define HTTP_REQ_HASH_FOLD_SHIFT    (16U)
+#define HTTP_REQ_HASH_FOLD_MASK     (0xFFFFU)
 
-    http_req_info_t req_info = {
+static const char g_http_req_content_len_lower[] = "content-length";
+static const char g_http_req_range_unit_bytes[]  = "bytes=";
+
+static const char* const g_http_req_months[HTTP_REQ_NUM_MONTHS] = {
+    "Jan", "Feb", "Mar", "Apr", "May", "Jun", "Jul", "Aug", "Sep", "Oct", "Nov", "Dec",
+};
+
+static http_req_info_t
+http_req_info_init(void)
+{
+    const http_req_info_t req_info = {
         .is_success    = false,
         .http_cmd      = {
             .ptr = NULL,
@@ -38,124 +55,793 @@ http_req_parse(char* const p_req_buf)
             .ptr = NULL,
         },
     };
+    return req_info;
+}
+
+http_req_info_t
+http_req_parse(char* const p_req_buf)
+{
+    http_req_parser_t parser = { 0 };
+    http_req_parser_init(&parser);
+    (void)http_req_parser_feed(&parser, p_req_buf, (uint32_t)strlen(p_req_buf));
+    return http_req_parser_get_info(&parser, p_req_buf);
+}
 
-    // find body
-    char* p_ptr2 = strstr(p_req_buf, g_two_crlf);
-    if (NULL != p_ptr2)
+void
+http_req_parser_init(http_req_parser_t* const p_parser)
+{
+    memset(p_parser, 0, sizeof(*p_parser));
+    p_parser->state = HTTP_REQ_PARSER_STATE_METHOD;
+}
+
+static uint32_t
+http_req_hash_update(const uint32_t hash, const char ch)
+{
+    return (hash ^ (uint32_t)(unsigned char)tolower((unsigned char)ch)) * HTTP_REQ_FNV1A_PRIME;
+}
+
+static uint16_t
+http_req_hash_fold(const uint32_t hash)
+{
+    return (uint16_t)((hash >> HTTP_REQ_HASH_FOLD_SHIFT) ^ (hash & HTTP_REQ_HASH_FOLD_MASK));
+}
+
+uint16_t
+http_req_header_calc_name_hash(const char* const p_name, const uint32_t name_len)
+{
+    uint32_t hash = HTTP_REQ_FNV1A_OFFSET_BASIS;
+    for (uint32_t i = 0; i < name_len; ++i)
     {
-        p_ptr2[strlen(g_one_crlf)] = '\0';
-        req_info.http_body.ptr     = p_ptr2 + strlen(g_two_crlf);
+        hash = http_req_hash_update(hash, p_name[i]);
     }
-    else
+    return http_req_hash_fold(hash);
+}
+
+static void
+http_req_parser_start_hdr_line(http_req_parser_t* const p_parser, const uint32_t line_start_offset)
+{
+    p_parser->state                = HTTP_REQ_PARSER_STATE_HDR_NAME;
+    p_parser->line_start_offset    = line_start_offset;
+    p_parser->hdr_name_len         = 0;
+    p_parser->hdr_name_hash        = HTTP_REQ_FNV1A_OFFSET_BASIS;
+    p_parser->flag_hdr_content_len = true;
+}
+
+static void
+http_req_parser_start_hdr_value(http_req_parser_t* const p_parser, const uint32_t val_offset)
+{
+    p_parser->state                = HTTP_REQ_PARSER_STATE_HDR_VALUE;
+    p_parser->hdr_val_offset       = val_offset;
+    p_parser->hdr_val_end_offset   = 0;
+    p_parser->flag_hdr_val_started = false;
+}
+
+/**
+ * @brief Add the header field which ends at lf_offset to the index.
+ */
+static void
+http_req_parser_add_hdr_field_to_index(http_req_parser_t* const p_parser, const uint32_t lf_offset)
+{
+    http_req_header_index_t* const p_index = &p_parser->hdr_index;
+    if (p_index->num_fields >= HTTP_REQ_HEADER_INDEX_SIZE)
+    {
+        p_index->is_overflow = true;
+        return;
+    }
+    const uint32_t val_end_offset = (0 != p_parser->hdr_val_end_offset) ? p_parser->hdr_val_end_offset : lf_offset;
+    const uint32_t val_offset     = (p_parser->hdr_val_offset < val_end_offset) ? p_parser->hdr_val_offset
+                                                                                : val_end_offset;
+    if ((val_end_offset - p_parser->hdr_offset) > UINT16_MAX)
+    {
+        p_index->is_overflow = true;
+        return;
+    }
+    http_req_header_field_t* const p_field = &p_index->fields[p_index->num_fields];
+
+    p_field->name_hash   = http_req_hash_fold(p_parser->hdr_name_hash);
+    p_field->name_offset = (uint16_t)(p_parser->line_start_offset - p_parser->hdr_offset);
+    p_field->name_len    = (uint16_t)p_parser->hdr_name_len;
+    p_field->val_offset  = (uint16_t)(val_offset - p_parser->hdr_offset);
+    p_field->val_len     = (uint16_t)(val_end_offset - val_offset);
+    p_index->num_fields += 1;
+}
+
+static void
+http_req_parser_end_req_line(http_req_parser_t* const p_parser, const char* const p_req_buf, const uint32_t lf_offset)
+{
+    const bool flag_cr            = (0 != lf_offset) && ('\r' == p_req_buf[lf_offset - 1]);
+    p_parser->req_line_end_offset = flag_cr ? (lf_offset - 1) : lf_offset;
+    p_parser->hdr_offset          = lf_offset + 1;
+    http_req_parser_start_hdr_line(p_parser, lf_offset + 1);
+}
+
+static void
+http_req_parser_handle_req_line_char(http_req_parser_t* const p_parser, const char* const p_req_buf, const char ch)
+{
+    const uint32_t offset = p_parser->offset;
+    if ('\n' == ch)
+    {
+        p_parser->flag_req_line_is_valid = (HTTP_REQ_PARSER_STATE_VER == p_parser->state) ? true : false;
+        http_req_parser_end_req_line(p_parser, p_req_buf, offset);
+        return;
+    }
+    switch (p_parser->state)
     {
-        p_ptr2 = strstr(p_req_buf, g_two_lf);
-        if (NULL != p_ptr2)
+        case HTTP_REQ_PARSER_STATE_METHOD:
+            if (' ' == ch)
+            {
+                p_parser->uri_offset = offset + 1;
+                p_parser->state      = HTTP_REQ_PARSER_STATE_URI;
+            }
+            break;
+        case HTTP_REQ_PARSER_STATE_URI:
+            if ('?' == ch)
+            {
+                p_parser->uri_params_offset = offset + 1;
+                p_parser->state             = HTTP_REQ_PARSER_STATE_URI_PARAMS;
+            }
+            else if (' ' == ch)
+            {
+                p_parser->ver_offset = offset + 1;
+                p_parser->state      = HTTP_REQ_PARSER_STATE_VER;
+            }
+            else
+            {
+                // Character of URI path
+            }
+            break;
+        case HTTP_REQ_PARSER_STATE_URI_PARAMS:
+            if (' ' == ch)
+            {
+                p_parser->ver_offset = offset + 1;
+                p_parser->state      = HTTP_REQ_PARSER_STATE_VER;
+            }
+            break;
+        default:
+            break;
+    }
+}
+
+static void
+http_req_parser_handle_hdr_name_char(http_req_parser_t* const p_parser, const char* const p_req_buf, const char ch)
+{
+    const uint32_t offset = p_parser->offset;
+    if ('\n' == ch)
+    {
+        const uint32_t line_len = offset - p_parser->line_start_offset;
+        if ((0 == line_len) || ((1 == line_len) && ('\r' == p_req_buf[p_parser->line_start_offset])))
         {
-            p_ptr2[strlen(g_one_lf)] = '\0';
-            req_info.http_body.ptr   = p_ptr2 + strlen(g_two_lf);
+            // The empty line at the end of the header
+            p_parser->hdr_end_offset     = p_parser->line_start_offset;
+            p_parser->body_offset        = offset + 1;
+            p_parser->state              = HTTP_REQ_PARSER_STATE_BODY;
+            p_parser->hdr_index.is_valid = true;
         }
         else
         {
-            return req_info;
+            // The line without ':' is ignored
+            http_req_parser_start_hdr_line(p_parser, offset + 1);
+        }
+        return;
+    }
+    if (':' == ch)
+    {
+        p_parser->flag_hdr_content_len = p_parser->flag_hdr_content_len
+                                         && (p_parser->hdr_name_len == (sizeof(g_http_req_content_len_lower) - 1));
+        if (p_parser->flag_hdr_content_len)
+        {
+            p_parser->content_len = 0;
         }
+        http_req_parser_start_hdr_value(p_parser, offset + 1);
+        return;
+    }
+    p_parser->hdr_name_hash = http_req_hash_update(p_parser->hdr_name_hash, ch);
+    if (p_parser->flag_hdr_content_len)
+    {
+        p_parser->flag_hdr_content_len = (p_parser->hdr_name_len < (sizeof(g_http_req_content_len_lower) - 1))
+                                         && (g_http_req_content_len_lower[p_parser->hdr_name_len]
+                                             == (char)tolower((unsigned char)ch));
     }
+    p_parser->hdr_name_len += 1;
+}
 
-    // find header
-    p_ptr2 = strstr(p_req_buf, g_one_crlf);
-    if (NULL != p_ptr2)
+static void
+http_req_parser_handle_hdr_value_char(http_req_parser_t* const p_parser, const char ch)
+{
+    const uint32_t offset = p_parser->offset;
+    if ('\n' == ch)
     {
-        *p_ptr2                  = '\0';
-        req_info.http_header.ptr = p_ptr2 + strlen(g_one_crlf);
+        http_req_parser_add_hdr_field_to_index(p_parser, offset);
+        http_req_parser_start_hdr_line(p_parser, offset + 1);
+        return;
+    }
+    if ('\r' == ch)
+    {
+        if (0 == p_parser->hdr_val_end_offset)
+        {
+            p_parser->hdr_val_end_offset = offset;
+        }
+    }
+    else if (!p_parser->flag_hdr_val_started)
+    {
+        if (' ' == ch)
+        {
+            p_parser->hdr_val_offset = offset + 1;
+        }
+        else
+        {
+            p_parser->flag_hdr_val_started = true;
+        }
     }
     else
     {
-        p_ptr2 = strstr(p_req_buf, g_one_lf);
-        if (NULL != p_ptr2)
+        // Character of the header field value
+    }
+    if (!p_parser->flag_hdr_content_len)
+    {
+        return;
+    }
+    if ((ch >= '0') && (ch <= '9'))
+    {
+        const uint32_t digit = (uint32_t)(ch - '0');
+        if (p_parser->content_len > ((UINT32_MAX - digit) / HTTP_REQ_DECIMAL_BASE))
         {
-            *p_ptr2                  = '\0';
-            req_info.http_header.ptr = p_ptr2 + strlen(g_one_lf);
+            p_parser->content_len = UINT32_MAX;
         }
         else
         {
-            req_info.http_header.ptr = p_req_buf + strlen(p_req_buf);
+            p_parser->content_len = (p_parser->content_len * HTTP_REQ_DECIMAL_BASE) + digit;
         }
     }
-
-    char* p_ptr1          = p_req_buf;
-    req_info.http_cmd.ptr = p_ptr1;
-    p_ptr2                = strchr(p_ptr1, ' ');
-    if (NULL == p_ptr2)
+    else if ((' ' != ch) || (0 != p_parser->content_len))
     {
-        return req_info;
+        // Leading spaces are skipped, the number ends at the first non-digit character
+        p_parser->flag_hdr_content_len = false;
+    }
+    else
+    {
+        // Leading space
     }
-    *p_ptr2 = '\0';
-    p_ptr1  = p_ptr2 + 1;
+}
 
-    req_info.http_uri.ptr = p_ptr1;
-    p_ptr2                = strchr(p_ptr1, ' ');
-    if (NULL == p_ptr2)
+http_req_parser_res_e
+http_req_parser_feed(http_req_parser_t* const p_parser, const char* const p_req_buf, const uint32_t req_size)
+{
+    while ((HTTP_REQ_PARSER_STATE_BODY != p_parser->state) && (p_parser->offset < req_size))
     {
-        return req_info;
+        const char ch = p_req_buf[p_parser->offset];
+        switch (p_parser->state)
+        {
+            case HTTP_REQ_PARSER_STATE_METHOD:
+            case HTTP_REQ_PARSER_STATE_URI:
+            case HTTP_REQ_PARSER_STATE_URI_PARAMS:
+            case HTTP_REQ_PARSER_STATE_VER:
+                http_req_parser_handle_req_line_char(p_parser, p_req_buf, ch);
+                break;
+            case HTTP_REQ_PARSER_STATE_HDR_NAME:
+                http_req_parser_handle_hdr_name_char(p_parser, p_req_buf, ch);
+                break;
+            case HTTP_REQ_PARSER_STATE_HDR_VALUE:
+                http_req_parser_handle_hdr_value_char(p_parser, ch);
+                break;
+            case HTTP_REQ_PARSER_STATE_BODY:
+                break;
+        }
+        p_parser->offset += 1;
+    }
+    if (HTTP_REQ_PARSER_STATE_BODY != p_parser->state)
+    {
+        return HTTP_REQ_PARSER_RES_NEED_MORE;
+    }
+    if ((req_size - p_parser->body_offset) < p_parser->content_len)
+    {
+        return HTTP_REQ_PARSER_RES_NEED_MORE;
     }
-    *p_ptr2 = '\0';
+    return HTTP_REQ_PARSER_RES_COMPLETE;
+}
 
-    req_info.http_ver.ptr = p_ptr2 + 1;
+uint32_t
+http_req_parser_get_req_len(const http_req_parser_t* const p_parser)
+{
+    return p_parser->body_offset + p_parser->content_len;
+}
 
-    p_ptr2 = strchr(req_info.http_uri.ptr, '?');
-    if (NULL != p_ptr2)
+http_req_info_t
+http_req_parser_get_info(const http_req_parser_t* const p_parser, char* const p_req_buf)
+{
+    http_req_info_t req_info = http_req_info_init();
+    if (HTTP_REQ_PARSER_STATE_BODY != p_parser->state)
     {
-        *p_ptr2                      = '\0';
-        req_info.http_uri_params.ptr = p_ptr2 + 1;
+        return req_info;
     }
+    req_info.http_body.ptr                   = &p_req_buf[p_parser->body_offset];
+    p_req_buf[p_parser->hdr_end_offset]      = '\0';
+    req_info.http_header.ptr                 = &p_req_buf[p_parser->hdr_offset];
+    req_info.http_header.index               = p_parser->hdr_index;
+    p_req_buf[p_parser->req_line_end_offset] = '\0';
+    req_info.http_cmd.ptr                    = p_req_buf;
+    if (!p_parser->flag_req_line_is_valid)
+    {
+        return req_info;
+    }
+    p_req_buf[p_parser->uri_offset - 1] = '\0';
+    req_info.http_uri.ptr               = &p_req_buf[p_parser->uri_offset];
+    if (0 != p_parser->uri_params_offset)
+    {
+        p_req_buf[p_parser->uri_params_offset - 1] = '\0';
+        req_info.http_uri_params.ptr               = &p_req_buf[p_parser->uri_params_offset];
+    }
+    p_req_buf[p_parser->ver_offset - 1] = '\0';
+    req_info.http_ver.ptr               = &p_req_buf[p_parser->ver_offset];
 
     req_info.is_success = true;
 
     return req_info;
 }
 
+/**
+ * @brief Remove the quotes around the header field value.
+ * @return ptr to the value without quotes or NULL if the closing quote is missing.
+ */
+static const char*
+http_req_header_unquote_value(const char* const p_val, const uint32_t val_len, uint32_t* const p_len)
+{
+    if ((0 == val_len) || ('"' != p_val[0]))
+    {
+        *p_len = val_len;
+        return p_val;
+    }
+    if ((val_len < 2) || ('"' != p_val[val_len - 1]))
+    {
+        return NULL;
+    }
+    *p_len = val_len - 2;
+    return &p_val[1];
+}
+
+/**
+ * @brief Find the header field by scanning the header line by line.
+ * @note It's used if the field was not found in the index and the index is incomplete.
+ */
+static const char*
+http_req_header_scan_field(
+    const char* const p_header,
+    const char* const p_name,
+    const uint32_t    name_len,
+    uint32_t* const   p_val_len)
+{
+    const char* p_line = p_header;
+    while ('\0' != *p_line)
+    {
+        const char* const p_eol = strpbrk(p_line, "\r\n");
+        if (NULL == p_eol)
+        {
+            return NULL;
+        }
+        const char* const p_colon = memchr(p_line, ':', (size_t)(p_eol - p_line));
+        if ((NULL != p_colon) && ((uint32_t)(p_colon - p_line) == name_len)
+            && (0 == strncasecmp(p_line, p_name, name_len)))
+        {
+            const char* p_val = p_colon + 1;
+            while (' ' == *p_val)
+            {
+                p_val += 1;
+            }
+            *p_val_len = (uint32_t)(p_eol - p_val);
+            return p_val;
+        }
+        const char* const p_lf = strchr(p_eol, '\n');
+        if (NULL == p_lf)
+        {
+            return NULL;
+        }
+        p_line = p_lf + 1;
+    }
+    return NULL;
+}
+
 const char*
 http_req_header_get_field(const http_req_header_t req_header, const char* const p_field_name, uint32_t* const p_len)
 {
     *p_len = 0;
 
-    const char* p_start = strcasestr(req_header.ptr, p_field_name);
-    if (NULL == p_start)
+    if (NULL == req_header.ptr)
     {
         return NULL;
     }
-    const char* p_val = p_start + strlen(p_field_name);
-    while (' ' == *p_val)
+    uint32_t name_len = (uint32_t)strlen(p_field_name);
+    if ((0 != name_len) && (':' == p_field_name[name_len - 1]))
     {
-        p_val += 1;
+        name_len -= 1;
     }
-    if ('"' == *p_val)
+
+    const http_req_header_index_t* const p_index = &req_header.index;
+    if (p_index->is_valid)
     {
-        p_val += 1;
-        const char* p_end = strpbrk(p_val, "\r\n");
-        if (NULL == p_end)
+        const uint16_t name_hash = http_req_header_calc_name_hash(p_field_name, name_len);
+        for (uint32_t i = 0; i < p_index->num_fields; ++i)
         {
-            return NULL;
+            const http_req_header_field_t* const p_field = &p_index->fields[i];
+            if ((p_field->name_hash == name_hash) && (p_field->name_len == name_len)
+                && (0 == strncasecmp(&req_header.ptr[p_field->name_offset], p_field_name, name_len)))
+            {
+                return http_req_header_unquote_value(&req_header.ptr[p_field->val_offset], p_field->val_len, p_len);
+            }
         }
-        if (p_end <= p_val)
+        if (!p_index->is_overflow)
         {
             return NULL;
         }
-        p_end -= 1;
-        if ('"' != *p_end)
+    }
+
+    uint32_t          val_len = 0;
+    const char* const p_val   = http_req_header_scan_field(req_header.ptr, p_field_name, name_len, &val_len);
+    if (NULL == p_val)
+    {
+        return NULL;
+    }
+    return http_req_header_unquote_value(p_val, val_len, p_len);
+}
+
+static uint32_t
+http_req_range_skip_spaces(const char* const p_val, const uint32_t val_len, uint32_t offset)
+{
+    while ((offset < val_len) && ((' ' == p_val[offset]) || ('\t' == p_val[offset])))
+    {
+        offset += 1;
+    }
+    return offset;
+}
+
+static bool
+http_req_range_parse_num(const char* const p_val, const uint32_t val_len, uint32_t* const p_offset, size_t* const p_num)
+{
+    const uint32_t start_offset = *p_offset;
+    uint32_t       offset       = start_offset;
+    size_t         num          = 0;
+    while ((offset < val_len) && (p_val[offset] >= '0') && (p_val[offset] <= '9'))
+    {
+        const size_t digit = (size_t)(p_val[offset] - '0');
+        if (num > ((SIZE_MAX - digit) / HTTP_REQ_DECIMAL_BASE))
         {
-            return NULL;
+            return false;
         }
-        *p_len = (uint32_t)(p_end - p_val);
+        num = (num * HTTP_REQ_DECIMAL_BASE) + digit;
+        offset += 1;
+    }
+    if (offset == start_offset)
+    {
+        return false;
+    }
+    *p_offset = offset;
+    *p_num    = num;
+    return true;
+}
+
+bool
+http_req_parse_range(const char* const p_val, const uint32_t val_len, http_req_range_t* const p_range)
+{
+    const uint32_t unit_len = (uint32_t)(sizeof(g_http_req_range_unit_bytes) - 1);
+
+    p_range->flag_suffix = false;
+    p_range->first       = 0;
+    p_range->last        = SIZE_MAX;
+    p_range->suffix_len  = 0;
+
+    if ((NULL == p_val) || (val_len <= unit_len) || (0 != strncasecmp(p_val, g_http_req_range_unit_bytes, unit_len)))
+    {
+        return false;
+    }
+    uint32_t offset = http_req_range_skip_spaces(p_val, val_len, unit_len);
+    if ((offset < val_len) && ('-' == p_val[offset]))
+    {
+        offset += 1;
+        if (!http_req_range_parse_num(p_val, val_len, &offset, &p_range->suffix_len))
+        {
+            return false;
+        }
+        p_range->flag_suffix = true;
     }
     else
     {
-        const char* p_end = strpbrk(p_val, "\r\n");
-        if (NULL == p_end)
+        if (!http_req_range_parse_num(p_val, val_len, &offset, &p_range->first))
         {
-            return NULL;
+            return false;
+        }
+        if ((offset >= val_len) || ('-' != p_val[offset]))
+        {
+            return false;
+        }
+        offset += 1;
+        if ((offset < val_len) && (p_val[offset] >= '0') && (p_val[offset] <= '9'))
+        {
+            if (!http_req_range_parse_num(p_val, val_len, &offset, &p_range->last))
+            {
+                return false;
+            }
+            if (p_range->last < p_range->first)
+            {
+                return false;
+            }
+        }
+    }
+    // Several ranges (separated by ',') are not supported, as well as any other trailing characters
+    return http_req_range_skip_spaces(p_val, val_len, offset) == val_len;
+}
+
+bool
+http_req_range_resolve(
+    const http_req_range_t* const p_range,
+    const size_t                  content_len,
+    size_t* const                 p_first,
+    size_t* const                 p_last)
+{
+    if (0 == content_len)
+    {
+        return false;
+    }
+    if (p_range->flag_suffix)
+    {
+        if (0 == p_range->suffix_len)
+        {
+            return false;
+        }
+        *p_first = (p_range->suffix_len < content_len) ? (content_len - p_range->suffix_len) : 0;
+        *p_last  = content_len - 1;
+        return true;
+    }
+    if (p_range->first >= content_len)
+    {
+        return false;
+    }
+    *p_first = p_range->first;
+    *p_last  = (p_range->last < content_len) ? p_range->last : (content_len - 1);
+    return true;
+}
+
+bool
+http_req_if_none_match(const char* const p_val, const uint32_t val_len, const char* const p_etag)
+{
+    const uint32_t etag_len = (uint32_t)strlen(p_etag);
+    uint32_t       offset   = 0;
+    while (offset < val_len)
+    {
+        offset = http_req_range_skip_spaces(p_val, val_len, offset);
+        if ((offset < val_len) && (',' == p_val[offset]))
+        {
+            offset += 1;
+            continue;
+        }
+        const uint32_t start_offset = offset;
+        while ((offset < val_len) && (',' != p_val[offset]) && (' ' != p_val[offset]) && ('\t' != p_val[offset]))
+        {
+            offset += 1;
+        }
+        const char* p_tag   = &p_val[start_offset];
+        uint32_t    tag_len = offset - start_offset;
+        if ((1 == tag_len) && ('*' == p_tag[0]))
+        {
+            return true;
+        }
+        if ((tag_len > 2) && ('W' == p_tag[0]) && ('/' == p_tag[1]))
+        {
+            // Weak comparison: the weak indicator is ignored
+            p_tag += 2;
+            tag_len -= 2;
+        }
+        if ((tag_len == etag_len) && (0 == strncmp(p_tag, p_etag, etag_len)))
+        {
+            return true;
+        }
+    }
+    return false;
+}
+
+static bool
+http_req_parse_http_date_num(const char* const p_str, const uint32_t num_digits, uint32_t* const p_num)
+{
+    uint32_t num = 0;
+    for (uint32_t i = 0; i < num_digits; ++i)
+    {
+        if ((p_str[i] < '0') || (p_str[i] > '9'))
+        {
+            return false;
         }
-        *p_len = (uint32_t)(p_end - p_val);
+        num = (num * HTTP_REQ_DECIMAL_BASE) + (uint32_t)(p_str[i] - '0');
     }
+    *p_num = num;
+    return true;
+}
+
+/**
+ * @brief Calculate the number of days since 1970-01-01 for the date in the proleptic Gregorian calendar.
+ */
+static int32_t
+http_req_days_from_civil(const int32_t year, const uint32_t month, const uint32_t day)
+{
+    const int32_t  y   = (month <= 2) ? (year - 1) : year;
+    const int32_t  era = y / 400;
+    const uint32_t yoe = (uint32_t)(y - (era * 400));
+    const uint32_t doy = ((153U * ((month > 2) ? (month - 3) : (month + 9)) + 2U) / 5U) + day - 1U;
+    const uint32_t doe = (yoe * 365U) + (yoe / 4U) - (yoe / 100U) + doy;
+    return (era * 146097) + (int32_t)doe - 719468;
+}
+
+bool
+http_req_parse_http_date(const char* const p_val, const uint32_t val_len, time_t* const p_time)
+{
+    // "Sun, 06 Nov 1994 08:49:37 GMT"
+    //  0    5  8   12   17 20 23 26
+    if ((NULL == p_val) || (val_len != (sizeof(HTTP_REQ_HTTP_DATE_EXAMPLE) - 1)) || (',' != p_val[3])
+        || (' ' != p_val[4]) || (' ' != p_val[7]) || (' ' != p_val[11]) || (' ' != p_val[16]) || (':' != p_val[19])
+        || (':' != p_val[22]) || (0 != strncmp(&p_val[25], " GMT", 4)))
+    {
+        return false;
+    }
+    uint32_t month = 0;
+    while ((month < HTTP_REQ_NUM_MONTHS) && (0 != strncmp(&p_val[8], g_http_req_months[month], 3)))
+    {
+        month += 1;
+    }
+    uint32_t day    = 0;
+    uint32_t year   = 0;
+    uint32_t hour   = 0;
+    uint32_t minute = 0;
+    uint32_t second = 0;
+    if ((month >= HTTP_REQ_NUM_MONTHS) || (!http_req_parse_http_date_num(&p_val[5], 2, &day))
+        || (!http_req_parse_http_date_num(&p_val[12], 4, &year))
+        || (!http_req_parse_http_date_num(&p_val[17], 2, &hour))
+        || (!http_req_parse_http_date_num(&p_val[20], 2, &minute))
+        || (!http_req_parse_http_date_num(&p_val[23], 2, &second)))
+    {
+        return false;
+    }
+    if ((day < 1) || (day > 31) || (year < 1970) || (hour > 23) || (minute > 59) || (second > 60))
+    {
+        return false;
+    }
+    const int32_t days = http_req_days_from_civil((int32_t)year, month + 1, day);
+    *p_time = ((time_t)days * HTTP_REQ_SECONDS_PER_DAY) + ((time_t)hour * HTTP_REQ_SECONDS_PER_HOUR)
+              + ((time_t)minute * HTTP_REQ_SECONDS_PER_MINUTE) + (time_t)second;
+    return true;
+}
 
-    return p_val;
+static uint32_t
+http_req_accept_encoding_coding_to_mask(const char* const p_coding, const uint32_t coding_len)
+{
+    if (((4 == coding_len) && (0 == strncasecmp(p_coding, "gzip", coding_len)))
+        || ((6 == coding_len) && (0 == strncasecmp(p_coding, "x-gzip", coding_len))))
+    {
+        return HTTP_REQ_ACCEPT_ENCODING_GZIP;
+    }
+    if ((2 == coding_len) && (0 == strncasecmp(p_coding, "br", coding_len)))
+    {
+        return HTTP_REQ_ACCEPT_ENCODING_BR;
+    }
+    if ((8 == coding_len) && (0 == strncasecmp(p_coding, "identity", coding_len)))
+    {
+        return HTTP_REQ_ACCEPT_ENCODING_IDENTITY;
+    }
+    if ((1 == coding_len) && ('*' == p_coding[0]))
+    {
+        return HTTP_REQ_ACCEPT_ENCODING_IDENTITY | HTTP_REQ_ACCEPT_ENCODING_GZIP | HTTP_REQ_ACCEPT_ENCODING_BR;
+    }
+    return 0;
+}
+
+/**
+ * @brief Check if the parameters of the coding contain "q=0" (or "q=0.0", "q=0.00", "q=0.000").
+ */
+static bool
+http_req_accept_encoding_is_q_zero(const char* const p_params, const uint32_t params_len)
+{
+    uint32_t offset = 0;
+    while (offset < params_len)
+    {
+        offset = http_req_range_skip_spaces(p_params, params_len, offset);
+        if ((offset < params_len) && (';' == p_params[offset]))
+        {
+            offset += 1;
+            continue;
+        }
+        const uint32_t start_offset = offset;
+        while ((offset < params_len) && (';' != p_params[offset]))
+        {
+            offset += 1;
+        }
+        uint32_t end_offset = offset;
+        while ((end_offset > start_offset) && ((' ' == p_params[end_offset - 1]) || ('\t' == p_params[end_offset - 1])))
+        {
+            end_offset -= 1;
+        }
+        const char* const p_param   = &p_params[start_offset];
+        const uint32_t    param_len = end_offset - start_offset;
+        if ((param_len >= 3) && (('q' == p_param[0]) || ('Q' == p_param[0])) && ('=' == p_param[1]))
+        {
+            bool flag_zero = ('0' == p_param[2]);
+            if ((param_len > 3) && ('.' == p_param[3]))
+            {
+                for (uint32_t i = 4; i < param_len; ++i)
+                {
+                    flag_zero = flag_zero && ('0' == p_param[i]);
+                }
+            }
+            else if (param_len > 3)
+            {
+                flag_zero = false;
+            }
+            else
+            {
+                // "q=0" or "q=1"
+            }
+            return flag_zero;
+        }
+    }
+    return false;
+}
+
+uint32_t
+http_req_parse_accept_encoding(const char* const p_val, const uint32_t val_len)
+{
+    if (NULL == p_val)
+    {
+        return HTTP_REQ_ACCEPT_ENCODING_IDENTITY;
+    }
+    uint32_t accepted      = 0;
+    uint32_t rejected      = 0;
+    uint32_t listed        = 0;
+    uint32_t wildcard_mask = 0;
+    bool     flag_wildcard = false;
+    uint32_t offset        = 0;
+    while (offset < val_len)
+    {
+        offset = http_req_range_skip_spaces(p_val, val_len, offset);
+        if ((offset < val_len) && (',' == p_val[offset]))
+        {
+            offset += 1;
+            continue;
+        }
+        const uint32_t start_offset = offset;
+        while ((offset < val_len) && (',' != p_val[offset]))
+        {
+            offset += 1;
+        }
+        const char* const p_item     = &p_val[start_offset];
+        const uint32_t    item_len   = offset - start_offset;
+        uint32_t          coding_len = 0;
+        while ((coding_len < item_len) && (';' != p_item[coding_len]) && (' ' != p_item[coding_len])
+               && ('\t' != p_item[coding_len]))
+        {
+            coding_len += 1;
+        }
+        const uint32_t mask      = http_req_accept_encoding_coding_to_mask(p_item, coding_len);
+        const bool     flag_zero = http_req_accept_encoding_is_q_zero(&p_item[coding_len], item_len - coding_len);
+        if ((1 == coding_len) && ('*' == p_item[0]))
+        {
+            flag_wildcard = true;
+            wildcard_mask = flag_zero ? 0 : mask;
+            continue;
+        }
+        listed |= mask;
+        if (flag_zero)
+        {
+            rejected |= mask;
+        }
+        else
+        {
+            accepted |= mask;
+        }
+    }
+    if (flag_wildcard)
+    {
+        // "*" matches only the codings which are not listed explicitly
+        accepted |= wildcard_mask & ~listed;
+        rejected |= (~wildcard_mask) & ~listed;
+    }
+    if (0 == (rejected & HTTP_REQ_ACCEPT_ENCODING_IDENTITY))
+    {
+        // The identity is always acceptable unless it's excluded explicitly
+        accepted |= HTTP_REQ_ACCEPT_ENCODING_IDENTITY;
+    }
+    return accepted & ~rejected;
 }
@@ -9,7 +9,9 @@
 #define WIFI_MANAGER_HTTP_REQ_H
 
 #include <stdbool.h>
+#include <stddef.h>
 #include <stdint.h>
+#include <time.h>
 
 #ifdef __cplusplus
 extern "C" {
@@ -35,9 +37,41 @@ typedef struct http_req_ver_t
     const char* ptr;
 } http_req_ver_t;
 
+#define HTTP_REQ_HEADER_INDEX_SIZE (16U)
+
+#define HTTP_REQ_ACCEPT_ENCODING_IDENTITY (1U << 0U)
+#define HTTP_REQ_ACCEPT_ENCODING_GZIP     (1U << 1U)
+#define HTTP_REQ_ACCEPT_ENCODING_BR       (1U << 2U)
+
+/**
+ * @brief The location of the header field, the offsets are counted from the beginning of the header.
+ */
+typedef struct http_req_header_field_t
+{
+    uint16_t name_hash;   // Hash of the field name in lower case (see http_req_header_calc_name_hash)
+    uint16_t name_offset; // Offset of the field name
+    uint16_t name_len;    // Length of the field name (without ':')
+    uint16_t val_offset;  // Offset of the field value (without leading spaces)
+    uint16_t val_len;     // Length of the field value (without line terminator)
+} http_req_header_field_t;
+
+/**
+ * @brief The index of the header fields which is built by the parser in one pass.
+ * @note If the index was not built or the header contains more than HTTP_REQ_HEADER_INDEX_SIZE fields,
+ *       then http_req_header_get_field scans the header for the fields which are not in the index.
+ */
+typedef struct http_req_header_index_t
+{
+    bool                    is_valid;    // The index was built by the parser
+    bool                    is_overflow; // Not all the fields fit into the index
+    uint8_t                 num_fields;
+    http_req_header_field_t fields[HTTP_REQ_HEADER_INDEX_SIZE];
+} http_req_header_index_t;
+
 typedef struct http_req_header_t
 {
-    const char* ptr;
+    const char*             ptr;
+    http_req_header_index_t index;
 } http_req_header_t;
 
 typedef struct http_req_body_t
@@ -56,12 +90,175 @@ typedef struct http_req_info_t
     http_req_body_t       http_body;
 } http_req_info_t;
 
+/**
+ * @brief Single byte range from the "Range" header field (RFC 7233).
+ */
+typedef struct http_req_range_t
+{
+    bool   flag_suffix; // "bytes=-N": the last suffix_len bytes of the content
+    size_t first;       // Offset of the first byte ("bytes=first-last" or "bytes=first-")
+    size_t last;        // Offset of the last byte (SIZE_MAX if it's not specified)
+    size_t suffix_len;  // Length of the suffix (used if flag_suffix is set)
+} http_req_range_t;
+
+typedef enum http_req_parser_state_e
+{
+    HTTP_REQ_PARSER_STATE_METHOD,     // Method of the request line
+    HTTP_REQ_PARSER_STATE_URI,        // Path of the URI
+    HTTP_REQ_PARSER_STATE_URI_PARAMS, // Query of the URI (after '?')
+    HTTP_REQ_PARSER_STATE_VER,        // Version of the request line
+    HTTP_REQ_PARSER_STATE_HDR_NAME,   // Name of the header field (or the empty line at the end of the header)
+    HTTP_REQ_PARSER_STATE_HDR_VALUE,  // Value of the header field
+    HTTP_REQ_PARSER_STATE_BODY,       // The header was received completely, waiting for the body
+} http_req_parser_state_e;
+
+typedef enum http_req_parser_res_e
+{
+    HTTP_REQ_PARSER_RES_NEED_MORE, // The request is not complete yet
+    HTTP_REQ_PARSER_RES_COMPLETE,  // The request (header + body) is complete
+} http_req_parser_res_e;
+
+/**
+ * @brief The state of the incremental HTTP request parser.
+ * @note The parser consumes every byte of the request buffer only once, it stores the offsets of the parts
+ *       of the request, which are used by http_req_parser_get_info without re-scanning the buffer.
+ */
+typedef struct http_req_parser_t
+{
+    http_req_parser_state_e state;
+    uint32_t                offset;                 // Number of bytes consumed
+    uint32_t                uri_offset;             // Offset of the URI path
+    uint32_t                uri_params_offset;      // Offset of the URI query (0 if there is no query)
+    uint32_t                ver_offset;             // Offset of the HTTP version
+    uint32_t                req_line_end_offset;    // Offset of the line terminator of the request line
+    uint32_t                hdr_offset;             // Offset of the first header field
+    uint32_t                hdr_end_offset;         // Offset of the empty line at the end of the header
+    uint32_t                body_offset;            // Offset of the body
+    uint32_t                line_start_offset;      // Offset of the beginning of the current line
+    uint32_t                content_len;            // Value of "Content-Length"
+    uint32_t                hdr_name_len;           // Length of the current header field name
+    uint32_t                hdr_name_hash;          // Hash of the current header field name
+    uint32_t                hdr_val_offset;         // Offset of the current header field value
+    uint32_t                hdr_val_end_offset;     // Offset of the end of the current header field value or 0
+    bool                    flag_hdr_val_started;   // The first non-space character of the value was received
+    bool                    flag_hdr_content_len;   // The current header field is "Content-Length"
+    bool                    flag_req_line_is_valid; // The request line contains method, URI and version
+    http_req_header_index_t hdr_index;              // Index of the header fields received so far
+} http_req_parser_t;
+
 http_req_info_t
 http_req_parse(char* const p_req_buf);
 
+/**
+ * @brief Initialize the incremental HTTP request parser before receiving the new request.
+ */
+void
+http_req_parser_init(http_req_parser_t* const p_parser);
+
+/**
+ * @brief Parse the bytes appended to the request buffer since the previous call.
+ * @param p_parser - ptr to the parser state
+ * @param p_req_buf - ptr to the request buffer (the same buffer for all calls for the current request)
+ * @param req_size - number of bytes in the request buffer
+ * @return HTTP_REQ_PARSER_RES_COMPLETE if the request buffer contains the complete request
+ *         (its length can be obtained with http_req_parser_get_req_len).
+ */
+http_req_parser_res_e
+http_req_parser_feed(http_req_parser_t* const p_parser, const char* const p_req_buf, const uint32_t req_size);
+
+/**
+ * @brief Get the length of the complete request (header + body) in the request buffer.
+ * @note The request buffer can contain the beginning of the next pipelined request after the current one.
+ */
+uint32_t
+http_req_parser_get_req_len(const http_req_parser_t* const p_parser);
+
+/**
+ * @brief Split the request which was parsed with http_req_parser_feed into parts without re-scanning it.
+ * @note The separators in the request buffer are replaced with '\0', the buffer must be terminated
+ *       with '\0' after the body.
+ */
+http_req_info_t
+http_req_parser_get_info(const http_req_parser_t* const p_parser, char* const p_req_buf);
+
+/**
+ * @brief Calculate the case-insensitive hash of the header field name which is used in the index.
+ */
+uint16_t
+http_req_header_calc_name_hash(const char* const p_name, const uint32_t name_len);
+
+/**
+ * @brief Find the header field by its name.
+ * @note The name is compared exactly (case-insensitive), the value of another header field
+ *       which contains the name is not matched.
+ * @param req_header - the header of the request
+ * @param p_field_name - the name of the field, it can be terminated with ':' (e.g. "Host:")
+ * @param[out] p_len - the length of the value
+ * @return ptr to the value (without quotes) or NULL if the field was not found.
+ */
 const char*
 http_req_header_get_field(const http_req_header_t req_header, const char* const p_field_name, uint32_t* const p_len);
 
+/**
+ * @brief Parse the value of the "Range" header field.
+ * @note Only a single range in bytes is supported, the header field with several ranges or with a syntax error
+ *       must be ignored (the full content is sent in this case).
+ * @param p_val - ptr to the value of the header field (it's not required to be terminated with '\0')
+ * @param val_len - the length of the value
+ * @param[out] p_range - ptr to the output range
+ * @return true if the value contains a single valid byte range.
+ */
+bool
+http_req_parse_range(const char* const p_val, const uint32_t val_len, http_req_range_t* const p_range);
+
+/**
+ * @brief Resolve the byte range for the content of the given length.
+ * @param p_range - ptr to the range parsed by http_req_parse_range
+ * @param content_len - the length of the full content
+ * @param[out] p_first - offset of the first byte of the range
+ * @param[out] p_last - offset of the last byte of the range (it's limited by the length of the content)
+ * @return false if the range is not satisfiable (HTTP error 416 should be sent).
+ */
+bool
+http_req_range_resolve(
+    const http_req_range_t* const p_range,
+    const size_t                  content_len,
+    size_t* const                 p_first,
+    size_t* const                 p_last);
+
+/**
+ * @brief Check if the entity tag matches the value of "If-None-Match" header field.
+ * @note The weak comparison is used as required by RFC 7232, "*" matches any entity tag.
+ * @param p_val - ptr to the value of the header field (it's not required to be terminated with '\0')
+ * @param val_len - the length of the value
+ * @param p_etag - the quoted entity tag of the content (e.g. "\"0123abcd\"")
+ * @return true if the list of entity tags in the header field contains the given one.
+ */
+bool
+http_req_if_none_match(const char* const p_val, const uint32_t val_len, const char* const p_etag);
+
+/**
+ * @brief Parse the value of "Accept-Encoding" header field.
+ * @note The codings with "q=0" are not acceptable, "*" matches the codings which are not listed explicitly.
+ *       If the header field is absent (p_val is NULL), then only the identity is acceptable.
+ * @param p_val - ptr to the value of the header field (it's not required to be terminated with '\0')
+ * @param val_len - the length of the value
+ * @return the bit mask of HTTP_REQ_ACCEPT_ENCODING_* values.
+ */
+uint32_t
+http_req_parse_accept_encoding(const char* const p_val, const uint32_t val_len);
+
+/**
+ * @brief Parse the date in IMF-fixdate format (e.g. "Sun, 06 Nov 1994 08:49:37 GMT").
+ * @note The obsolete formats (RFC 850 and asctime) are not supported.
+ * @param p_val - ptr to the value of the header field (it's not required to be terminated with '\0')
+ * @param val_len - the length of the value
+ * @param[out] p_time - the parsed time (seconds since the Epoch)
+ * @return true on success.
+ */
+bool
+http_req_parse_http_date(const char* const p_val, const uint32_t val_len, time_t* const p_time);
+
 #ifdef __cplusplus
 }
 #endif
@@ -63,6 +63,14 @@ function to process requests, decode URLs, serve files, etc. etc.
 #include "os_timer_sig.h"
 #include "wifiman_msg.h"
 #include "http_server_accept_and_handle_conn.h"
+#include "http_server_mutex.h"
+#include "http_server_workers.h"
+#include "http_server_mux.h"
+#include "http_server_resp_hdr.h"
+#include "http_server_route_internal.h"
+#include "http_server_arena.h"
+#include "http_server_conn_pool.h"
+#include "http_server_cfg.h"
 #include "time_units.h"
 
 #define LOG_LOCAL_LEVEL LOG_LEVEL_INFO
@@ -74,10 +82,12 @@ typedef enum http_server_sig_e
     HTTP_SERVER_SIG_TASK_WATCHDOG_FEED = OS_SIGNAL_NUM_1,
     HTTP_SERVER_SIG_USER_REQ_1         = OS_SIGNAL_NUM_2,
     HTTP_SERVER_SIG_USER_REQ_2         = OS_SIGNAL_NUM_3,
+    HTTP_SERVER_SIG_NEW_CONN           = OS_SIGNAL_NUM_4,
+    HTTP_SERVER_SIG_CONN_EVENT         = OS_SIGNAL_NUM_5,
 } http_server_sig_e;
 
 #define HTTP_SERVER_SIG_FIRST (HTTP_SERVER_SIG_STOP)
-#define HTTP_SERVER_SIG_LAST  (HTTP_SERVER_SIG_USER_REQ_2)
+#define HTTP_SERVER_SIG_LAST  (HTTP_SERVER_SIG_CONN_EVENT)
 
 #define HTTP_SERVER_STATUS_JSON_REQUEST_TIMEOUT_MS (20 * 1000)
 #define HTTP_SERVER_STA_AP_TIMEOUT_MS              (60 * 1000)
@@ -108,6 +118,20 @@ struct netconn* IRAM_ATTR     g_p_conn_listen;
 static os_timer_sig_periodic_t* IRAM_ATTR g_p_http_server_timer_sig_watchdog_feed;
 static os_timer_sig_periodic_static_t     g_http_server_timer_sig_watchdog_feed_mem;
 
+/**
+ * The task watchdog is active only while connections are being handled,
+ * the idle HTTP-server thread is blocked in os_signal_wait and does not wake up.
+ */
+static bool g_http_server_task_wdt_active;
+
+/**
+ * Counters of NETCONN_EVT_RCVPLUS/NETCONN_EVT_RCVMINUS events for the listening netconn.
+ * RCVPLUS is generated from the lwIP thread when a new connection is posted to the accept queue,
+ * RCVMINUS is generated from the HTTP-server thread by netconn_accept, so each counter has only one writer.
+ */
+static volatile uint32_t g_http_server_cnt_conn_queued;
+static volatile uint32_t g_http_server_cnt_conn_accepted;
+
 ATTR_PURE
 static os_signal_num_e
 http_server_conv_to_sig_num(const http_server_sig_e sig)
@@ -132,7 +156,17 @@ http_server_init(void)
     os_signal_add(g_p_http_server_sig, http_server_conv_to_sig_num(HTTP_SERVER_SIG_TASK_WATCHDOG_FEED));
     os_signal_add(g_p_http_server_sig, http_server_conv_to_sig_num(HTTP_SERVER_SIG_USER_REQ_1));
     os_signal_add(g_p_http_server_sig, http_server_conv_to_sig_num(HTTP_SERVER_SIG_USER_REQ_2));
+    os_signal_add(g_p_http_server_sig, http_server_conv_to_sig_num(HTTP_SERVER_SIG_NEW_CONN));
+    os_signal_add(g_p_http_server_sig, http_server_conv_to_sig_num(HTTP_SERVER_SIG_CONN_EVENT));
     g_p_http_server_sema_send = os_sema_create_static(&g_http_server_sema_send_mem);
+    http_server_handler_mutex_init();
+    http_server_resp_hdr_init();
+    http_server_route_init();
+    http_server_conn_pool_init();
+#if HTTP_SERVER_REQ_ARENA_CJSON_HOOKS
+    http_server_arena_install_cjson_hooks();
+#endif
+    http_server_workers_init();
 }
 
 void
@@ -149,6 +183,22 @@ http_server_sema_send_wait_timeout(const uint32_t send_timeout_ms)
         (0 != send_timeout_ms) ? pdMS_TO_TICKS(send_timeout_ms) : OS_DELTA_TICKS_INFINITE);
 }
 
+static bool
+http_server_is_conn_in_accept_queue(void)
+{
+    return (g_http_server_cnt_conn_queued != g_http_server_cnt_conn_accepted) ? true : false;
+}
+
+bool
+http_server_is_new_conn_pending(void)
+{
+    if (http_server_is_conn_in_accept_queue())
+    {
+        return true;
+    }
+    return (0 != http_server_workers_get_queue_depth()) ? true : false;
+}
+
 void
 http_server_start(void)
 {
@@ -253,19 +303,47 @@ http_server_sig_unregister_cur_thread(void)
 static void
 http_server_task_wdt_add_and_start(void)
 {
-    LOG_INFO("TaskWatchdog: Register current thread");
+    if (g_http_server_task_wdt_active)
+    {
+        return;
+    }
+    LOG_DBG("TaskWatchdog: Register current thread");
     const esp_err_t err = esp_task_wdt_add(xTaskGetCurrentTaskHandle());
     if (ESP_OK != err)
     {
         LOG_ERR_ESP(err, "%s failed", "esp_task_wdt_add");
     }
-    LOG_INFO("TaskWatchdog: Start timer");
+    LOG_DBG("TaskWatchdog: Start timer");
     os_timer_sig_periodic_start(g_p_http_server_timer_sig_watchdog_feed);
+    g_http_server_task_wdt_active = true;
+}
+
+static void
+http_server_task_wdt_stop_and_delete(void)
+{
+    if (!g_http_server_task_wdt_active)
+    {
+        return;
+    }
+    LOG_DBG("TaskWatchdog: Stop timer");
+    os_timer_sig_periodic_stop(g_p_http_server_timer_sig_watchdog_feed);
+    LOG_DBG("TaskWatchdog: Unregister current thread");
+    const esp_err_t err = esp_task_wdt_delete(xTaskGetCurrentTaskHandle());
+    if (ESP_OK != err)
+    {
+        LOG_ERR_ESP(err, "%s failed", "esp_task_wdt_delete");
+    }
+    g_http_server_task_wdt_active = false;
 }
 
 static void
 http_server_task_wdt_reset(void)
 {
+    if (!g_http_server_task_wdt_active)
+    {
+        // The signal from the timer could be received after the timer was stopped
+        return;
+    }
     LOG_DBG("Feed watchdog");
     const esp_err_t err = esp_task_wdt_reset();
     if (ESP_OK != err)
@@ -277,10 +355,27 @@ http_server_task_wdt_reset(void)
 static void
 http_server_netconn_callback(const struct netconn* const p_conn, const enum netconn_evt event)
 {
-    if (p_conn != g_p_conn_listen)
+    if (p_conn == g_p_conn_listen)
+    {
+        switch (event)
+        {
+            case NETCONN_EVT_RCVPLUS:
+                g_http_server_cnt_conn_queued += 1;
+                (void)os_signal_send(g_p_http_server_sig, http_server_conv_to_sig_num(HTTP_SERVER_SIG_NEW_CONN));
+                break;
+            case NETCONN_EVT_RCVMINUS:
+                g_http_server_cnt_conn_accepted += 1;
+                break;
+            default:
+                break;
+        }
+    }
+    else
     {
         switch (event)
         {
+            case NETCONN_EVT_RCVPLUS:
+                break;
             case NETCONN_EVT_SENDPLUS:
                 os_sema_signal(g_p_http_server_sema_send);
                 break;
@@ -289,7 +384,12 @@ http_server_netconn_callback(const struct netconn* const p_conn, const enum netc
                 os_sema_signal(g_p_http_server_sema_send);
                 break;
             default:
-                break;
+                return;
+        }
+        if (HTTP_SERVER_MUX_ENABLE)
+        {
+            // Wake up the HTTP server task to advance the state machine of the connection
+            (void)os_signal_send(g_p_http_server_sig, http_server_conv_to_sig_num(HTTP_SERVER_SIG_CONN_EVENT));
         }
     }
 }
@@ -329,6 +429,12 @@ http_server_handle_sig_events(os_signal_events_t* const p_sig_events)
                 LOG_INFO("Got signal USER_REQ_2");
                 wifi_manager_cb_on_user_req(HTTP_SERVER_USER_REQ_CODE_2);
                 break;
+            case HTTP_SERVER_SIG_NEW_CONN:
+                // New connections are handled in http_server_handle_pending_conns
+                break;
+            case HTTP_SERVER_SIG_CONN_EVENT:
+                // Events of the accepted connections are handled in http_server_mux_handle_conns
+                break;
         }
     }
     return flag_stop;
@@ -358,6 +464,112 @@ http_server_netconn_listen(struct netconn* const p_conn)
     return true;
 }
 
+static bool
+http_server_check_sig_events(void)
+{
+    os_signal_events_t sig_events = { 0 };
+    if (os_signal_wait_with_timeout(g_p_http_server_sig, OS_DELTA_TICKS_IMMEDIATE, &sig_events))
+    {
+        return http_server_handle_sig_events(&sig_events);
+    }
+    return false;
+}
+
+/**
+ * @brief Pass the accepted connection to the HTTP workers, wait for free space in the queue if it is full.
+ * @return true if the stop request was received while waiting (the connection is closed in this case).
+ */
+static bool
+http_server_pass_conn_to_workers(struct netconn* const p_new_conn)
+{
+    while (!http_server_workers_push_conn(p_new_conn, pdMS_TO_TICKS(HTTP_SERVER_ACCEPT_MUTEX_WAIT_MS)))
+    {
+        if (http_server_check_sig_events())
+        {
+            netconn_close(p_new_conn);
+            netconn_delete(p_new_conn);
+            return true;
+        }
+    }
+    return false;
+}
+
+/**
+ * @brief Accept all connections pending in the listening netconn and serve them or pass them to the HTTP workers.
+ * @note Signals are checked between connections (and while waiting for the external mutex or for the free space
+ *       in the queue of the HTTP workers), so the task watchdog is fed
+ *       and a stop request is not delayed by a queue of clients.
+ * @return true if the stop request was received.
+ */
+static bool
+http_server_handle_pending_conns(struct netconn* const p_conn)
+{
+    if (!http_server_is_conn_in_accept_queue())
+    {
+        return false;
+    }
+    http_server_task_wdt_add_and_start();
+    bool flag_stop = false;
+    while ((!flag_stop) && http_server_is_conn_in_accept_queue())
+    {
+        struct netconn* const p_new_conn = http_server_accept_conn(p_conn);
+        if (NULL != p_new_conn)
+        {
+            if (0 == HTTP_SERVER_NUM_WORKERS)
+            {
+                http_server_handle_conn(p_new_conn);
+            }
+            else
+            {
+                flag_stop = http_server_pass_conn_to_workers(p_new_conn);
+            }
+        }
+        if (!flag_stop)
+        {
+            flag_stop = http_server_check_sig_events();
+        }
+    }
+    http_server_task_wdt_stop_and_delete();
+    return flag_stop;
+}
+
+/**
+ * @brief Advance the state machines of the connections served in the multiplexed mode
+ *        and accept the pending connections while there are free slots.
+ * @note The task watchdog is active while there are connections to serve,
+ *       so the periodic timer wakes up the task to check the timeouts of the connections.
+ * @return true if the stop request was received.
+ */
+static bool
+http_server_mux_handle_conns(struct netconn* const p_conn)
+{
+    bool flag_stop = false;
+    do
+    {
+        http_server_mux_poll();
+        while ((!flag_stop) && http_server_is_conn_in_accept_queue() && http_server_mux_has_free_slot())
+        {
+            struct netconn* const p_new_conn = http_server_accept_conn(p_conn);
+            if (NULL != p_new_conn)
+            {
+                (void)http_server_mux_add_conn(p_new_conn);
+            }
+            flag_stop = http_server_check_sig_events();
+        }
+        http_server_mux_poll();
+    } while ((!flag_stop) && http_server_is_conn_in_accept_queue() && http_server_mux_has_free_slot());
+
+    if ((0 != http_server_mux_get_num_active_conns()) || http_server_is_conn_in_accept_queue())
+    {
+        http_server_task_wdt_add_and_start();
+    }
+    else
+    {
+        http_server_task_wdt_stop_and_delete();
+    }
+    return flag_stop;
+}
+
 static void
 http_server_task(void)
 {
@@ -386,6 +598,12 @@ http_server_task(void)
     netconn_set_recvtimeout(p_conn, HTTP_SERVER_ACCEPT_TIMEOUT_MS);
     LOG_INFO("HTTP Server listening on 80/tcp");
 
+    if (0 != HTTP_SERVER_NUM_WORKERS)
+    {
+        LOG_INFO("Start %u HTTP workers", (printf_uint_t)HTTP_SERVER_NUM_WORKERS);
+        http_server_workers_start();
+    }
+
     LOG_INFO("TaskWatchdog: Create timer");
     g_p_http_server_timer_sig_watchdog_feed = os_timer_sig_periodic_create_static(
         &g_http_server_timer_sig_watchdog_feed_mem,
@@ -394,29 +612,34 @@ http_server_task(void)
         http_server_conv_to_sig_num(HTTP_SERVER_SIG_TASK_WATCHDOG_FEED),
         pdMS_TO_TICKS(http_server_get_task_wdog_feed_period_ms()));
 
-    http_server_task_wdt_add_and_start();
-
     for (;;)
     {
-        os_signal_events_t sig_events = { 0 };
-        if (os_signal_wait_with_timeout(g_p_http_server_sig, OS_DELTA_TICKS_IMMEDIATE, &sig_events))
+        // NEW_CONN signal could be consumed while the previous connections were handled, so check the counters
+        const bool flag_stop = HTTP_SERVER_MUX_ENABLE ? http_server_mux_handle_conns(p_conn)
+                                                      : http_server_handle_pending_conns(p_conn);
+        if (flag_stop)
         {
-            const bool flag_stop = http_server_handle_sig_events(&sig_events);
-            if (flag_stop)
-            {
-                break;
-            }
+            break;
         }
 
-        http_server_accept_and_handle_conn(p_conn);
-
-        taskYIELD(); /* allows the freeRTOS scheduler to take over if needed. */
+        os_signal_events_t sig_events = { 0 };
+        os_signal_wait(g_p_http_server_sig, &sig_events);
+        if (http_server_handle_sig_events(&sig_events))
+        {
+            break;
+        }
     }
     LOG_INFO("Stop HTTP-Server");
-    LOG_INFO("TaskWatchdog: Unregister current thread");
-    esp_task_wdt_delete(xTaskGetCurrentTaskHandle());
-    LOG_INFO("TaskWatchdog: Stop timer");
-    os_timer_sig_periodic_stop(g_p_http_server_timer_sig_watchdog_feed);
+    if (HTTP_SERVER_MUX_ENABLE)
+    {
+        http_server_mux_close_all();
+    }
+    http_server_task_wdt_stop_and_delete();
+    if (0 != HTTP_SERVER_NUM_WORKERS)
+    {
+        LOG_INFO("Stop HTTP workers");
+        http_server_workers_stop();
+    }
     LOG_INFO("TaskWatchdog: Delete timer");
     os_timer_sig_periodic_delete(&g_p_http_server_timer_sig_watchdog_feed);
     LOG_INFO("Close socket");
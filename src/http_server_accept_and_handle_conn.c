@@ -6,11 +6,11 @@
  */
 
 #include "http_server_accept_and_handle_conn.h"
+#include <unistd.h>
 #include <esp_task_wdt.h>
 #include "lwip/priv/tcp_priv.h"
 #include "os_sema.h"
 #include "os_malloc.h"
-#include "str_buf.h"
 #include "wifiman_config.h"
 #include "sta_ip.h"
 #include "http_req.h"
@@ -18,117 +18,269 @@
 #include "http_server_handle_req.h"
 #include "wifi_manager.h"
 #include "http_server_mutex.h"
+#include "http_server_arena.h"
+#include "http_server_conn_pool.h"
+#include "http_server_cfg.h"
+#include "http_server_resp_hdr.h"
+#include "json_network_info.h"
+#include "http_server.h"
+#include "time_units.h"
 
 #define LOG_LOCAL_LEVEL LOG_LEVEL_INFO
 #include "log.h"
 
-#define FULLBUF_SIZE (4U * 1024U)
+/**
+ * The small chunks from the JSON generator are accumulated into the buffer of this size before sending,
+ * so that each write to lwIP fills a full TCP segment.
+ * When chunked transfer encoding is used, the size line of the chunk is sent in the same segment.
+ */
+#define HTTP_SERVER_JSON_GEN_STAGING_BUF_SIZE (TCP_MSS - HTTP_SERVER_CONN_CHUNK_FRAME_SIZE)
+
+_Static_assert(
+    HTTP_SERVER_CONN_CHUNK_BUF_SIZE >= (HTTP_SERVER_JSON_GEN_STAGING_BUF_SIZE + 1),
+    "The response buffer of the connection context is too small for the output of JSON generator");
+
+_Static_assert(
+    HTTP_SERVER_REQ_BUF_SIZE > TCP_MSS,
+    "The request buffer of the connection context must be able to hold the payload of one received pbuf");
 
 #define HTTP_SERVER_MAX_CONTENT_LEN_TO_PRINT_LOG_FOR_JSON_RESP       (256U)
 #define HTTP_SERVER_MAX_CONTENT_LEN_TO_PRINT_LOG_FROM_JSON_GENERATOR (4U * 1024U)
 
-#define HTTP_SERVER_DELAY_BETWEEN_NETCONN_WRITE_MS (5)
+/**
+ * Max time to wait for NETCONN_EVT_SENDPLUS while the send buffer is full.
+ * The event semaphore is shared by all the connections, so with several workers the event
+ * can be consumed by another worker, this limits the delay in such case.
+ */
+#define HTTP_SERVER_SEND_WAIT_EVENT_MAX_MS (50U)
 
-#define HTTP_HEADER_DATE_EXAMPLE "Date: Thu, 01 Jan 2021 00:00:00 GMT\r\n"
+static const char g_http_server_hdr_server[] = "Server: Ruuvi Gateway\r\n";
 
-typedef struct http_header_date_str_t
-{
-    char buf[sizeof(HTTP_HEADER_DATE_EXAMPLE)];
-} http_header_date_str_t;
+static const char g_http_server_hdr_connection_close[] = "Connection: close\r\n";
 
-static const char TAG[] = "http_server";
+/**
+ * Header fields and the content of the error responses without content,
+ * "Connection" header field and the empty line are inserted before the last two bytes ("{}").
+ */
+static const char g_http_server_canned_empty_json[] = "Content-type: application/json; charset=utf-8\r\n"
+                                                      "Content-Length: 2\r\n"
+                                                      "{}";
 
-static http_header_extra_fields_t g_http_server_extra_header_fields;
+/**
+ * The response which is sent without the connection context when all the contexts are in use.
+ */
+static const char g_http_server_canned_resp_503[] = "HTTP/1.1 503 Service Unavailable\r\n"
+                                                    "Server: Ruuvi Gateway\r\n"
+                                                    "Content-Length: 0\r\n"
+                                                    "Retry-After: 1\r\n"
+                                                    "Connection: close\r\n"
+                                                    "\r\n";
 
-static const char*
-get_http_body(const char* const p_msg, const uint32_t len, uint32_t* const p_body_len)
-{
-    static const char g_newlines[] = "\r\n\r\n";
+static const char TAG[] = "http_server";
 
-    const char* p_body = strstr(p_msg, g_newlines);
-    if (NULL == p_body)
+/**
+ * @brief Copy the request received in the pbuf to the linear buffer of the connection context.
+ * @note The request is copied if it's split between several pbufs or the handler needs the body terminated with '\0'.
+ */
+static void
+http_server_conn_linearize_req(http_server_conn_ctx_t* const p_ctx)
+{
+    if (NULL != p_ctx->p_pbuf)
     {
-        LOG_DBG("http body not found: %s", p_msg);
-        return NULL;
+        memcpy(p_ctx->p_lin_buf, p_ctx->p_req_buf, p_ctx->req_size);
+        p_ctx->p_lin_buf[p_ctx->req_size] = '\0';
+        pbuf_free(p_ctx->p_pbuf);
+        p_ctx->p_pbuf = NULL;
     }
-    p_body += strlen(g_newlines);
-    if (NULL != p_body_len)
+    p_ctx->p_req_buf = p_ctx->p_lin_buf;
+}
+
+/**
+ * @brief Check if the request can be handled directly in the payload of the received pbuf.
+ * @note The pbuf must contain the complete request. Also, if the request has a body, there must be at least one byte
+ *       after it, which is replaced with '\0' while the request is handled.
+ */
+static bool
+http_server_conn_is_req_in_pbuf_complete(http_server_conn_ctx_t* const p_ctx)
+{
+    http_req_parser_t* const p_parser = &p_ctx->req_parser;
+    if (HTTP_REQ_PARSER_RES_COMPLETE != http_req_parser_feed(p_parser, p_ctx->p_req_buf, p_ctx->req_size))
     {
-        *p_body_len = len - (uint32_t)(p_body - p_msg);
+        return false;
     }
-    return p_body;
+    return (0 == p_parser->content_len) || (http_req_parser_get_req_len(p_parser) < p_ctx->req_size);
 }
 
-static bool
-http_server_recv_and_handle(
-    struct netconn* const p_conn,
-    char* const           p_req_buf,
-    const size_t          req_buf_size,
-    uint32_t* const       p_req_size,
-    bool* const           p_req_ready)
-{
-    struct netbuf* p_netbuf_in = NULL;
-
-    const os_delta_ticks_t t0                    = xTaskGetTickCount();
-    const err_t            err                   = netconn_recv(p_conn, &p_netbuf_in);
-    const os_delta_ticks_t time_for_netconn_recv = xTaskGetTickCount() - t0;
+/**
+ * @brief Receive the next portion of data from the connection.
+ * @note The typical short request which is received in a single pbuf is parsed directly in the payload of the pbuf,
+ *       otherwise the data is appended to the linear request buffer.
+ * @return ERR_OK on success, ERR_BUF if the request buffer is full, ERR_MEM if there is not enough memory,
+ *         otherwise the error returned by netconn_recv_tcp_pbuf.
+ */
+static err_t
+http_server_recv_and_append(http_server_conn_ctx_t* const p_ctx)
+{
+    struct pbuf* p_pbuf = NULL;
+
+    const err_t err = netconn_recv_tcp_pbuf(p_ctx->p_netconn, &p_pbuf);
     if (ERR_OK != err)
     {
-        LOG_ERR("netconn recv: %d (time: %lu ticks)", (printf_int_t)err, (printf_ulong_t)time_for_netconn_recv);
-        return false;
+        return err;
     }
+    p_ctx->bytes_received += p_pbuf->tot_len;
 
-    char* p_buf  = NULL;
-    u16_t buflen = 0;
-    netbuf_data(p_netbuf_in, (void**)&p_buf, &buflen);
+    if ((0 == p_ctx->req_size) && (NULL == p_pbuf->next))
+    {
+        p_ctx->p_pbuf    = p_pbuf;
+        p_ctx->p_req_buf = (char*)p_pbuf->payload;
+        p_ctx->req_size  = p_pbuf->len;
+        if (http_server_conn_is_req_in_pbuf_complete(p_ctx))
+        {
+            return ERR_OK;
+        }
+        // The rest of the request will be received in the next pbufs, so copy it to the linear buffer.
+        // The parser state is kept, because the linear buffer starts with the same data.
+        http_server_conn_linearize_req(p_ctx);
+        return ERR_OK;
+    }
 
-    if ((*p_req_size + buflen) >= req_buf_size)
+    http_server_conn_linearize_req(p_ctx);
+    if ((p_ctx->req_size + p_pbuf->tot_len) >= HTTP_SERVER_REQ_BUF_SIZE)
     {
-        LOG_WARN("tmp buffer is full, req_size: %u, buf_len: %u", (printf_uint_t)*p_req_size, (printf_uint_t)buflen);
-        netbuf_delete(p_netbuf_in);
-        return false;
+        LOG_WARN(
+            "tmp buffer is full, req_size: %u, buf_len: %u",
+            (printf_uint_t)p_ctx->req_size,
+            (printf_uint_t)p_pbuf->tot_len);
+        pbuf_free(p_pbuf);
+        return ERR_BUF;
+    }
+    (void)pbuf_copy_partial(p_pbuf, &p_ctx->p_lin_buf[p_ctx->req_size], p_pbuf->tot_len, 0);
+    p_ctx->req_size += p_pbuf->tot_len;
+    p_ctx->p_lin_buf[p_ctx->req_size] = '\0'; // zero terminated string
+    pbuf_free(p_pbuf);
+    return ERR_OK;
+}
+
+/**
+ * @brief Parse the data appended to the request buffer and get the length of the first complete HTTP request.
+ * @note The buffer can contain the beginning of the next (pipelined) request after the first one.
+ * @return the length of the first request (header + body) or 0 if the request is not complete yet.
+ *         If the body is too large for the request buffer, then the length of the header is returned
+ *         and p_ctx->flag_body_stream is set.
+ */
+static uint32_t
+http_server_conn_get_full_req_len(http_server_conn_ctx_t* const p_ctx)
+{
+    const http_req_parser_t* const p_parser = &p_ctx->req_parser;
+    if (HTTP_REQ_PARSER_RES_COMPLETE == http_req_parser_feed(&p_ctx->req_parser, p_ctx->p_req_buf, p_ctx->req_size))
+    {
+        return http_req_parser_get_req_len(p_parser);
+    }
+    if ((HTTP_REQ_PARSER_STATE_BODY == p_parser->state)
+        && (p_parser->content_len >= (HTTP_SERVER_REQ_BUF_SIZE - p_parser->body_offset)))
+    {
+        // The body does not fit into the request buffer, so it will be passed to the handler in chunks,
+        // the request can be handled as soon as the header is received.
+        p_ctx->flag_body_stream = true;
+        return p_parser->body_offset;
     }
-    memcpy(&p_req_buf[*p_req_size], p_buf, buflen);
-    *p_req_size += buflen;
-    p_req_buf[*p_req_size] = '\0'; // zero terminated string
+    LOG_DBG("request not full yet");
+    return 0;
+}
 
-    netbuf_delete(p_netbuf_in);
+static void
+http_server_feed_task_wdt(void)
+{
+    const esp_err_t err_wdt = esp_task_wdt_reset();
+    if (ESP_OK != err_wdt)
+    {
+        LOG_ERR_ESP(err_wdt, "%s failed", "esp_task_wdt_reset");
+    }
+}
 
-    // check if there should be more data coming from conn
-    uint32_t                field_len  = 0;
-    const http_req_header_t req_header = {
-        .ptr = p_req_buf,
-    };
-    const char* p_content_len_str = http_req_header_get_field(req_header, "Content-Length:", &field_len);
-    if (NULL != p_content_len_str)
+/**
+ * @brief Receive the next complete HTTP request from the connection.
+ * @note If a previous request was already served on this connection and no bytes of the next one have been received,
+ *       the connection is idle: wait up to HTTP_SERVER_KEEP_ALIVE_IDLE_TIMEOUT_MS for the next request,
+ *       but give up earlier if another client is waiting in the accept queue.
+ * @param p_ctx - ptr to the connection context, the request buffer can already contain the beginning of the request
+ * @return true if the complete request was received (its length is stored in p_ctx->req_len)
+ */
+static bool
+http_server_recv_req(http_server_conn_ctx_t* const p_ctx)
+{
+    struct netconn* const  p_conn     = p_ctx->p_netconn;
+    const os_delta_ticks_t tick_start = xTaskGetTickCount();
+    for (;;)
     {
-        const uint32_t content_len = (uint32_t)strtoul(p_content_len_str, NULL, 10);
-        uint32_t       body_len    = 0;
-        const char*    p_body      = get_http_body(p_req_buf, *p_req_size, &body_len);
-        if (NULL != p_body)
+        p_ctx->req_len = http_server_conn_get_full_req_len(p_ctx);
+        if (0 != p_ctx->req_len)
+        {
+            netconn_set_recvtimeout(p_conn, HTTP_SERVER_RECV_TIMEOUT_MS);
+            return true;
+        }
+        const bool flag_idle = http_server_conn_is_idle(p_ctx);
+        if (flag_idle)
         {
-            LOG_DBG("Header Content-Length: %d, HTTP body length: %d", content_len, body_len);
-            if (content_len == body_len)
+            if (http_server_is_new_conn_pending())
+            {
+                LOG_DBG("Close idle keep-alive connection: there is a new connection pending");
+                return false;
+            }
+            if ((xTaskGetTickCount() - tick_start) >= pdMS_TO_TICKS(HTTP_SERVER_KEEP_ALIVE_IDLE_TIMEOUT_MS))
             {
-                // HTTP request is full
-                *p_req_ready = true;
+                LOG_DBG("Close idle keep-alive connection: timeout");
+                return false;
             }
-            else
+        }
+        netconn_set_recvtimeout(
+            p_conn,
+            flag_idle ? HTTP_SERVER_KEEP_ALIVE_POLL_INTERVAL_MS : HTTP_SERVER_RECV_TIMEOUT_MS);
+
+        const os_delta_ticks_t t0  = xTaskGetTickCount();
+        const err_t            err = http_server_recv_and_append(p_ctx);
+        if (ERR_OK == err)
+        {
+            continue;
+        }
+        if (flag_idle)
+        {
+            if (ERR_TIMEOUT == err)
             {
-                LOG_DBG("request not full yet");
+                http_server_feed_task_wdt();
+                continue;
             }
+            LOG_DBG("netconn recv: %d, the keep-alive connection was closed by the client side", (printf_int_t)err);
+        }
+        else if (ERR_BUF != err)
+        {
+            LOG_ERR(
+                "netconn recv: %d (time: %lu ticks)",
+                (printf_int_t)err,
+                (printf_ulong_t)(xTaskGetTickCount() - t0));
         }
         else
         {
-            LOG_DBG("Header Content-Length: %d, body not found", content_len);
-            // read more data
+            // Warning was already printed in http_server_recv_and_append
         }
+        return false;
     }
-    else
+}
+
+static void
+http_server_conn_resp_hdr_add_connection(http_server_conn_ctx_t* const p_ctx, http_server_resp_hdr_t* const p_hdr)
+{
+    if (!p_ctx->flag_keep_alive)
     {
-        *p_req_ready = true;
+        http_server_resp_hdr_add_str(p_hdr, g_http_server_hdr_connection_close);
+        return;
     }
-    return true;
+    http_server_resp_hdr_add_str(p_hdr, "Connection: keep-alive\r\nKeep-Alive: timeout=");
+    http_server_resp_hdr_add_uint(p_hdr, HTTP_SERVER_KEEP_ALIVE_IDLE_TIMEOUT_MS / TIME_UNITS_MS_PER_SECOND);
+    http_server_resp_hdr_add_str(p_hdr, ", max=");
+    http_server_resp_hdr_add_uint(p_hdr, HTTP_SERVER_KEEP_ALIVE_MAX_REQUESTS - p_ctx->num_requests);
+    http_server_resp_hdr_add_str(p_hdr, "\r\n");
 }
 
 static const char*
@@ -174,94 +326,50 @@ conv_lwip_err_to_str(const err_enum_t err)
     return "Unknown error";
 }
 
-static bool
-http_server_netconn_write(
-    struct netconn* const p_conn,
-    const void* const     p_buf,
-    const size_t          buf_len,
-    const uint8_t         netconn_flags)
-{
-    /**
-     * It's not enough to just set timeout with netconn_set_sendtimeout because if the WiFi connection is lost,
-     * then netconn_write_partly will ignore p_conn->send_timeout and will wait much longer,
-     * which will trigger task watchdog for http_server.
-     */
-    const TickType_t tick_start         = xTaskGetTickCount();
-    const TickType_t send_timeout_ticks = (0 != p_conn->send_timeout) ? pdMS_TO_TICKS(p_conn->send_timeout) : 0;
-    size_t           offset             = 0;
-    do
-    {
-        size_t bytes_written = 0;
+/**
+ * @brief Start building the header of the response in the buffer of the connection.
+ * @note The status line and "Server" header field are added.
+ */
+static void
+http_server_conn_resp_hdr_begin(
+    http_server_conn_ctx_t* const p_ctx,
+    http_server_resp_hdr_t* const p_hdr,
+    const http_resp_code_e        resp_code,
+    const char* const             p_status_msg)
+{
+    http_server_conn_resp_writer_t* const p_writer = &p_ctx->writer;
 
-        http_server_sema_send_wait_immediate();
-        const err_t err = netconn_write_partly(
-            p_conn,
-            &((const uint8_t*)p_buf)[offset],
-            buf_len - offset,
-            netconn_flags | (uint8_t)NETCONN_DONTBLOCK,
-            &bytes_written);
-        if (ESP_OK != err)
-        {
-            if (ERR_WOULDBLOCK != err)
-            {
-                LOG_ERR_ESP(
-                    err,
-                    "netconn_write_partly failed (%s), offset=%u, size=%u",
-                    conv_lwip_err_to_str(err),
-                    (printf_uint_t)offset,
-                    (printf_uint_t)(buf_len - offset));
-                return false;
-            }
-            vTaskDelay(pdMS_TO_TICKS(10));
-        }
-        LOG_DBG(
-            "netconn_write_partly: offset=%u, bytes_written=%u",
-            (printf_uint_t)offset,
-            (printf_uint_t)bytes_written);
-        offset += bytes_written;
-        if ((0 != send_timeout_ticks) && ((xTaskGetTickCount() - tick_start) > send_timeout_ticks))
-        {
-            LOG_ERR("netconn_write_partly failed: send timeout (%d ms)", (printf_int_t)p_conn->send_timeout);
-            return false;
-        }
-        const esp_err_t err_wdt = esp_task_wdt_reset();
-        if (ESP_OK != err_wdt)
-        {
-            LOG_ERR_ESP(err_wdt, "%s failed", "esp_task_wdt_reset");
-        }
-    } while (offset != buf_len);
-    return true;
+    p_writer->hdr_len    = 0;
+    p_writer->hdr_offset = 0;
+    http_server_resp_hdr_begin(p_hdr, p_writer->hdr_buf, sizeof(p_writer->hdr_buf));
+    http_server_resp_hdr_add_status_line(p_hdr, p_ctx->flag_http_1_1, resp_code, p_status_msg);
+    http_server_resp_hdr_add_mem(p_hdr, g_http_server_hdr_server, sizeof(g_http_server_hdr_server) - 1);
 }
 
-ATTR_PRINTF(3, 4)
+/**
+ * @brief Finish building the header, it will be sent by http_server_conn_resp_send_step.
+ */
 static bool
-http_server_netconn_printf(struct netconn* const p_conn, const bool flag_more, const char* const p_fmt, ...)
+http_server_conn_resp_hdr_end(http_server_conn_ctx_t* const p_ctx, http_server_resp_hdr_t* const p_hdr)
 {
-    va_list args;
-    va_start(args, p_fmt);
-    str_buf_t str_buf = str_buf_vprintf_with_alloc(p_fmt, args);
-    va_end(args);
-    if (NULL == str_buf.buf)
+    if (!http_server_resp_hdr_end(p_hdr))
     {
-        LOG_ERR("Can't allocate memory for buffer");
+        LOG_ERR(
+            "The header of the response does not fit into the buffer (%u bytes)",
+            (printf_uint_t)sizeof(p_ctx->writer.hdr_buf));
         return false;
     }
-    LOG_DBG("Response: %s", str_buf.buf);
-    uint8_t netconn_flags = (uint8_t)NETCONN_COPY;
-    if (flag_more)
-    {
-        netconn_flags |= (uint8_t)NETCONN_MORE;
-    }
-    LOG_DBG("netconn_write: %u bytes", (printf_uint_t)str_buf_get_len(&str_buf));
-
-    const bool res = http_server_netconn_write(p_conn, str_buf.buf, str_buf_get_len(&str_buf), netconn_flags);
-
-    str_buf_free_buf(&str_buf);
-    if (!res)
+    p_ctx->writer.hdr_len = p_hdr->len;
+    if (p_ctx->flag_head_req)
     {
-        LOG_ERR("%s failed", "http_server_netconn_write");
-        return false;
+        // The short content of some error responses is placed after the header, it must not be sent for HEAD
+        const char* const p_hdr_end = strstr(p_ctx->writer.hdr_buf, "\r\n\r\n");
+        if (NULL != p_hdr_end)
+        {
+            p_ctx->writer.hdr_len = (size_t)(p_hdr_end - p_ctx->writer.hdr_buf) + 4;
+        }
     }
+    LOG_DBG("Response: %s", p_ctx->writer.hdr_buf);
     return true;
 }
 
@@ -311,545 +419,1171 @@ http_get_content_encoding_str(const http_server_resp_t* const p_resp)
         case HTTP_CONTENT_ENCODING_GZIP:
             p_content_encoding_str = "Content-Encoding: gzip\r\n";
             break;
+        case HTTP_CONTENT_ENCODING_BR:
+            p_content_encoding_str = "Content-Encoding: br\r\n";
+            break;
     }
     return p_content_encoding_str;
 }
 
-static const char*
-http_get_cache_control_str(const http_server_resp_t* const p_resp)
+static void
+http_server_conn_resp_release_content(http_server_conn_resp_writer_t* const p_writer)
 {
-    const char* p_cache_control_str = "";
-    if (p_resp->flag_no_cache)
+    http_server_resp_t* const p_resp = &p_writer->resp;
+    switch (p_resp->content_location)
     {
-        p_cache_control_str
-            = "Cache-Control: no-store, no-cache, must-revalidate, max-age=0\r\n"
-              "Pragma: no-cache\r\n";
+        case HTTP_CONTENT_LOCATION_NO_CONTENT:
+        case HTTP_CONTENT_LOCATION_FLASH_MEM:
+        case HTTP_CONTENT_LOCATION_STATIC_MEM:
+            break;
+        case HTTP_CONTENT_LOCATION_HEAP:
+            os_free(p_resp->select_location.memory.p_buf);
+            break;
+        case HTTP_CONTENT_LOCATION_FATFS:
+            LOG_DBG("Close file fd=%d", p_resp->select_location.fatfs.fd);
+            close(p_resp->select_location.fatfs.fd);
+            break;
+        case HTTP_CONTENT_LOCATION_JSON_GENERATOR:
+            json_stream_gen_delete(&p_resp->select_location.json_generator.p_json_gen);
+            break;
     }
-    return p_cache_control_str;
+    p_resp->content_location = HTTP_CONTENT_LOCATION_NO_CONTENT;
+    p_writer->p_chunk            = NULL;
+    p_writer->chunk_len          = 0;
+    p_writer->chunk_offset       = 0;
+    p_writer->flag_chunked       = false;
+    p_writer->chunk_frame_len    = 0;
+    p_writer->chunk_frame_offset = 0;
+    p_writer->p_gen_chunk        = NULL;
+    p_writer->gen_chunk_len      = 0;
+    p_writer->gen_chunk_offset   = 0;
+    p_writer->flag_gen_end       = false;
 }
 
 static void
-write_content_from_memory(struct netconn* const p_conn, const http_server_resp_t* const p_resp)
+http_server_conn_resp_abort(http_server_conn_ctx_t* const p_ctx)
 {
-    LOG_DBG("netconn_write: %u bytes", p_resp->content_len);
-    const bool res = http_server_netconn_write(
-        p_conn,
-        p_resp->select_location.memory.p_buf,
-        p_resp->content_len,
-        NETCONN_NOCOPY);
-    if (!res)
-    {
-        LOG_ERR("%s failed", "http_server_netconn_write");
-    }
+    http_server_conn_resp_writer_t* const p_writer = &p_ctx->writer;
+    p_writer->hdr_len    = 0;
+    p_writer->hdr_offset = 0;
+    http_server_conn_resp_release_content(p_writer);
 }
 
+/**
+ * @brief Set the source of the content of the response which header was prepared by http_server_conn_resp_hdr_end.
+ * @note The writer takes ownership of the content (heap buffer, file descriptor or JSON generator).
+ * @param flag_chunked - true if the header contains "Transfer-Encoding: chunked".
+ */
 static void
-write_content_from_heap(struct netconn* const p_conn, http_server_resp_t* const p_resp)
+http_server_conn_resp_set_content(
+    http_server_conn_ctx_t* const   p_ctx,
+    const http_server_resp_t* const p_resp,
+    const bool                      flag_chunked)
 {
-    write_content_from_memory(p_conn, p_resp);
-    os_free(p_resp->select_location.memory.p_buf);
+    http_server_conn_resp_writer_t* const p_writer = &p_ctx->writer;
+
+    p_writer->resp               = *p_resp;
+    p_writer->content_offset     = 0;
+    p_writer->content_start      = 0;
+    p_writer->p_chunk            = NULL;
+    p_writer->chunk_len          = 0;
+    p_writer->chunk_offset       = 0;
+    p_writer->flag_more          = false;
+    p_writer->flag_chunked       = flag_chunked;
+    p_writer->chunk_frame_len    = 0;
+    p_writer->chunk_frame_offset = 0;
+    p_writer->p_gen_chunk        = NULL;
+    p_writer->gen_chunk_len      = 0;
+    p_writer->gen_chunk_offset   = 0;
+    p_writer->flag_gen_end       = false;
+    p_writer->resp_bytes_sent    = p_writer->bytes_sent;
+    p_writer->cnt_segments       = 0;
+    if (0 == p_writer->hdr_len)
+    {
+        // The content can't be sent without the header
+        http_server_conn_resp_release_content(p_writer);
+    }
+    else if (p_ctx->flag_head_req)
+    {
+        // Only the header is sent in response to HEAD
+        http_server_conn_resp_release_content(p_writer);
+    }
+    else
+    {
+        // The content will be sent by http_server_conn_resp_send_step
+    }
 }
 
-static void
-write_content_from_fatfs(struct netconn* const p_conn, const http_server_resp_t* const p_resp)
+static bool
+http_server_conn_resp_read_chunk_from_fatfs(http_server_conn_resp_writer_t* const p_writer)
 {
-    const size_t tmp_buf_size = FULLBUF_SIZE;
-    char*        p_tmp_buf    = os_malloc(tmp_buf_size);
-    if (NULL == p_tmp_buf)
+    const http_server_resp_t* const p_resp       = &p_writer->resp;
+    const size_t                    tmp_buf_size = HTTP_SERVER_CONN_CHUNK_BUF_SIZE;
+    const size_t rem_len   = p_resp->content_len - p_writer->content_offset;
+    const size_t num_bytes = (rem_len <= tmp_buf_size) ? rem_len : tmp_buf_size;
+
+    const file_read_result_t read_result = read(p_resp->select_location.fatfs.fd, p_writer->p_chunk_buf, num_bytes);
+    if (read_result < 0)
     {
-        LOG_ERR("Can't allocate memory for temporary buffer");
-        return;
+        LOG_ERR("Failed to read %u bytes", num_bytes);
+        return false;
     }
-    uint32_t rem_len = p_resp->content_len;
-    while (rem_len > 0)
+    if (read_result != num_bytes)
     {
-        const uint32_t num_bytes       = (rem_len <= tmp_buf_size) ? rem_len : tmp_buf_size;
-        const bool     flag_last_block = (num_bytes == rem_len) ? true : false;
-
-        const file_read_result_t read_result = read(p_resp->select_location.fatfs.fd, p_tmp_buf, num_bytes);
-        if (read_result < 0)
-        {
-            LOG_ERR("Failed to read %u bytes", num_bytes);
-            break;
-        }
-        if (read_result != num_bytes)
-        {
-            LOG_ERR("Read %u bytes, while requested %u bytes", read_result, num_bytes);
-            break;
-        }
-        rem_len -= read_result;
-        uint8_t netconn_flags = (uint8_t)NETCONN_COPY;
-        if (!flag_last_block)
-        {
-            netconn_flags |= (uint8_t)NETCONN_MORE;
-        }
-        LOG_DBG("netconn_write: %u bytes", num_bytes);
-        const bool res = http_server_netconn_write(p_conn, p_tmp_buf, num_bytes, netconn_flags);
-        if (!res)
-        {
-            LOG_ERR("%s failed", "http_server_netconn_write");
-            break;
-        }
+        LOG_ERR("Read %u bytes, while requested %u bytes", read_result, num_bytes);
+        return false;
     }
-    os_free(p_tmp_buf);
-    LOG_DBG("Close file fd=%d", p_resp->select_location.fatfs.fd);
-    close(p_resp->select_location.fatfs.fd);
+    p_writer->content_offset += num_bytes;
+    p_writer->p_chunk   = p_writer->p_chunk_buf;
+    p_writer->chunk_len = num_bytes;
+    p_writer->flag_more = (p_writer->content_offset < p_resp->content_len) ? true : false;
+    return true;
 }
 
-static void
-write_content_from_json_generator(struct netconn* const p_conn, const http_server_resp_t* const p_resp)
+/**
+ * @brief Copy the output of the JSON generator to the staging buffer until it's full or the JSON is finished.
+ * @return false on error.
+ */
+static bool
+http_server_conn_resp_stage_json_generator_output(http_server_conn_resp_writer_t* const p_writer, size_t* const p_len)
 {
-    json_stream_gen_t* p_json_gen = p_resp->select_location.json_generator.p_json_gen;
-
-    size_t bytes_cnt = 0;
-    while (true)
+    const http_server_resp_t* const p_resp = &p_writer->resp;
+    while (*p_len < HTTP_SERVER_JSON_GEN_STAGING_BUF_SIZE)
     {
-        const char* p_chunk = json_stream_gen_get_next_chunk(p_json_gen);
-        if (NULL == p_chunk)
+        if (p_writer->gen_chunk_offset == p_writer->gen_chunk_len)
         {
-            LOG_ERR("json_stream_gen_get_next_chunk return error");
-            break;
-        }
-        const size_t num_bytes = strlen(p_chunk);
-        if (0 == num_bytes)
-        {
-            break;
+            if (p_writer->flag_gen_end)
+            {
+                break;
+            }
+            const char* const p_gen_chunk = json_stream_gen_get_next_chunk(
+                p_resp->select_location.json_generator.p_json_gen);
+            if (NULL == p_gen_chunk)
+            {
+                LOG_ERR("json_stream_gen_get_next_chunk return error");
+                return false;
+            }
+            p_writer->p_gen_chunk      = p_gen_chunk;
+            p_writer->gen_chunk_len    = strlen(p_gen_chunk);
+            p_writer->gen_chunk_offset = 0;
+            if (0 == p_writer->gen_chunk_len)
+            {
+                p_writer->flag_gen_end = true;
+                break;
+            }
         }
-        bytes_cnt += num_bytes;
+        const size_t rem_len  = p_writer->gen_chunk_len - p_writer->gen_chunk_offset;
+        const size_t free_len = HTTP_SERVER_JSON_GEN_STAGING_BUF_SIZE - *p_len;
+        const size_t len      = (rem_len < free_len) ? rem_len : free_len;
+        memcpy(&p_writer->p_chunk_buf[*p_len], &p_writer->p_gen_chunk[p_writer->gen_chunk_offset], len);
+        p_writer->gen_chunk_offset += len;
+        *p_len += len;
+    }
+    return true;
+}
 
-        uint8_t netconn_flags = (uint8_t)NETCONN_COPY;
-        if (bytes_cnt < p_resp->content_len)
-        {
-            netconn_flags |= (uint8_t)NETCONN_MORE;
-        }
-        if (p_resp->content_len < HTTP_SERVER_MAX_CONTENT_LEN_TO_PRINT_LOG_FROM_JSON_GENERATOR)
+static bool
+http_server_conn_resp_read_chunk_from_json_generator(http_server_conn_resp_writer_t* const p_writer)
+{
+    size_t num_bytes = 0;
+    if (!http_server_conn_resp_stage_json_generator_output(p_writer, &num_bytes))
+    {
+        return false;
+    }
+    p_writer->p_chunk_buf[num_bytes] = '\0';
+    p_writer->content_offset += num_bytes;
+    if (0 != num_bytes)
+    {
+        // The total size of the generated JSON is not known in advance,
+        // so only the beginning of a large document is printed at INFO level.
+        if (p_writer->content_offset <= HTTP_SERVER_MAX_CONTENT_LEN_TO_PRINT_LOG_FROM_JSON_GENERATOR)
         {
-            LOG_INFO("json_stream_gen: send %u bytes:\n%s", num_bytes, p_chunk);
+            LOG_INFO("json_stream_gen: send %u bytes:\n%s", (printf_uint_t)num_bytes, p_writer->p_chunk_buf);
         }
         else
         {
-            LOG_DBG("json_stream_gen: send %u bytes:\n%s", num_bytes, p_chunk);
-        }
-        const bool res = http_server_netconn_write(p_conn, p_chunk, num_bytes, netconn_flags);
-        if (!res)
-        {
-            LOG_ERR("%s failed", "http_server_netconn_write");
-            break;
+            LOG_DBG("json_stream_gen: send %u bytes:\n%s", (printf_uint_t)num_bytes, p_writer->p_chunk_buf);
         }
-        vTaskDelay(pdMS_TO_TICKS(HTTP_SERVER_DELAY_BETWEEN_NETCONN_WRITE_MS)); // A delay to avoid triggering watchdog
     }
-    json_stream_gen_delete(&p_json_gen);
+    p_writer->p_chunk   = p_writer->p_chunk_buf;
+    p_writer->chunk_len = num_bytes;
+    p_writer->flag_more = (!p_writer->flag_gen_end) || (p_writer->gen_chunk_offset != p_writer->gen_chunk_len);
+    return true;
 }
 
-static http_header_date_str_t
-http_server_gen_header_date_str(const bool flag_gen_date)
+/**
+ * @brief Get the next chunk of the content.
+ * @return false on error, if there are no more chunks then p_writer->chunk_len is 0.
+ */
+static bool
+http_server_conn_resp_read_next_chunk(http_server_conn_resp_writer_t* const p_writer)
 {
-    http_header_date_str_t date_str = { 0 };
-    if (flag_gen_date)
-    {
-        const time_t cur_time = time(NULL);
-        struct tm    tm_time  = { 0 };
-        gmtime_r(&cur_time, &tm_time);
-        (void)strftime(date_str.buf, sizeof(date_str.buf), "Date: %a, %d %b %Y %H:%M:%S GMT\r\n", &tm_time);
-    }
-    return date_str;
-}
+    const http_server_resp_t* const p_resp = &p_writer->resp;
 
-static void
-http_server_write_content(struct netconn* const p_conn, http_server_resp_t* const p_resp)
-{
+    p_writer->p_chunk      = NULL;
+    p_writer->chunk_len    = 0;
+    p_writer->chunk_offset = 0;
+    p_writer->flag_more    = false;
     switch (p_resp->content_location)
     {
         case HTTP_CONTENT_LOCATION_NO_CONTENT:
-            break;
+            return true;
         case HTTP_CONTENT_LOCATION_FLASH_MEM:
-            ATTR_FALLTHROUGH;
         case HTTP_CONTENT_LOCATION_STATIC_MEM:
-            write_content_from_memory(p_conn, p_resp);
-            break;
         case HTTP_CONTENT_LOCATION_HEAP:
-            write_content_from_heap(p_conn, p_resp);
-            break;
+            if (0 == p_writer->content_offset)
+            {
+                p_writer->p_chunk        = &p_resp->select_location.memory.p_buf[p_writer->content_start];
+                p_writer->chunk_len      = p_resp->content_len;
+                p_writer->content_offset = p_resp->content_len;
+            }
+            return true;
         case HTTP_CONTENT_LOCATION_FATFS:
-            write_content_from_fatfs(p_conn, p_resp);
-            break;
+            if (p_writer->content_offset >= p_resp->content_len)
+            {
+                return true;
+            }
+            return http_server_conn_resp_read_chunk_from_fatfs(p_writer);
         case HTTP_CONTENT_LOCATION_JSON_GENERATOR:
-            write_content_from_json_generator(p_conn, p_resp);
-            break;
+            return http_server_conn_resp_read_chunk_from_json_generator(p_writer);
     }
+    return false;
 }
 
+/**
+ * @brief Prepare the size line which precedes the current chunk when the content is sent
+ *        with "Transfer-Encoding: chunked".
+ * @note The CRLF which terminates the data of the previous chunk is sent together with the size line
+ *       of the next one, the chunk of zero length terminates the body.
+ */
 static void
-http_server_netconn_resp_content_with_len(
-    struct netconn* const                   p_conn,
-    const http_server_resp_t* const         p_resp,
-    const http_header_extra_fields_t* const p_extra_header_fields,
-    const http_resp_code_e                  resp_code,
-    const char* const                       p_status_msg,
-    const bool                              use_extra_content_type_param,
-    const http_header_date_str_t* const     p_date_str)
+http_server_conn_resp_prepare_chunk_frame(http_server_conn_resp_writer_t* const p_writer)
 {
-    if (!http_server_netconn_printf(
-            p_conn,
-            true,
-            "HTTP/1.0 %u %s\r\n"
-            "Server: Ruuvi Gateway\r\n"
-            "%s"
-            "Content-type: %s; charset=utf-8%s%s\r\n"
-            "Content-Length: %lu\r\n"
-            "%s"
-            "%s"
-            "%s"
-            "\r\n",
-            (printf_uint_t)resp_code,
-            p_status_msg,
-            p_date_str->buf,
-            http_get_content_type_str(p_resp->content_type),
-            use_extra_content_type_param ? "; " : "",
-            use_extra_content_type_param ? p_resp->p_content_type_param : "",
-            (printf_ulong_t)p_resp->content_len,
-            (NULL != p_extra_header_fields) ? p_extra_header_fields->buf : "",
-            http_get_content_encoding_str(p_resp),
-            http_get_cache_control_str(p_resp)))
-    {
-        LOG_ERR("%s failed", "http_server_netconn_printf");
-        return;
+    // content_offset already includes the length of the current chunk
+    const bool        flag_first_chunk = (p_writer->content_offset == p_writer->chunk_len) ? true : false;
+    const char* const p_prefix         = flag_first_chunk ? "" : "\r\n";
+
+    int len = 0;
+    if (0 != p_writer->chunk_len)
+    {
+        len = snprintf(
+            p_writer->chunk_frame,
+            sizeof(p_writer->chunk_frame),
+            "%s%x\r\n",
+            p_prefix,
+            (printf_uint_t)p_writer->chunk_len);
+    }
+    else
+    {
+        len = snprintf(p_writer->chunk_frame, sizeof(p_writer->chunk_frame), "%s0\r\n\r\n", p_prefix);
     }
+    p_writer->chunk_frame_len    = (len > 0) ? (size_t)len : 0;
+    p_writer->chunk_frame_offset = 0;
 }
 
+/**
+ * @brief The content was sent completely, print the statistics and release the source of the content.
+ */
 static void
-http_server_netconn_resp_content_without_len(
-    struct netconn* const                   p_conn,
-    const http_server_resp_t* const         p_resp,
-    const http_header_extra_fields_t* const p_extra_header_fields,
-    const http_resp_code_e                  resp_code,
-    const char* const                       p_status_msg,
-    const bool                              use_extra_content_type_param,
-    const http_header_date_str_t* const     p_date_str)
+http_server_conn_resp_finish(http_server_conn_resp_writer_t* const p_writer)
 {
-    if (!http_server_netconn_printf(
-            p_conn,
-            true,
-            "HTTP/1.0 %u %s\r\n"
-            "Server: Ruuvi Gateway\r\n"
-            "%s"
-            "Content-type: %s; charset=utf-8%s%s\r\n"
-            "%s"
-            "%s"
-            "%s"
-            "\r\n",
-            (printf_uint_t)resp_code,
-            p_status_msg,
-            p_date_str->buf,
-            http_get_content_type_str(p_resp->content_type),
-            use_extra_content_type_param ? "; " : "",
-            use_extra_content_type_param ? p_resp->p_content_type_param : "",
-            (NULL != p_extra_header_fields) ? p_extra_header_fields->buf : "",
-            http_get_content_encoding_str(p_resp),
-            http_get_cache_control_str(p_resp)))
-    {
-        LOG_ERR("%s failed", "http_server_netconn_printf");
-        return;
+    if (HTTP_CONTENT_LOCATION_JSON_GENERATOR == p_writer->resp.content_location)
+    {
+        LOG_INFO(
+            "json_stream_gen: %u bytes sent in %u segments",
+            (printf_uint_t)(p_writer->bytes_sent - p_writer->resp_bytes_sent),
+            (printf_uint_t)p_writer->cnt_segments);
     }
+    http_server_conn_resp_release_content(p_writer);
 }
 
-static void
-http_server_netconn_resp_with_content(
-    struct netconn* const                   p_conn,
-    http_server_resp_t* const               p_resp,
-    const http_header_extra_fields_t* const p_extra_header_fields,
-    const http_resp_code_e                  resp_code,
-    const char* const                       p_status_msg)
+static http_server_conn_send_res_e
+http_server_conn_write_partly(
+    http_server_conn_ctx_t* const p_ctx,
+    const uint8_t* const          p_buf,
+    const size_t                  buf_len,
+    size_t* const                 p_offset,
+    const uint8_t                 netconn_flags)
 {
-    if (HTTP_RESP_CODE_200 == resp_code)
+    size_t      bytes_written = 0;
+    const err_t err           = netconn_write_partly(
+        p_ctx->p_netconn,
+        &p_buf[*p_offset],
+        buf_len - *p_offset,
+        netconn_flags | (uint8_t)NETCONN_DONTBLOCK,
+        &bytes_written);
+    LOG_DBG("netconn_write_partly: offset=%u, bytes_written=%u", (printf_uint_t)*p_offset, (printf_uint_t)bytes_written);
+    *p_offset += bytes_written;
+    p_ctx->writer.bytes_sent += bytes_written;
+    if ((ERR_OK != err) && (ERR_WOULDBLOCK != err))
     {
-        LOG_INFO("Response: %s", p_status_msg);
+        LOG_ERR_ESP(
+            err,
+            "netconn_write_partly failed (%s), offset=%u, size=%u",
+            conv_lwip_err_to_str(err),
+            (printf_uint_t)*p_offset,
+            (printf_uint_t)(buf_len - *p_offset));
+        return HTTP_SERVER_CONN_SEND_RES_ERROR;
     }
-    else
+    return (*p_offset < buf_len) ? HTTP_SERVER_CONN_SEND_RES_WOULD_BLOCK : HTTP_SERVER_CONN_SEND_RES_DONE;
+}
+
+http_server_conn_send_res_e
+http_server_conn_resp_send_step(http_server_conn_ctx_t* const p_ctx)
+{
+    http_server_conn_resp_writer_t* const p_writer = &p_ctx->writer;
+    if (0 != p_writer->hdr_len)
     {
-        LOG_WARN(
-            "Response: status %u (%s), extra header fields:\n%s",
-            (printf_uint_t)resp_code,
-            p_status_msg,
-            (NULL != p_extra_header_fields) ? p_extra_header_fields->buf : "");
+        const bool flag_has_content = (HTTP_CONTENT_LOCATION_NO_CONTENT != p_writer->resp.content_location) ? true
+                                                                                                            : false;
+        const http_server_conn_send_res_e res = http_server_conn_write_partly(
+            p_ctx,
+            (const uint8_t*)p_writer->hdr_buf,
+            p_writer->hdr_len,
+            &p_writer->hdr_offset,
+            (uint8_t)NETCONN_COPY | (flag_has_content ? (uint8_t)NETCONN_MORE : 0U));
+        if (HTTP_SERVER_CONN_SEND_RES_DONE != res)
+        {
+            if (HTTP_SERVER_CONN_SEND_RES_ERROR == res)
+            {
+                http_server_conn_resp_abort(p_ctx);
+            }
+            return res;
+        }
+        p_writer->hdr_len    = 0;
+        p_writer->hdr_offset = 0;
     }
-    const bool use_extra_content_type_param = (NULL != p_resp->p_content_type_param)
-                                              && ('\0' != p_resp->p_content_type_param[0]);
-    const http_header_date_str_t date_str = http_server_gen_header_date_str(true);
+    for (;;)
+    {
+        if ((p_writer->chunk_offset == p_writer->chunk_len)
+            && (p_writer->chunk_frame_offset == p_writer->chunk_frame_len))
+        {
+            if (!http_server_conn_resp_read_next_chunk(p_writer))
+            {
+                http_server_conn_resp_abort(p_ctx);
+                return HTTP_SERVER_CONN_SEND_RES_ERROR;
+            }
+            if (p_writer->flag_chunked)
+            {
+                http_server_conn_resp_prepare_chunk_frame(p_writer);
+            }
+            else if (0 == p_writer->chunk_len)
+            {
+                http_server_conn_resp_finish(p_writer);
+                return HTTP_SERVER_CONN_SEND_RES_DONE;
+            }
+        }
+        if (p_writer->chunk_frame_offset != p_writer->chunk_frame_len)
+        {
+            const http_server_conn_send_res_e res = http_server_conn_write_partly(
+                p_ctx,
+                (const uint8_t*)p_writer->chunk_frame,
+                p_writer->chunk_frame_len,
+                &p_writer->chunk_frame_offset,
+                (uint8_t)NETCONN_COPY | ((0 != p_writer->chunk_len) ? (uint8_t)NETCONN_MORE : 0U));
+            if (HTTP_SERVER_CONN_SEND_RES_DONE != res)
+            {
+                if (HTTP_SERVER_CONN_SEND_RES_ERROR == res)
+                {
+                    http_server_conn_resp_abort(p_ctx);
+                }
+                return res;
+            }
+            if (0 == p_writer->chunk_len)
+            {
+                // The last chunk has been sent
+                http_server_conn_resp_finish(p_writer);
+                return HTTP_SERVER_CONN_SEND_RES_DONE;
+            }
+        }
+        // The content in the flash memory is never changed, so it's safe to send it without copying,
+        // the other buffers can be freed or reused before the data is acknowledged by the client.
+        uint8_t netconn_flags = (HTTP_CONTENT_LOCATION_FLASH_MEM == p_writer->resp.content_location)
+                                    ? (uint8_t)NETCONN_NOCOPY
+                                    : (uint8_t)NETCONN_COPY;
+        if (p_writer->flag_more)
+        {
+            netconn_flags |= (uint8_t)NETCONN_MORE;
+        }
+        const size_t                      prev_chunk_offset = p_writer->chunk_offset;
+        const http_server_conn_send_res_e res               = http_server_conn_write_partly(
+            p_ctx,
+            p_writer->p_chunk,
+            p_writer->chunk_len,
+            &p_writer->chunk_offset,
+            netconn_flags);
+        if (prev_chunk_offset != p_writer->chunk_offset)
+        {
+            p_writer->cnt_segments += 1;
+        }
+        if (HTTP_SERVER_CONN_SEND_RES_DONE != res)
+        {
+            if (HTTP_SERVER_CONN_SEND_RES_ERROR == res)
+            {
+                http_server_conn_resp_abort(p_ctx);
+            }
+            return res;
+        }
+    }
+}
+
+/**
+ * @brief Send the prepared response, wait while the send buffer is full.
+ * @note It's not enough to just set timeout with netconn_set_sendtimeout because if the WiFi connection is lost,
+ *       then netconn_write_partly will ignore p_conn->send_timeout and will wait much longer,
+ *       which will trigger task watchdog for http_server.
+ *       So, the response is sent without blocking, the task waits for NETCONN_EVT_SENDPLUS
+ *       when the send buffer is full and the timeout is checked here.
+ */
+static bool
+http_server_conn_resp_send(http_server_conn_ctx_t* const p_ctx)
+{
+    struct netconn* const p_conn             = p_ctx->p_netconn;
+    const TickType_t      send_timeout_ticks = (0 != p_conn->send_timeout) ? pdMS_TO_TICKS(p_conn->send_timeout) : 0;
+    TickType_t            tick_last_progress = xTaskGetTickCount();
+    for (;;)
+    {
+        const size_t bytes_sent = p_ctx->writer.bytes_sent;
+        // The events which were signalled before this write are not relevant anymore
+        http_server_sema_send_wait_immediate();
+        const http_server_conn_send_res_e res = http_server_conn_resp_send_step(p_ctx);
+        if (HTTP_SERVER_CONN_SEND_RES_DONE == res)
+        {
+            return true;
+        }
+        if (HTTP_SERVER_CONN_SEND_RES_ERROR == res)
+        {
+            return false;
+        }
+        if (bytes_sent != p_ctx->writer.bytes_sent)
+        {
+            tick_last_progress = xTaskGetTickCount();
+        }
+        if ((0 != send_timeout_ticks) && ((xTaskGetTickCount() - tick_last_progress) > send_timeout_ticks))
+        {
+            LOG_ERR("netconn_write_partly failed: send timeout (%d ms)", (printf_int_t)p_conn->send_timeout);
+            http_server_conn_resp_abort(p_ctx);
+            return false;
+        }
+        http_server_feed_task_wdt();
+        // The send buffer is full, wait until lwIP frees some space (NETCONN_EVT_SENDPLUS)
+        // or reports an error (NETCONN_EVT_ERROR).
+        (void)http_server_sema_send_wait_timeout(HTTP_SERVER_SEND_WAIT_EVENT_MAX_MS);
+    }
+}
+
+/**
+ * @brief Check if the part of the content can be sent in response to the request with "Range" header field.
+ * @note The range can be applied only to the content of known length which is read from the file or memory.
+ */
+static bool
+http_server_is_range_supported(const http_server_resp_t* const p_resp)
+{
+    if (SIZE_MAX == p_resp->content_len)
+    {
+        return false;
+    }
+    switch (p_resp->content_location)
+    {
+        case HTTP_CONTENT_LOCATION_FLASH_MEM:
+        case HTTP_CONTENT_LOCATION_STATIC_MEM:
+        case HTTP_CONTENT_LOCATION_HEAP:
+        case HTTP_CONTENT_LOCATION_FATFS:
+            return true;
+        case HTTP_CONTENT_LOCATION_NO_CONTENT:
+        case HTTP_CONTENT_LOCATION_JSON_GENERATOR:
+            break;
+    }
+    return false;
+}
+
+/**
+ * @brief Prepare the header of the response with the content.
+ * @param flag_chunked - true if the content is sent with "Transfer-Encoding: chunked",
+ *                      if the content length is unknown and chunked encoding is not used,
+ *                      then the end of the content is signalled by closing the connection.
+ */
+static bool
+http_server_netconn_resp_content_hdr(
+    http_server_conn_ctx_t* const           p_ctx,
+    const http_server_resp_t* const         p_resp,
+    const http_header_extra_fields_t* const p_extra_header_fields,
+    const http_resp_code_e                  resp_code,
+    const char* const                       p_status_msg,
+    const bool                              flag_chunked)
+{
+    http_server_resp_hdr_t hdr = { 0 };
+    http_server_conn_resp_hdr_begin(p_ctx, &hdr, resp_code, p_status_msg);
+    http_server_resp_hdr_add_date(&hdr);
+    http_server_conn_resp_hdr_add_connection(p_ctx, &hdr);
+    http_server_resp_hdr_add_str(&hdr, "Content-type: ");
+    http_server_resp_hdr_add_str(&hdr, http_get_content_type_str(p_resp->content_type));
+    http_server_resp_hdr_add_str(&hdr, "; charset=utf-8");
+    if ((NULL != p_resp->p_content_type_param) && ('\0' != p_resp->p_content_type_param[0]))
+    {
+        http_server_resp_hdr_add_str(&hdr, "; ");
+        http_server_resp_hdr_add_str(&hdr, p_resp->p_content_type_param);
+    }
+    http_server_resp_hdr_add_str(&hdr, "\r\n");
     if (SIZE_MAX != p_resp->content_len)
     {
-        http_server_netconn_resp_content_with_len(
-            p_conn,
-            p_resp,
-            p_extra_header_fields,
-            resp_code,
-            p_status_msg,
-            use_extra_content_type_param,
-            &date_str);
+        http_server_resp_hdr_add_str(&hdr, "Content-Length: ");
+        http_server_resp_hdr_add_uint(&hdr, p_resp->content_len);
+        http_server_resp_hdr_add_str(&hdr, "\r\n");
+        if (((HTTP_RESP_CODE_200 == resp_code) || (HTTP_RESP_CODE_206 == resp_code))
+            && http_server_is_range_supported(p_resp))
+        {
+            http_server_resp_hdr_add_str(&hdr, "Accept-Ranges: bytes\r\n");
+        }
+    }
+    if (p_resp->flag_vary_encoding)
+    {
+        http_server_resp_hdr_add_str(&hdr, "Vary: Accept-Encoding\r\n");
+    }
+    else if (flag_chunked)
+    {
+        http_server_resp_hdr_add_str(&hdr, "Transfer-Encoding: chunked\r\n");
     }
     else
     {
-        http_server_netconn_resp_content_without_len(
-            p_conn,
-            p_resp,
-            p_extra_header_fields,
-            resp_code,
-            p_status_msg,
-            use_extra_content_type_param,
-            &date_str);
+        // Neither Content-Length nor Transfer-Encoding
     }
+    if (NULL != p_extra_header_fields)
+    {
+        http_server_resp_hdr_add_str(&hdr, p_extra_header_fields->buf);
+    }
+    http_server_resp_hdr_add_str(&hdr, http_get_content_encoding_str(p_resp));
+    http_server_resp_hdr_add_validators(&hdr, p_resp);
+    http_server_resp_hdr_add_cache_control(&hdr, p_resp);
+    http_server_resp_hdr_add_str(&hdr, "\r\n");
+    return http_server_conn_resp_hdr_end(p_ctx, &hdr);
+}
 
-    http_server_write_content(p_conn, p_resp);
+static void
+http_server_netconn_resp_with_content(
+    http_server_conn_ctx_t* const           p_ctx,
+    http_server_resp_t* const               p_resp,
+    const http_header_extra_fields_t* const p_extra_header_fields,
+    const http_resp_code_e                  resp_code,
+    const char* const                       p_status_msg)
+{
+    if ((HTTP_RESP_CODE_200 == resp_code) || (HTTP_RESP_CODE_206 == resp_code))
+    {
+        LOG_INFO("Response: %s", p_status_msg);
+    }
+    else
+    {
+        LOG_WARN(
+            "Response: status %u (%s), extra header fields:\n%s",
+            (printf_uint_t)resp_code,
+            p_status_msg,
+            (NULL != p_extra_header_fields) ? p_extra_header_fields->buf : "");
+    }
+    bool flag_chunked = false;
+    if (SIZE_MAX == p_resp->content_len)
+    {
+        if (p_ctx->flag_http_1_1)
+        {
+            // The content length is unknown (e.g. JSON is generated on the fly),
+            // so the body is sent in chunks and the connection can be kept alive.
+            flag_chunked = true;
+        }
+        else
+        {
+            // HTTP/1.0 does not support chunked encoding,
+            // so the end of the body can be signalled only by closing the connection
+            p_ctx->flag_keep_alive = false;
+        }
+    }
+    (void)http_server_netconn_resp_content_hdr(
+        p_ctx,
+        p_resp,
+        p_extra_header_fields,
+        resp_code,
+        p_status_msg,
+        flag_chunked);
+
+    http_server_conn_resp_set_content(p_ctx, p_resp, flag_chunked);
 }
 
 static void
 http_server_netconn_resp_without_content(
-    struct netconn* const  p_conn,
-    const http_resp_code_e resp_code,
-    const char* const      p_status_msg)
+    http_server_conn_ctx_t* const p_ctx,
+    const http_resp_code_e        resp_code,
+    const char* const             p_status_msg)
 {
     LOG_WARN("Response: status %u (%s)", (printf_uint_t)resp_code, p_status_msg);
-    const char* const p_empty_json = "{}";
-    if (!http_server_netconn_printf(
-            p_conn,
-            false,
-            "HTTP/1.0 %u %s\r\n"
-            "Server: Ruuvi Gateway\r\n"
-            "Content-type: %s; charset=utf-8\r\n"
-            "Content-Length: %lu\r\n"
-            "\r\n"
-            "%s",
-            (printf_uint_t)resp_code,
-            p_status_msg,
-            http_get_content_type_str(HTTP_CONTENT_TYPE_APPLICATION_JSON),
-            (printf_ulong_t)strlen(p_empty_json),
-            p_empty_json))
+    const size_t           canned_len = sizeof(g_http_server_canned_empty_json) - 1;
+    http_server_resp_hdr_t hdr        = { 0 };
+    http_server_conn_resp_hdr_begin(p_ctx, &hdr, resp_code, p_status_msg);
+    http_server_resp_hdr_add_mem(&hdr, g_http_server_canned_empty_json, canned_len - 2);
+    http_server_conn_resp_hdr_add_connection(p_ctx, &hdr);
+    http_server_resp_hdr_add_str(&hdr, "\r\n");
+    http_server_resp_hdr_add_mem(&hdr, &g_http_server_canned_empty_json[canned_len - 2], 2);
+    (void)http_server_conn_resp_hdr_end(p_ctx, &hdr);
+}
+
+/**
+ * @brief Release the content of the response which is sent without it.
+ * @note The writer takes ownership of the content to release it in the same way as after sending.
+ */
+static void
+http_server_conn_resp_drop_content(http_server_conn_ctx_t* const p_ctx, const http_server_resp_t* const p_resp)
+{
+    http_server_conn_resp_set_content(p_ctx, p_resp, false);
+    http_server_conn_resp_release_content(&p_ctx->writer);
+}
+
+/**
+ * @brief Prepare the response with HTTP error 416 for the range which is beyond the end of the content.
+ */
+static void
+http_server_netconn_resp_416(http_server_conn_ctx_t* const p_ctx, const http_server_resp_t* const p_resp)
+{
+    LOG_WARN(
+        "Response: status 416 (Range Not Satisfiable), content length: %lu",
+        (printf_ulong_t)p_resp->content_len);
+    http_server_resp_hdr_t hdr = { 0 };
+    http_server_conn_resp_hdr_begin(p_ctx, &hdr, HTTP_RESP_CODE_416, "Range Not Satisfiable");
+    http_server_resp_hdr_add_date(&hdr);
+    http_server_resp_hdr_add_str(&hdr, "Content-Range: bytes */");
+    http_server_resp_hdr_add_uint(&hdr, p_resp->content_len);
+    http_server_resp_hdr_add_str(&hdr, "\r\nContent-Length: 0\r\n");
+    http_server_conn_resp_hdr_add_connection(p_ctx, &hdr);
+    http_server_resp_hdr_add_str(&hdr, "\r\n");
+    (void)http_server_conn_resp_hdr_end(p_ctx, &hdr);
+    http_server_conn_resp_drop_content(p_ctx, p_resp);
+}
+
+/**
+ * @brief Check if the content was not modified since it was cached by the client (RFC 7232).
+ * @note "If-Modified-Since" is ignored if the request contains "If-None-Match".
+ */
+static bool
+http_server_conn_is_not_modified(const http_server_conn_ctx_t* const p_ctx, const http_server_resp_t* const p_resp)
+{
+    if (NULL != p_ctx->p_if_none_match)
+    {
+        if (0 == p_resp->etag)
+        {
+            return false;
+        }
+        const http_server_resp_hdr_etag_str_t etag_str = http_server_resp_hdr_etag_to_str(p_resp->etag);
+        return http_req_if_none_match(p_ctx->p_if_none_match, p_ctx->if_none_match_len, etag_str.buf);
+    }
+    if ((0 == p_resp->last_modified) || (0 == p_ctx->if_modified_since))
     {
-        LOG_ERR("%s failed", "http_server_netconn_printf");
+        return false;
     }
+    return (p_resp->last_modified <= p_ctx->if_modified_since) ? true : false;
+}
+
+/**
+ * @brief Prepare the response with HTTP status 304 without the content.
+ */
+static void
+http_server_netconn_resp_304(http_server_conn_ctx_t* const p_ctx, const http_server_resp_t* const p_resp)
+{
+    LOG_INFO("Response: status 304 (Not Modified)");
+    http_server_resp_hdr_t hdr = { 0 };
+    http_server_conn_resp_hdr_begin(p_ctx, &hdr, HTTP_RESP_CODE_304, "Not Modified");
+    http_server_resp_hdr_add_date(&hdr);
+    http_server_conn_resp_hdr_add_connection(p_ctx, &hdr);
+    http_server_resp_hdr_add_validators(&hdr, p_resp);
+    http_server_resp_hdr_add_cache_control(&hdr, p_resp);
+    if (p_resp->flag_vary_encoding)
+    {
+        http_server_resp_hdr_add_str(&hdr, "Vary: Accept-Encoding\r\n");
+    }
+    http_server_resp_hdr_add_str(&hdr, "\r\n");
+    (void)http_server_conn_resp_hdr_end(p_ctx, &hdr);
+    http_server_conn_resp_drop_content(p_ctx, p_resp);
+}
+
+/**
+ * @brief Prepare the response with the part of the content requested by "Range" header field.
+ * @note The file is positioned with lseek, the content in memory is sent from the offset of the first byte.
+ * @return false if the range can't be applied, so the full content should be sent with HTTP status 200.
+ */
+static bool
+http_server_netconn_resp_206(
+    http_server_conn_ctx_t* const     p_ctx,
+    http_server_resp_t* const         p_resp,
+    http_header_extra_fields_t* const p_extra_header_fields)
+{
+    if ((!p_ctx->flag_range_req) || (!http_server_is_range_supported(p_resp)))
+    {
+        return false;
+    }
+    size_t first = 0;
+    size_t last  = 0;
+    if (!http_req_range_resolve(&p_ctx->req_range, p_resp->content_len, &first, &last))
+    {
+        http_server_netconn_resp_416(p_ctx, p_resp);
+        return true;
+    }
+    if (HTTP_CONTENT_LOCATION_FATFS == p_resp->content_location)
+    {
+        if (lseek(p_resp->select_location.fatfs.fd, (off_t)first, SEEK_SET) != (off_t)first)
+        {
+            LOG_ERR("Failed to seek to position %lu, send the full content", (printf_ulong_t)first);
+            return false;
+        }
+    }
+    const size_t full_len = p_resp->content_len;
+    p_resp->content_len   = (last - first) + 1;
+
+    const size_t offset = strlen(p_extra_header_fields->buf);
+    (void)snprintf(
+        &p_extra_header_fields->buf[offset],
+        sizeof(p_extra_header_fields->buf) - offset,
+        "Content-Range: bytes %lu-%lu/%lu\r\n",
+        (printf_ulong_t)first,
+        (printf_ulong_t)last,
+        (printf_ulong_t)full_len);
+
+    http_server_netconn_resp_with_content(
+        p_ctx,
+        p_resp,
+        p_extra_header_fields,
+        HTTP_RESP_CODE_206,
+        "Partial Content");
+    if (HTTP_CONTENT_LOCATION_FATFS != p_resp->content_location)
+    {
+        p_ctx->writer.content_start = first;
+    }
+    return true;
 }
 
 static void
 http_server_netconn_resp_200(
-    struct netconn* const                   p_conn,
-    http_server_resp_t* const               p_resp,
-    const http_header_extra_fields_t* const p_extra_header_fields)
+    http_server_conn_ctx_t* const     p_ctx,
+    http_server_resp_t* const         p_resp,
+    http_header_extra_fields_t* const p_extra_header_fields)
 {
-    http_server_netconn_resp_with_content(p_conn, p_resp, p_extra_header_fields, HTTP_RESP_CODE_200, "OK");
+    if (HTTP_RESP_CODE_200 == p_resp->http_resp_code)
+    {
+        // The validators and the length depend on the selected variant, so select it before checking them
+        http_server_resp_select_variant(p_resp, p_ctx->accept_encoding);
+        if (http_server_conn_is_not_modified(p_ctx, p_resp))
+        {
+            http_server_netconn_resp_304(p_ctx, p_resp);
+            return;
+        }
+        if (http_server_netconn_resp_206(p_ctx, p_resp, p_extra_header_fields))
+        {
+            return;
+        }
+    }
+    http_server_netconn_resp_with_content(p_ctx, p_resp, p_extra_header_fields, HTTP_RESP_CODE_200, "OK");
 }
 
 static void
-http_server_netconn_resp_302(struct netconn* const p_conn)
+http_server_netconn_resp_302(http_server_conn_ctx_t* const p_ctx)
 {
     const wifiman_ip4_addr_str_t ap_ip_str = wifiman_config_ap_get_ip_str();
     LOG_INFO("Response: status 302 (Found), URL=http://%s/", ap_ip_str.buf);
-    if (!http_server_netconn_printf(
-            p_conn,
-            false,
-            "HTTP/1.0 302 Found\r\n"
-            "Server: Ruuvi Gateway\r\n"
-            "Location: http://%s/\r\n"
-            "\r\n",
-            ap_ip_str.buf))
-    {
-        LOG_ERR("%s failed", "http_server_netconn_printf");
-        return;
+    http_server_resp_hdr_t hdr = { 0 };
+    http_server_conn_resp_hdr_begin(p_ctx, &hdr, HTTP_RESP_CODE_302, "Found");
+    http_server_resp_hdr_add_str(&hdr, "Location: http://");
+    http_server_resp_hdr_add_str(&hdr, ap_ip_str.buf);
+    http_server_resp_hdr_add_str(&hdr, "/\r\nContent-Length: 0\r\n");
+    http_server_conn_resp_hdr_add_connection(p_ctx, &hdr);
+    http_server_resp_hdr_add_str(&hdr, "\r\n");
+    (void)http_server_conn_resp_hdr_end(p_ctx, &hdr);
+}
+
+/**
+ * @brief Prepare the redirect to the authentication page.
+ */
+static void
+http_server_netconn_resp_redirect_auth_html(
+    http_server_conn_ctx_t* const           p_ctx,
+    const http_resp_code_e                  resp_code,
+    const char* const                       p_status_msg,
+    const char* const                       p_host,
+    const size_t                            host_len,
+    const http_header_extra_fields_t* const p_extra_header_fields)
+{
+    LOG_INFO(
+        "Response: status %u (%s), URL=http://%.*s/#auth",
+        (printf_uint_t)resp_code,
+        p_status_msg,
+        (printf_int_t)host_len,
+        p_host);
+    http_server_resp_hdr_t hdr = { 0 };
+    http_server_conn_resp_hdr_begin(p_ctx, &hdr, resp_code, p_status_msg);
+    http_server_resp_hdr_add_str(&hdr, "Location: http://");
+    http_server_resp_hdr_add_mem(&hdr, p_host, host_len);
+    http_server_resp_hdr_add_str(&hdr, "/#auth\r\nContent-Length: 0\r\n");
+    http_server_conn_resp_hdr_add_connection(p_ctx, &hdr);
+    if (NULL != p_extra_header_fields)
+    {
+        http_server_resp_hdr_add_str(&hdr, p_extra_header_fields->buf);
     }
+    http_server_resp_hdr_add_str(&hdr, "\r\n");
+    (void)http_server_conn_resp_hdr_end(p_ctx, &hdr);
 }
 
 static void
 http_server_netconn_resp_301_auth_html(
-    struct netconn* const                   p_conn,
-    const char* const                       p_hostname,
+    http_server_conn_ctx_t* const           p_ctx,
+    const char* const                       p_host,
+    const size_t                            host_len,
     const http_header_extra_fields_t* const p_extra_header_fields)
 {
-    LOG_INFO("Response: status 301 (Moved Permanently), URL=http://%s/#auth", p_hostname);
-    if (!http_server_netconn_printf(
-            p_conn,
-            false,
-            "HTTP/1.0 301 Moved Permanently\r\n"
-            "Server: Ruuvi Gateway\r\n"
-            "Location: http://%s/#auth\r\n"
-            "%s"
-            "\r\n",
-            p_hostname,
-            (NULL != p_extra_header_fields) ? p_extra_header_fields->buf : ""))
-    {
-        LOG_ERR("%s failed", "http_server_netconn_printf");
-        return;
-    }
+    http_server_netconn_resp_redirect_auth_html(
+        p_ctx,
+        HTTP_RESP_CODE_301,
+        "Moved Permanently",
+        p_host,
+        host_len,
+        p_extra_header_fields);
 }
 
 static void
 http_server_netconn_resp_302_auth_html(
-    struct netconn* const                   p_conn,
-    const char* const                       p_hostname,
+    http_server_conn_ctx_t* const           p_ctx,
+    const char* const                       p_host,
+    const size_t                            host_len,
     const http_header_extra_fields_t* const p_extra_header_fields)
 {
-    LOG_INFO("Response: status 302 (Found), URL=http://%s/#auth", p_hostname);
-    if (!http_server_netconn_printf(
-            p_conn,
-            false,
-            "HTTP/1.0 302 Found\r\n"
-            "Server: Ruuvi Gateway\r\n"
-            "Location: http://%s/#auth\r\n"
-            "%s"
-            "\r\n",
-            p_hostname,
-            (NULL != p_extra_header_fields) ? p_extra_header_fields->buf : ""))
-    {
-        LOG_ERR("%s failed", "http_server_netconn_printf");
-        return;
-    }
+    http_server_netconn_resp_redirect_auth_html(
+        p_ctx,
+        HTTP_RESP_CODE_302,
+        "Found",
+        p_host,
+        host_len,
+        p_extra_header_fields);
 }
 
 static void
 http_server_netconn_resp_with_code(
-    struct netconn* const     p_conn,
-    http_server_resp_t* const p_resp,
-    const http_resp_code_e    resp_code,
-    const char* const         p_status_msg)
+    http_server_conn_ctx_t* const p_ctx,
+    http_server_resp_t* const     p_resp,
+    const http_resp_code_e        resp_code,
+    const char* const             p_status_msg)
 {
     if ((NULL == p_resp) || (0 == p_resp->content_len))
     {
-        http_server_netconn_resp_without_content(p_conn, resp_code, p_status_msg);
+        http_server_netconn_resp_without_content(p_ctx, resp_code, p_status_msg);
     }
     else
     {
-        http_server_netconn_resp_with_content(p_conn, p_resp, NULL, resp_code, p_status_msg);
+        http_server_netconn_resp_with_content(p_ctx, p_resp, NULL, resp_code, p_status_msg);
     }
 }
 
 static void
-http_server_netconn_resp_400(struct netconn* const p_conn, http_server_resp_t* const p_resp)
+http_server_netconn_resp_400(http_server_conn_ctx_t* const p_ctx, http_server_resp_t* const p_resp)
 {
-    http_server_netconn_resp_with_code(p_conn, p_resp, HTTP_RESP_CODE_400, "Bad Request");
+    http_server_netconn_resp_with_code(p_ctx, p_resp, HTTP_RESP_CODE_400, "Bad Request");
 }
 
 static void
 http_server_netconn_resp_401(
-    struct netconn* const                   p_conn,
+    http_server_conn_ctx_t* const           p_ctx,
     http_server_resp_t* const               p_resp,
     const http_header_extra_fields_t* const p_extra_header_fields)
 {
-    http_server_netconn_resp_with_content(p_conn, p_resp, p_extra_header_fields, HTTP_RESP_CODE_401, "Unauthorized");
+    http_server_netconn_resp_with_content(p_ctx, p_resp, p_extra_header_fields, HTTP_RESP_CODE_401, "Unauthorized");
 }
 
 static void
 http_server_netconn_resp_403(
-    struct netconn* const                   p_conn,
+    http_server_conn_ctx_t* const           p_ctx,
     http_server_resp_t* const               p_resp,
     const http_header_extra_fields_t* const p_extra_header_fields)
 {
-    http_server_netconn_resp_with_content(p_conn, p_resp, p_extra_header_fields, HTTP_RESP_CODE_403, "Forbidden");
+    http_server_netconn_resp_with_content(p_ctx, p_resp, p_extra_header_fields, HTTP_RESP_CODE_403, "Forbidden");
+}
+
+static void
+http_server_netconn_resp_404(http_server_conn_ctx_t* const p_ctx, http_server_resp_t* const p_resp)
+{
+    http_server_netconn_resp_with_code(p_ctx, p_resp, HTTP_RESP_CODE_404, "Not Found");
 }
 
 static void
-http_server_netconn_resp_404(struct netconn* const p_conn, http_server_resp_t* const p_resp)
+http_server_netconn_resp_409(http_server_conn_ctx_t* const p_ctx, http_server_resp_t* const p_resp)
 {
-    http_server_netconn_resp_with_code(p_conn, p_resp, HTTP_RESP_CODE_404, "Not Found");
+    http_server_netconn_resp_with_code(p_ctx, p_resp, HTTP_RESP_CODE_409, "Conflict");
 }
 
 static void
-http_server_netconn_resp_409(struct netconn* const p_conn, http_server_resp_t* const p_resp)
+http_server_netconn_resp_413(http_server_conn_ctx_t* const p_ctx, http_server_resp_t* const p_resp)
 {
-    http_server_netconn_resp_with_code(p_conn, p_resp, HTTP_RESP_CODE_409, "Conflict");
+    http_server_netconn_resp_with_code(p_ctx, p_resp, HTTP_RESP_CODE_413, "Payload Too Large");
 }
 
 static void
-http_server_netconn_resp_429(struct netconn* const p_conn, http_server_resp_t* const p_resp)
+http_server_netconn_resp_429(http_server_conn_ctx_t* const p_ctx, http_server_resp_t* const p_resp)
 {
-    http_server_netconn_resp_with_code(p_conn, p_resp, HTTP_RESP_CODE_429, "Too Many Requests");
+    http_server_netconn_resp_with_code(p_ctx, p_resp, HTTP_RESP_CODE_429, "Too Many Requests");
 }
 
 static void
-http_server_netconn_resp_500(struct netconn* const p_conn, http_server_resp_t* const p_resp)
+http_server_netconn_resp_500(http_server_conn_ctx_t* const p_ctx, http_server_resp_t* const p_resp)
 {
-    http_server_netconn_resp_with_code(p_conn, p_resp, HTTP_RESP_CODE_500, "Internal Server Error");
+    http_server_netconn_resp_with_code(p_ctx, p_resp, HTTP_RESP_CODE_500, "Internal Server Error");
 }
 
 static void
-http_server_netconn_resp_502(struct netconn* const p_conn, http_server_resp_t* const p_resp)
+http_server_netconn_resp_502(http_server_conn_ctx_t* const p_ctx, http_server_resp_t* const p_resp)
 {
-    http_server_netconn_resp_with_code(p_conn, p_resp, HTTP_RESP_CODE_502, "Bad Gateway");
+    http_server_netconn_resp_with_code(p_ctx, p_resp, HTTP_RESP_CODE_502, "Bad Gateway");
 }
 
 static void
-http_server_netconn_resp_503(struct netconn* const p_conn, http_server_resp_t* const p_resp)
+http_server_netconn_resp_503(http_server_conn_ctx_t* const p_ctx, http_server_resp_t* const p_resp)
 {
-    http_server_netconn_resp_with_code(p_conn, p_resp, HTTP_RESP_CODE_503, "Service Unavailable");
+    http_server_netconn_resp_with_code(p_ctx, p_resp, HTTP_RESP_CODE_503, "Service Unavailable");
 }
 
 static void
-http_server_netconn_resp_504(struct netconn* const p_conn, http_server_resp_t* const p_resp)
+http_server_netconn_resp_504(http_server_conn_ctx_t* const p_ctx, http_server_resp_t* const p_resp)
 {
-    http_server_netconn_resp_with_code(p_conn, p_resp, HTTP_RESP_CODE_504, "Gateway timeout");
+    http_server_netconn_resp_with_code(p_ctx, p_resp, HTTP_RESP_CODE_504, "Gateway timeout");
 }
 
+/**
+ * @brief Prepare the header of the response for sending.
+ * @param p_host - the value of "Host" header field (used for redirects), if it's NULL,
+ *                 then the local IP address is used.
+ */
 static void
-http_server_netconn_resp(struct netconn* const p_conn, http_server_resp_t* const p_resp, const char* const p_hostname)
+http_server_netconn_resp(
+    http_server_conn_ctx_t* const p_ctx,
+    http_server_resp_t* const     p_resp,
+    const char* const             p_host,
+    const size_t                  host_len)
 {
+    const bool        flag_use_host = (NULL != p_host) && (0 != host_len);
+    const char* const p_hostname    = flag_use_host ? p_host : p_ctx->local_ip_str.buf;
+    const size_t      hostname_len  = flag_use_host ? host_len : strlen(p_ctx->local_ip_str.buf);
     switch (p_resp->http_resp_code)
     {
-        case HTTP_RESP_CODE_206: // Server supports only HTTP/1.0, so fall back to HTTP status 200 for partial content
+        case HTTP_RESP_CODE_206:
+            // The handler can't provide "Content-Range", the range requested by the client is applied by the server
             p_resp->http_resp_code = HTTP_RESP_CODE_200;
-            LOG_WARN("Falling back to HTTP/1.0 status code 200 for partial content");
             ATTR_FALLTHROUGH;
         case HTTP_RESP_CODE_200:
             ATTR_FALLTHROUGH;
         case HTTP_RESP_CODE_299:
-            http_server_netconn_resp_200(p_conn, p_resp, &g_http_server_extra_header_fields);
+            http_server_netconn_resp_200(p_ctx, p_resp, &p_ctx->extra_header_fields);
             return;
         case HTTP_RESP_CODE_301:
-            http_server_netconn_resp_301_auth_html(p_conn, p_hostname, &g_http_server_extra_header_fields);
+            http_server_netconn_resp_301_auth_html(p_ctx, p_hostname, hostname_len, &p_ctx->extra_header_fields);
             return;
         case HTTP_RESP_CODE_302:
-            http_server_netconn_resp_302_auth_html(p_conn, p_hostname, &g_http_server_extra_header_fields);
+            http_server_netconn_resp_302_auth_html(p_ctx, p_hostname, hostname_len, &p_ctx->extra_header_fields);
+            return;
+        case HTTP_RESP_CODE_304:
+            http_server_netconn_resp_304(p_ctx, p_resp);
             return;
         case HTTP_RESP_CODE_400:
-            http_server_netconn_resp_400(p_conn, p_resp);
+            http_server_netconn_resp_400(p_ctx, p_resp);
             return;
         case HTTP_RESP_CODE_401:
-            http_server_netconn_resp_401(p_conn, p_resp, &g_http_server_extra_header_fields);
+            http_server_netconn_resp_401(p_ctx, p_resp, &p_ctx->extra_header_fields);
             return;
         case HTTP_RESP_CODE_403:
-            http_server_netconn_resp_403(p_conn, p_resp, &g_http_server_extra_header_fields);
+            http_server_netconn_resp_403(p_ctx, p_resp, &p_ctx->extra_header_fields);
             return;
         case HTTP_RESP_CODE_404:
-            http_server_netconn_resp_404(p_conn, p_resp);
+            http_server_netconn_resp_404(p_ctx, p_resp);
             return;
         case HTTP_RESP_CODE_409:
-            http_server_netconn_resp_409(p_conn, p_resp);
+            http_server_netconn_resp_409(p_ctx, p_resp);
+            return;
+        case HTTP_RESP_CODE_413:
+            http_server_netconn_resp_413(p_ctx, p_resp);
+            return;
+        case HTTP_RESP_CODE_416:
+            http_server_netconn_resp_with_code(p_ctx, p_resp, HTTP_RESP_CODE_416, "Range Not Satisfiable");
             return;
         case HTTP_RESP_CODE_429:
-            http_server_netconn_resp_429(p_conn, p_resp);
+            http_server_netconn_resp_429(p_ctx, p_resp);
             return;
         case HTTP_RESP_CODE_500:
-            http_server_netconn_resp_500(p_conn, p_resp);
+            http_server_netconn_resp_500(p_ctx, p_resp);
             return;
         case HTTP_RESP_CODE_502:
-            http_server_netconn_resp_502(p_conn, p_resp);
+            http_server_netconn_resp_502(p_ctx, p_resp);
             return;
         case HTTP_RESP_CODE_503:
-            http_server_netconn_resp_503(p_conn, p_resp);
+            http_server_netconn_resp_503(p_ctx, p_resp);
             return;
         case HTTP_RESP_CODE_504:
-            http_server_netconn_resp_504(p_conn, p_resp);
+            http_server_netconn_resp_504(p_ctx, p_resp);
             return;
     }
-    LOG_ERR("Unsupported HTTP response code: %u", (printf_uint_t)p_resp->http_resp_code);
-    assert(0);
-    http_server_netconn_resp_503(p_conn, p_resp);
+    LOG_ERR("Unsupported HTTP response code: %u", (printf_uint_t)p_resp->http_resp_code);
+    assert(0);
+    http_server_netconn_resp_503(p_ctx, p_resp);
+}
+
+/**
+ * @brief Check if the comma-separated list of tokens in the header field value contains the given token.
+ */
+static bool
+http_server_hdr_has_token(const char* const p_val, const uint32_t val_len, const char* const p_token)
+{
+    const size_t token_len = strlen(p_token);
+    uint32_t     offset    = 0;
+    while (offset < val_len)
+    {
+        while ((offset < val_len) && ((' ' == p_val[offset]) || ('\t' == p_val[offset]) || (',' == p_val[offset])))
+        {
+            offset += 1;
+        }
+        const uint32_t token_start = offset;
+        while ((offset < val_len) && (',' != p_val[offset]))
+        {
+            offset += 1;
+        }
+        uint32_t token_end = offset;
+        while ((token_end > token_start) && ((' ' == p_val[token_end - 1]) || ('\t' == p_val[token_end - 1])))
+        {
+            token_end -= 1;
+        }
+        if (((token_end - token_start) == token_len) && (0 == strncasecmp(&p_val[token_start], p_token, token_len)))
+        {
+            return true;
+        }
+    }
+    return false;
+}
+
+/**
+ * @brief Decide whether the connection can be kept open after responding to the current request.
+ * @note HTTP/1.1 connections are persistent unless the client sends "Connection: close",
+ *       HTTP/1.0 connections are closed unless the client sends "Connection: keep-alive".
+ */
+static bool
+http_server_is_keep_alive_requested(const http_req_info_t* const p_req_info, const bool flag_http_1_1)
+{
+    uint32_t          conn_len = 0;
+    const char* const p_conn   = http_req_header_get_field(p_req_info->http_header, "Connection:", &conn_len);
+    if (NULL == p_conn)
+    {
+        return flag_http_1_1;
+    }
+    if (http_server_hdr_has_token(p_conn, conn_len, "close"))
+    {
+        return false;
+    }
+    if (http_server_hdr_has_token(p_conn, conn_len, "keep-alive"))
+    {
+        return true;
+    }
+    return flag_http_1_1;
+}
+
+/**
+ * @brief Make sure that the content of the response can be sent without holding the handler lock.
+ * @note Short JSON responses from static buffers (like the auth JSON) are copied to the connection context,
+ *       because the next request handled by another worker can overwrite the static buffer.
+ * @return false if the content is in a shared buffer or it is generated from a shared state,
+ *         so the handler lock must be held until the response is sent.
+ */
+static bool
+http_server_conn_detach_resp_from_shared_mem(http_server_conn_ctx_t* const p_ctx, http_server_resp_t* const p_resp)
+{
+    switch (p_resp->content_location)
+    {
+        case HTTP_CONTENT_LOCATION_NO_CONTENT:
+        case HTTP_CONTENT_LOCATION_FLASH_MEM:
+        case HTTP_CONTENT_LOCATION_HEAP:
+        case HTTP_CONTENT_LOCATION_FATFS:
+            return true;
+        case HTTP_CONTENT_LOCATION_JSON_GENERATOR:
+            return false;
+        case HTTP_CONTENT_LOCATION_STATIC_MEM:
+            break;
+    }
+    const uint8_t* const p_buf = p_resp->select_location.memory.p_buf;
+    if ((const uint8_t*)p_ctx->resp_status_json.buf == p_buf)
+    {
+        return true;
+    }
+    if ((HTTP_CONTENT_TYPE_APPLICATION_JSON != p_resp->content_type)
+        || (p_resp->content_len >= sizeof(p_ctx->resp_json_copy.buf)))
+    {
+        return false;
+    }
+    memcpy(p_ctx->resp_json_copy.buf, p_buf, p_resp->content_len);
+    p_ctx->resp_json_copy.buf[p_resp->content_len] = '\0';
+    p_resp->select_location.memory.p_buf           = (const uint8_t*)p_ctx->resp_json_copy.buf;
+    return true;
+}
+
+static void
+http_server_conn_prepare_resp(
+    http_server_conn_ctx_t* const p_ctx,
+    http_server_resp_t* const     p_resp,
+    const char* const             p_host,
+    const uint32_t                host_len);
+
+static void
+http_server_conn_body_stream_start(http_server_conn_ctx_t* const p_ctx);
+
+static void
+http_server_conn_body_stream_abort(http_server_conn_ctx_t* const p_ctx);
+
+/**
+ * @brief Save the header fields of the conditional request and "Accept-Encoding", they are checked when the response
+ *        is prepared.
+ */
+static void
+http_server_conn_parse_conditional_req(http_server_conn_ctx_t* const p_ctx, const http_req_info_t* const p_req_info)
+{
+    p_ctx->p_if_none_match = http_req_header_get_field(
+        p_req_info->http_header,
+        "If-None-Match:",
+        &p_ctx->if_none_match_len);
+
+    uint32_t          if_modified_since_len = 0;
+    const char* const p_if_modified_since   = http_req_header_get_field(
+        p_req_info->http_header,
+        "If-Modified-Since:",
+        &if_modified_since_len);
+    if ((NULL != p_if_modified_since)
+        && (!http_req_parse_http_date(p_if_modified_since, if_modified_since_len, &p_ctx->if_modified_since)))
+    {
+        LOG_WARN("Invalid If-Modified-Since: %.*s", (printf_int_t)if_modified_since_len, p_if_modified_since);
+        p_ctx->if_modified_since = 0;
+    }
+
+    uint32_t          accept_encoding_len = 0;
+    const char* const p_accept_encoding   = http_req_header_get_field(
+        p_req_info->http_header,
+        "Accept-Encoding:",
+        &accept_encoding_len);
+    p_ctx->accept_encoding = http_req_parse_accept_encoding(p_accept_encoding, accept_encoding_len);
 }
 
 static void
-http_server_netconn_serve_handle_req(
-    struct netconn* const        p_conn,
-    char* const                  p_req_buf,
-    const sta_ip_string_t* const p_local_ip_str,
-    const sta_ip_string_t* const p_remote_ip_str)
+http_server_netconn_serve_handle_req(http_server_conn_ctx_t* const p_ctx, char* const p_req_buf)
 {
-    const http_req_info_t req_info = http_req_parse(p_req_buf);
+    const sta_ip_string_t* const p_local_ip_str  = &p_ctx->local_ip_str;
+    const sta_ip_string_t* const p_remote_ip_str = &p_ctx->remote_ip_str;
+
+    p_ctx->flag_http_1_1     = false;
+    p_ctx->flag_keep_alive   = false;
+    p_ctx->flag_head_req     = false;
+    p_ctx->flag_range_req    = false;
+    p_ctx->p_if_none_match   = NULL;
+    p_ctx->if_none_match_len = 0;
+    p_ctx->if_modified_since = 0;
+    p_ctx->accept_encoding   = HTTP_REQ_ACCEPT_ENCODING_IDENTITY;
+
+    http_req_info_t req_info = http_req_parser_get_info(&p_ctx->req_parser, p_req_buf);
+    if ((0 == p_ctx->req_parser.content_len) && (NULL != req_info.http_body.ptr))
+    {
+        // The request without body can be handled directly in the pbuf without the terminating '\0' after it
+        req_info.http_body.ptr = "";
+    }
     if (!req_info.is_success)
     {
         LOG_ERR(
@@ -857,12 +1591,36 @@ http_server_netconn_serve_handle_req(
             p_remote_ip_str->buf,
             p_local_ip_str->buf,
             p_req_buf);
-        http_server_netconn_resp_400(p_conn, NULL);
+        http_server_netconn_resp_400(p_ctx, NULL);
         return;
     }
+    if (HTTP_SERVER_KEEP_ALIVE_ENABLE)
+    {
+        p_ctx->flag_http_1_1 = (NULL != req_info.http_ver.ptr) && (0 == strcmp(req_info.http_ver.ptr, "HTTP/1.1"));
+        p_ctx->flag_keep_alive = (p_ctx->num_requests < HTTP_SERVER_KEEP_ALIVE_MAX_REQUESTS)
+                                 && http_server_is_keep_alive_requested(&req_info, p_ctx->flag_http_1_1);
+    }
+
     uint32_t          host_len = 0;
     const char* const p_host   = http_req_header_get_field(req_info.http_header, "Host:", &host_len);
 
+    const bool flag_get = (NULL != req_info.http_cmd.ptr) && (0 == strcmp(req_info.http_cmd.ptr, "GET"));
+    p_ctx->flag_head_req = (NULL != req_info.http_cmd.ptr) && (0 == strcmp(req_info.http_cmd.ptr, "HEAD"));
+    if (flag_get || p_ctx->flag_head_req)
+    {
+        http_server_conn_parse_conditional_req(p_ctx, &req_info);
+    }
+    if (flag_get)
+    {
+        uint32_t          range_len = 0;
+        const char* const p_range   = http_req_header_get_field(req_info.http_header, "Range:", &range_len);
+        if (NULL != p_range)
+        {
+            p_ctx->flag_range_req = http_req_parse_range(p_range, range_len, &p_ctx->req_range);
+            LOG_INFO("Range: %.*s%s", (printf_int_t)range_len, p_range, p_ctx->flag_range_req ? "" : " (ignored)");
+        }
+    }
+
     LOG_INFO(
         "Request from %s to %s (Host: %.*s): %s %s%s%s",
         p_remote_ip_str->buf,
@@ -889,7 +1647,7 @@ http_server_netconn_serve_handle_req(
         if (wifi_manager_is_req_from_lan_blocked_while_ap_is_active())
         {
             LOG_WARN("Request from LAN while WiFi hotspot is active - return HTTP error 503");
-            http_server_netconn_resp_503(p_conn, NULL);
+            http_server_netconn_resp_503(p_ctx, NULL);
             return;
         }
     }
@@ -899,24 +1657,62 @@ http_server_netconn_serve_handle_req(
         const bool is_request_to_ap_ip = ((host_len > 0) && (NULL != strstr(p_host, ap_ip_str.buf)));
         if (!is_request_to_ap_ip)
         {
-            http_server_netconn_resp_302(p_conn);
+            http_server_netconn_resp_302(p_ctx);
             return;
         }
     }
 
-    g_http_server_extra_header_fields.buf[0] = '\0';
+    p_ctx->extra_header_fields.buf[0] = '\0';
 
     const http_server_handle_req_param_t param = {
         .p_req_info           = &req_info,
         .p_remote_ip          = p_remote_ip_str,
         .p_auth_info          = http_server_get_auth(),
         .flag_access_from_lan = flag_access_from_lan,
+        .p_resp_status_json   = &p_ctx->resp_status_json,
     };
 
-    http_server_resp_t resp = http_server_handle_req(&param, &g_http_server_extra_header_fields);
-    if ('\0' != g_http_server_extra_header_fields.buf[0])
+    http_server_handler_lock();
+    http_server_arena_begin();
+    if (p_ctx->flag_body_stream)
+    {
+        http_server_resp_t resp = { 0 };
+        p_ctx->p_body_stream    = http_server_handle_req_post_stream_begin(
+            &param,
+            p_ctx->req_parser.content_len,
+            &p_ctx->extra_header_fields,
+            &resp);
+        http_server_arena_end();
+        if (NULL != p_ctx->p_body_stream)
+        {
+            // The response will be prepared after the body is received
+            http_server_handler_unlock();
+            return;
+        }
+        http_server_conn_prepare_resp(p_ctx, &resp, p_host, host_len);
+        return;
+    }
+    http_server_resp_t resp = http_server_handle_req(&param, &p_ctx->extra_header_fields);
+    // The response never refers to the arena: the built-in handlers respond with static or heap buffers
+    http_server_arena_end();
+    http_server_conn_prepare_resp(p_ctx, &resp, p_host, host_len);
+}
+
+/**
+ * @brief Prepare the response returned by the request handler for sending.
+ * @note This function must be called with the handler lock held, it releases the lock.
+ */
+static void
+http_server_conn_prepare_resp(
+    http_server_conn_ctx_t* const p_ctx,
+    http_server_resp_t* const     p_resp,
+    const char* const             p_host,
+    const uint32_t                host_len)
+{
+    http_server_resp_t resp = *p_resp;
+    if ('\0' != p_ctx->extra_header_fields.buf[0])
     {
-        LOG_INFO("Extra HTTP-header resp: %s", g_http_server_extra_header_fields.buf);
+        LOG_INFO("Extra HTTP-header resp: %s", p_ctx->extra_header_fields.buf);
     }
     if ((HTTP_CONTENT_TYPE_APPLICATION_JSON == resp.content_type)
         && ((HTTP_CONTENT_LOCATION_STATIC_MEM == resp.content_location)
@@ -936,30 +1732,66 @@ http_server_netconn_serve_handle_req(
         }
     }
 
-    str_buf_t hostname = ((NULL != p_host) && (0 != host_len)) ? str_buf_printf_with_alloc("%.*s", host_len, p_host)
-                                                               : str_buf_printf_with_alloc("%s", p_local_ip_str->buf);
-    http_server_netconn_resp(p_conn, &resp, hostname.buf);
-    str_buf_free_buf(&hostname);
+    const bool flag_resp_in_shared_mem = !http_server_conn_detach_resp_from_shared_mem(p_ctx, &resp);
+    if (!flag_resp_in_shared_mem)
+    {
+        http_server_handler_unlock();
+    }
+
+    http_server_netconn_resp(p_ctx, &resp, p_host, host_len);
+
+    if (flag_resp_in_shared_mem)
+    {
+        // The content can be changed by the next request, so it must be sent before releasing the lock.
+        if (!http_server_conn_resp_send(p_ctx))
+        {
+            p_ctx->flag_keep_alive = false;
+        }
+        http_server_handler_unlock();
+    }
 }
 
 /**
- * @brief Helper function that processes one HTTP request at a time.
- * @param p_conn - ptr to a connection object
+ * @brief Lock the external mutex (if it was set by http_server_use_mutex_for_incoming_connection_handling)
+ *        to prevent handling HTTP requests while it is held by the application.
+ * @return true if the mutex is not used or it was successfully locked.
  */
-static void
-http_server_netconn_serve(struct netconn* const p_conn)
+static bool
+http_server_lock_ext_mutex(const os_mutex_t p_mutex)
 {
-    uint32_t req_size  = 0;
-    bool     req_ready = false;
+    if (NULL == p_mutex)
+    {
+        return true;
+    }
+    const os_delta_ticks_t tick_start = xTaskGetTickCount();
+    while (!os_mutex_lock_with_timeout(p_mutex, pdMS_TO_TICKS(HTTP_SERVER_KEEP_ALIVE_POLL_INTERVAL_MS)))
+    {
+        if ((xTaskGetTickCount() - tick_start) >= pdMS_TO_TICKS(HTTP_SERVER_RECV_TIMEOUT_MS))
+        {
+            return false;
+        }
+        http_server_feed_task_wdt();
+    }
+    return true;
+}
 
-    sta_ip_string_t local_ip_str  = { '\0' };
-    sta_ip_string_t remote_ip_str = { '\0' };
+bool
+http_server_conn_ctx_init(http_server_conn_ctx_t* const p_ctx, struct netconn* const p_conn)
+{
+    // The buffers are assigned to the context once by http_server_conn_pool_init
+    char* const    p_lin_buf   = p_ctx->p_lin_buf;
+    uint8_t* const p_chunk_buf = p_ctx->writer.p_chunk_buf;
+    memset(p_ctx, 0, sizeof(*p_ctx));
+    p_ctx->p_lin_buf                    = p_lin_buf;
+    p_ctx->writer.p_chunk_buf           = p_chunk_buf;
+    p_ctx->p_netconn                    = p_conn;
+    p_ctx->writer.resp.content_location = HTTP_CONTENT_LOCATION_NO_CONTENT;
 
     const struct tcp_pcb* const p_tcp = p_conn->pcb.tcp;
     if (NULL == p_tcp)
     {
         LOG_ERR("p_conn->pcb.tcp is NULL due to race condition(1)");
-        return;
+        return false;
     }
 
     const ip_addr_t local_ip  = p_tcp->local_ip;
@@ -967,61 +1799,440 @@ http_server_netconn_serve(struct netconn* const p_conn)
     if (NULL == p_conn->pcb.tcp)
     {
         LOG_ERR("p_conn->pcb.tcp is NULL due to race condition(2)");
+        return false;
+    }
+    ipaddr_ntoa_r(&local_ip, p_ctx->local_ip_str.buf, sizeof(p_ctx->local_ip_str.buf));
+    ipaddr_ntoa_r(&remote_ip, p_ctx->remote_ip_str.buf, sizeof(p_ctx->remote_ip_str.buf));
+
+    // The request buffer is used only if the request can't be handled directly in the received pbuf
+    http_req_parser_init(&p_ctx->req_parser);
+    return true;
+}
+
+void
+http_server_conn_ctx_deinit(http_server_conn_ctx_t* const p_ctx)
+{
+    http_server_conn_body_stream_abort(p_ctx);
+    http_server_conn_resp_abort(p_ctx);
+    if (NULL != p_ctx->p_pbuf)
+    {
+        pbuf_free(p_ctx->p_pbuf);
+        p_ctx->p_pbuf = NULL;
+    }
+    p_ctx->p_req_buf = NULL;
+}
+
+bool
+http_server_conn_is_idle(const http_server_conn_ctx_t* const p_ctx)
+{
+    return (0 != p_ctx->num_requests) && (0 == p_ctx->req_size) && (!p_ctx->flag_body_stream);
+}
+
+http_server_conn_recv_res_e
+http_server_conn_recv_nonblocking(http_server_conn_ctx_t* const p_ctx)
+{
+    for (;;)
+    {
+        p_ctx->req_len = http_server_conn_get_full_req_len(p_ctx);
+        if (0 != p_ctx->req_len)
+        {
+            return HTTP_SERVER_CONN_RECV_RES_REQ_READY;
+        }
+        const err_t err = http_server_recv_and_append(p_ctx);
+        if (ERR_OK == err)
+        {
+            continue;
+        }
+        if (ERR_WOULDBLOCK == err)
+        {
+            return HTTP_SERVER_CONN_RECV_RES_NEED_MORE;
+        }
+        if (http_server_conn_is_idle(p_ctx))
+        {
+            LOG_DBG("netconn recv: %d, the keep-alive connection was closed by the client side", (printf_int_t)err);
+        }
+        else if (ERR_BUF != err)
+        {
+            LOG_ERR("netconn recv: %d", (printf_int_t)err);
+        }
+        else
+        {
+            // Warning was already printed in http_server_recv_and_append
+        }
+        return HTTP_SERVER_CONN_RECV_RES_CLOSED;
+    }
+}
+
+static bool
+http_server_conn_body_stream_pass_data(
+    http_server_conn_ctx_t* const p_ctx,
+    const uint8_t* const          p_buf,
+    const uint32_t                len)
+{
+    if (0 == len)
+    {
+        return true;
+    }
+    http_server_handler_lock();
+    const bool res = http_server_handle_req_post_stream_data(p_ctx->p_body_stream, p_buf, len);
+    http_server_handler_unlock();
+    p_ctx->body_stream_rem_len -= len;
+    return res;
+}
+
+/**
+ * @brief The handler refused the next chunk of the body, respond with HTTP error 500 and close the connection.
+ */
+static void
+http_server_conn_body_stream_fail(http_server_conn_ctx_t* const p_ctx)
+{
+    LOG_ERR(
+        "The upload was aborted by the handler, %u bytes were not received",
+        (printf_uint_t)p_ctx->body_stream_rem_len);
+    p_ctx->p_body_stream    = NULL;
+    p_ctx->flag_body_stream = false;
+    p_ctx->flag_keep_alive  = false;
+    http_server_netconn_resp_500(p_ctx, NULL);
+}
+
+/**
+ * @brief Notify the handler that the body will not be received completely.
+ */
+static void
+http_server_conn_body_stream_abort(http_server_conn_ctx_t* const p_ctx)
+{
+    p_ctx->flag_body_stream = false;
+    if (NULL == p_ctx->p_body_stream)
+    {
         return;
     }
-    ipaddr_ntoa_r(&local_ip, local_ip_str.buf, sizeof(local_ip_str.buf));
-    ipaddr_ntoa_r(&remote_ip, remote_ip_str.buf, sizeof(remote_ip_str.buf));
+    LOG_WARN("The upload was aborted, %u bytes were not received", (printf_uint_t)p_ctx->body_stream_rem_len);
+    http_server_handler_lock();
+    http_server_handle_req_post_stream_abort(p_ctx->p_body_stream);
+    http_server_handler_unlock();
+    p_ctx->p_body_stream = NULL;
+}
 
-    const size_t req_buf_size = FULLBUF_SIZE + 1;
-    char*        p_req_buf    = os_malloc(req_buf_size);
-    if (NULL == p_req_buf)
+/**
+ * @brief Pass the part of the body which was received together with the header to the handler
+ *        and release the request buffer.
+ */
+static void
+http_server_conn_body_stream_start(http_server_conn_ctx_t* const p_ctx)
+{
+    if (NULL == p_ctx->p_body_stream)
     {
-        LOG_ERR("Can't allocate %u bytes for tmp buffer", (printf_uint_t)req_buf_size);
+        // The request was rejected before receiving the body, so the connection can't be used for the next request
+        p_ctx->flag_body_stream = false;
+        p_ctx->flag_keep_alive  = false;
         return;
     }
+    const uint32_t body_offset = p_ctx->req_parser.body_offset;
+    p_ctx->body_stream_rem_len = p_ctx->req_parser.content_len;
+
+    const bool res = http_server_conn_body_stream_pass_data(
+        p_ctx,
+        (const uint8_t*)&p_ctx->p_req_buf[body_offset],
+        p_ctx->req_size - body_offset);
+
+    // The header is not needed anymore, the rest of the body is passed to the handler directly from the pbufs
+    if (NULL != p_ctx->p_pbuf)
+    {
+        pbuf_free(p_ctx->p_pbuf);
+        p_ctx->p_pbuf = NULL;
+    }
+    p_ctx->p_req_buf = p_ctx->p_lin_buf;
+    p_ctx->req_size  = 0;
+    p_ctx->req_len   = 0;
 
-    while (!req_ready)
+    if (!res)
+    {
+        http_server_conn_body_stream_fail(p_ctx);
+    }
+}
+
+/**
+ * @brief Pass the body from the received pbuf to the handler.
+ * @note If the pbuf contains the beginning of the next pipelined request after the body,
+ *       it's copied to the request buffer.
+ * @return false if the handler refused the body.
+ */
+static bool
+http_server_conn_body_stream_pass_pbuf(http_server_conn_ctx_t* const p_ctx, const struct pbuf* const p_pbuf)
+{
+    uint32_t offset = 0;
+    for (const struct pbuf* p_cur = p_pbuf; (NULL != p_cur) && (0 != p_ctx->body_stream_rem_len); p_cur = p_cur->next)
     {
-        if (!http_server_recv_and_handle(p_conn, p_req_buf, req_buf_size, &req_size, &req_ready))
+        const uint32_t len = (p_cur->len < p_ctx->body_stream_rem_len) ? p_cur->len : p_ctx->body_stream_rem_len;
+        if (!http_server_conn_body_stream_pass_data(p_ctx, (const uint8_t*)p_cur->payload, len))
         {
-            break;
+            return false;
         }
+        offset += len;
+    }
+    const uint32_t rem_len = p_pbuf->tot_len - offset;
+    if (0 == rem_len)
+    {
+        return true;
+    }
+    if (rem_len >= HTTP_SERVER_REQ_BUF_SIZE)
+    {
+        LOG_WARN("Can't save %u bytes of the next request received after the body", (printf_uint_t)rem_len);
+        p_ctx->flag_keep_alive = false;
+        return true;
     }
-    if (!req_ready)
+    http_server_conn_linearize_req(p_ctx);
+    (void)pbuf_copy_partial(p_pbuf, p_ctx->p_lin_buf, (u16_t)rem_len, (u16_t)offset);
+    p_ctx->req_size                   = rem_len;
+    p_ctx->p_lin_buf[p_ctx->req_size] = '\0';
+    return true;
+}
+
+/**
+ * @brief The body was received completely, get the response from the handler.
+ */
+static void
+http_server_conn_body_stream_end(http_server_conn_ctx_t* const p_ctx)
+{
+    void* const p_stream    = p_ctx->p_body_stream;
+    p_ctx->p_body_stream    = NULL;
+    p_ctx->flag_body_stream = false;
+
+    const os_mutex_t p_mutex = http_server_get_mutex();
+    if (!http_server_lock_ext_mutex(p_mutex))
     {
-        LOG_WARN("The connection was closed by the client side");
-        os_free(p_req_buf);
+        LOG_WARN("Can't lock mutex, respond with HTTP error 503");
+        http_server_handler_lock();
+        http_server_handle_req_post_stream_abort(p_stream);
+        http_server_handler_unlock();
+        p_ctx->flag_keep_alive = false;
+        http_server_netconn_resp_503(p_ctx, NULL);
         return;
     }
+    http_server_handler_lock();
+    http_server_resp_t resp = http_server_handle_req_post_stream_end(p_stream);
+    http_server_conn_prepare_resp(p_ctx, &resp, NULL, 0);
+    if (NULL != p_mutex)
+    {
+        if (!http_server_conn_resp_send(p_ctx))
+        {
+            p_ctx->flag_keep_alive = false;
+        }
+        os_mutex_unlock(p_mutex);
+    }
+}
+
+http_server_conn_recv_res_e
+http_server_conn_recv_body_stream(http_server_conn_ctx_t* const p_ctx)
+{
+    while (0 != p_ctx->body_stream_rem_len)
+    {
+        struct pbuf* p_pbuf = NULL;
+        const err_t  err    = netconn_recv_tcp_pbuf(p_ctx->p_netconn, &p_pbuf);
+        if (ERR_WOULDBLOCK == err)
+        {
+            return HTTP_SERVER_CONN_RECV_RES_NEED_MORE;
+        }
+        if (ERR_OK != err)
+        {
+            LOG_ERR(
+                "netconn recv: %d, %u bytes of the body were not received",
+                (printf_int_t)err,
+                (printf_uint_t)p_ctx->body_stream_rem_len);
+            return HTTP_SERVER_CONN_RECV_RES_CLOSED;
+        }
+        p_ctx->bytes_received += p_pbuf->tot_len;
+
+        const bool res = http_server_conn_body_stream_pass_pbuf(p_ctx, p_pbuf);
+        pbuf_free(p_pbuf);
+        if (!res)
+        {
+            http_server_conn_body_stream_fail(p_ctx);
+            return HTTP_SERVER_CONN_RECV_RES_REQ_READY;
+        }
+        http_server_feed_task_wdt();
+    }
+    http_server_conn_body_stream_end(p_ctx);
+    return HTTP_SERVER_CONN_RECV_RES_REQ_READY;
+}
+
+void
+http_server_conn_handle_req(http_server_conn_ctx_t* const p_ctx)
+{
+    char* const    p_req_buf = p_ctx->p_req_buf;
+    const uint32_t req_len   = p_ctx->req_len;
+
+    p_ctx->num_requests += 1;
+
+    // The buffer can contain the beginning of the next pipelined request after the current one,
+    // so terminate the current request and restore the first byte of the next one after handling.
+    // The request without body which fills the pbuf completely is not terminated,
+    // it's not needed because the parser replaces the separators of its parts with '\0'.
+    const bool flag_terminate = (NULL == p_ctx->p_pbuf) || (req_len < p_ctx->req_size);
+    const char saved_ch       = flag_terminate ? p_req_buf[req_len] : '\0';
+    if (flag_terminate)
+    {
+        p_req_buf[req_len] = '\0';
+    }
 
-    http_server_netconn_serve_handle_req(p_conn, p_req_buf, &local_ip_str, &remote_ip_str);
-    os_free(p_req_buf);
+    const os_mutex_t p_mutex = http_server_get_mutex();
+    if (!http_server_lock_ext_mutex(p_mutex))
+    {
+        LOG_WARN("Can't lock mutex, respond with HTTP error 503");
+        p_ctx->flag_http_1_1   = false;
+        p_ctx->flag_keep_alive = false;
+        p_ctx->flag_head_req   = false;
+        http_server_netconn_resp_503(p_ctx, NULL);
+    }
+    else
+    {
+        http_server_netconn_serve_handle_req(p_ctx, p_req_buf);
+        if (NULL != p_mutex)
+        {
+            // The application holds the mutex to prevent access to its state while handling the HTTP-request,
+            // the response is generated from the same state, so it must be sent before releasing the mutex.
+            if (!http_server_conn_resp_send(p_ctx))
+            {
+                p_ctx->flag_keep_alive = false;
+            }
+            os_mutex_unlock(p_mutex);
+        }
+    }
+    if (flag_terminate)
+    {
+        p_req_buf[req_len] = saved_ch;
+    }
+    if (p_ctx->flag_body_stream)
+    {
+        http_server_conn_body_stream_start(p_ctx);
+    }
+}
+
+bool
+http_server_conn_finish_req(http_server_conn_ctx_t* const p_ctx)
+{
+    if (!p_ctx->flag_keep_alive)
+    {
+        return false;
+    }
+    const uint32_t req_len = p_ctx->req_len;
+    p_ctx->req_size -= req_len;
+    p_ctx->req_len = 0;
+    http_req_parser_init(&p_ctx->req_parser);
+    if (NULL != p_ctx->p_pbuf)
+    {
+        if (0 == p_ctx->req_size)
+        {
+            pbuf_free(p_ctx->p_pbuf);
+            p_ctx->p_pbuf    = NULL;
+            p_ctx->p_req_buf = NULL;
+            return true;
+        }
+        // The beginning of the next pipelined request is moved from the pbuf to the linear buffer
+        // to be able to free the pbuf and append the next received data.
+        p_ctx->p_req_buf = &p_ctx->p_req_buf[req_len];
+        http_server_conn_linearize_req(p_ctx);
+        return true;
+    }
+    if (0 == p_ctx->req_size)
+    {
+        p_ctx->p_req_buf = NULL;
+        return true;
+    }
+    memmove(p_ctx->p_req_buf, &p_ctx->p_req_buf[req_len], p_ctx->req_size);
+    p_ctx->p_req_buf[p_ctx->req_size] = '\0';
+    return true;
 }
 
 void
-http_server_accept_and_handle_conn(struct netconn* const p_conn)
+http_server_conn_resp_canned_503(struct netconn* const p_conn)
+{
+    LOG_WARN("No free connection context, respond with HTTP error 503");
+    size_t      bytes_written = 0;
+    const err_t err           = netconn_write_partly(
+        p_conn,
+        g_http_server_canned_resp_503,
+        sizeof(g_http_server_canned_resp_503) - 1,
+        NETCONN_NOCOPY,
+        &bytes_written);
+    if (ERR_OK != err)
+    {
+        LOG_ERR("netconn_write_partly failed (%s)", conv_lwip_err_to_str(err));
+    }
+}
+
+/**
+ * @brief Helper function that processes HTTP requests received over the connection one at a time
+ *        until the connection is closed (by the client, on idle timeout or when keep-alive is not used).
+ * @param p_conn - ptr to a connection object
+ */
+static void
+http_server_netconn_serve(struct netconn* const p_conn)
+{
+    http_server_conn_ctx_t* const p_ctx = http_server_conn_pool_acquire();
+    if (NULL == p_ctx)
+    {
+        http_server_conn_resp_canned_503(p_conn);
+        return;
+    }
+    if (http_server_conn_ctx_init(p_ctx, p_conn))
+    {
+        for (;;)
+        {
+            if (!http_server_recv_req(p_ctx))
+            {
+                if (0 == p_ctx->num_requests)
+                {
+                    LOG_WARN("The connection was closed by the client side");
+                }
+                break;
+            }
+            http_server_conn_handle_req(p_ctx);
+            if (p_ctx->flag_body_stream
+                && (HTTP_SERVER_CONN_RECV_RES_REQ_READY != http_server_conn_recv_body_stream(p_ctx)))
+            {
+                break;
+            }
+            if (!http_server_conn_resp_send(p_ctx))
+            {
+                break;
+            }
+            if (!http_server_conn_finish_req(p_ctx))
+            {
+                break;
+            }
+        }
+    }
+    http_server_conn_ctx_deinit(p_ctx);
+    http_server_conn_pool_release(p_ctx);
+}
+
+struct netconn*
+http_server_accept_conn(struct netconn* const p_conn)
 {
     struct netconn* p_new_conn = NULL;
 
     os_mutex_t p_mutex = http_server_get_mutex();
-    if ((NULL != p_mutex) && (!os_mutex_try_lock(p_mutex)))
+    if ((NULL != p_mutex) && (!os_mutex_lock_with_timeout(p_mutex, pdMS_TO_TICKS(HTTP_SERVER_ACCEPT_MUTEX_WAIT_MS))))
     {
-        LOG_DBG("Can't lock mutex, sleep for %u ms", HTTP_SERVER_ACCEPT_DELAY_MS);
-        vTaskDelay(pdMS_TO_TICKS(HTTP_SERVER_ACCEPT_DELAY_MS));
-        return;
+        LOG_DBG("Can't lock mutex during %u ms", (printf_uint_t)HTTP_SERVER_ACCEPT_MUTEX_WAIT_MS);
+        return NULL;
     }
 
     const err_t err = netconn_accept(p_conn, &p_new_conn);
 
+    // The mutex is locked separately for each request received over the accepted connection
+    // to avoid blocking the application while the keep-alive connection is idle.
+    if (NULL != p_mutex)
+    {
+        os_mutex_unlock(p_mutex);
+    }
+
     if (ERR_OK != err)
     {
-        if (NULL != p_mutex)
-        {
-            os_mutex_unlock(p_mutex);
-        }
         if (ERR_TIMEOUT == err)
         {
-            vTaskDelay(pdMS_TO_TICKS(HTTP_SERVER_ACCEPT_DELAY_MS));
+            LOG_DBG("netconn_accept: timeout");
         }
         else if (ERR_ABRT == err)
         {
@@ -1031,14 +2242,15 @@ http_server_accept_and_handle_conn(struct netconn* const p_conn)
         {
             LOG_ERR("netconn_accept: %d", err);
         }
-        return;
+        return NULL;
     }
 
     if (NULL == p_new_conn)
     {
         LOG_ERR("netconn_accept returned OK, but p_new_conn is NULL");
+        return NULL;
     }
-    else if (NULL == p_conn->pcb.tcp)
+    if (NULL == p_conn->pcb.tcp)
     {
         // It seems that's a bug in netconn_accept, err is ERR_OK, p_new_conn is not NULL,
         // but p_conn->pcb.tcp is NULL.
@@ -1046,38 +2258,41 @@ http_server_accept_and_handle_conn(struct netconn* const p_conn)
         // As a workaround try to free resources and ignore this error.
         LOG_ERR("netconn_accept returned OK, but p_conn->pcb.tcp is NULL");
         netconn_delete(p_new_conn);
+        return NULL;
     }
-    else
+    netconn_set_recvtimeout(p_new_conn, HTTP_SERVER_RECV_TIMEOUT_MS);
+    netconn_set_sendtimeout(p_new_conn, HTTP_SERVER_SEND_TIMEOUT_MS);
+    return p_new_conn;
+}
+
+void
+http_server_close_conn(struct netconn* const p_conn)
+{
+    LOG_DBG("call netconn_close");
+    const err_t err_close = netconn_close(p_conn);
+    if (ESP_OK != err_close)
+    {
+        LOG_ERR_ESP(err_close, "%s failed (%s)", "netconn_close", conv_lwip_err_to_str(err_close));
+    }
+    LOG_DBG("call netconn_delete");
+    const err_t err_delete = netconn_delete(p_conn);
+    if (ESP_OK != err_delete)
     {
+        LOG_ERR_ESP(err_delete, "%s failed", "netconn_delete");
+    }
+}
+
+void
+http_server_handle_conn(struct netconn* const p_conn)
+{
 #if LOG_LOCAL_LEVEL >= LOG_LEVEL_DEBUG
-        const os_delta_ticks_t t0 = xTaskGetTickCount();
+    const os_delta_ticks_t t0 = xTaskGetTickCount();
 #endif
-        const int_fast32_t recv_timeout_ms = 3000;
-        netconn_set_recvtimeout(p_new_conn, recv_timeout_ms);
-        const int_fast32_t send_timeout_ms = 15000;
-        netconn_set_sendtimeout(p_new_conn, send_timeout_ms);
-        LOG_DBG("call http_server_netconn_serve");
-        http_server_netconn_serve(p_new_conn);
-        LOG_DBG("call netconn_close");
-        const err_t err_close = netconn_close(p_new_conn);
-        if (ESP_OK != err_close)
-        {
-            LOG_ERR_ESP(err_close, "%s failed (%s)", "netconn_close", conv_lwip_err_to_str(err_close));
-        }
-        LOG_DBG("call netconn_delete");
-        const err_t err_delete = netconn_delete(p_new_conn);
-        if (ESP_OK != err_delete)
-        {
-            LOG_ERR_ESP(err_delete, "%s failed", "netconn_delete");
-        }
+    LOG_DBG("call http_server_netconn_serve");
+    http_server_netconn_serve(p_conn);
+    http_server_close_conn(p_conn);
 #if LOG_LOCAL_LEVEL >= LOG_LEVEL_DEBUG
-        const os_delta_ticks_t time_for_processing_request = xTaskGetTickCount() - t0;
-        LOG_DBG("req processed for %u ticks", (printf_uint_t)time_for_processing_request);
+    const os_delta_ticks_t time_for_processing_request = xTaskGetTickCount() - t0;
+    LOG_DBG("req processed for %u ticks", (printf_uint_t)time_for_processing_request);
 #endif
-    }
-
-    if (NULL != p_mutex)
-    {
-        os_mutex_unlock(p_mutex);
-    }
 }
@@ -10,16 +10,204 @@
 
 #include "os_wrapper_types.h"
 #include "lwip/api.h"
+#include "sta_ip.h"
+#include "http_server_resp.h"
+#include "json_network_info.h"
+#include "http_req.h"
+#include "http_server_cfg.h"
 
 #ifdef __cplusplus
 extern "C" {
 #endif
 
-#define HTTP_SERVER_ACCEPT_TIMEOUT_MS (1)
-#define HTTP_SERVER_ACCEPT_DELAY_MS   (53)
+#define HTTP_SERVER_ACCEPT_TIMEOUT_MS    (1)
+#define HTTP_SERVER_ACCEPT_MUTEX_WAIT_MS (250)
 
+#define HTTP_SERVER_RECV_TIMEOUT_MS             (3000)
+#define HTTP_SERVER_SEND_TIMEOUT_MS             (15000)
+#define HTTP_SERVER_KEEP_ALIVE_POLL_INTERVAL_MS (100)
+
+/**
+ * The size of the buffer for the status line and header fields of the response,
+ * it's enough for the longest set of header fields with HTTP_SERVER_EXTRA_HEADER_FIELDS_SIZE extra fields.
+ */
+#define HTTP_SERVER_CONN_HDR_BUF_SIZE (1024U)
+
+#define HTTP_SERVER_CONN_CHUNK_FRAME_SIZE (16U)
+
+/**
+ * The size of the buffer in which the request split between several pbufs is assembled (with the terminating '\0').
+ */
+#define HTTP_SERVER_REQ_BUF_SIZE (HTTP_SERVER_CONN_REQ_BUF_SIZE + 1U)
+
+/**
+ * @brief The state of the response which is being sent, it allows to send the response in several steps
+ *        without blocking (see http_server_conn_resp_send_step).
+ */
+typedef struct http_server_conn_resp_writer_t
+{
+    char               hdr_buf[HTTP_SERVER_CONN_HDR_BUF_SIZE]; // Status line and header fields of the response
+    size_t             hdr_len;            // Length of the header (with a short body for some error responses)
+    size_t             hdr_offset;         // Number of bytes of the header which have been already sent
+    http_server_resp_t resp;               // The source of the content
+    size_t             content_offset;     // Number of bytes of the content which have been read from the source
+    size_t             content_start;      // Offset of the first byte to send in the memory buffer (for a range)
+    uint8_t*           p_chunk_buf;        // Buffer for reading from FATFS or staging the output of JSON generator
+    const uint8_t*     p_chunk;            // The current chunk of the content
+    size_t             chunk_len;          // Length of the current chunk
+    size_t             chunk_offset;       // Number of bytes of the current chunk which have been already sent
+    bool               flag_more;          // There are more chunks after the current one
+    bool               flag_chunked;       // The content is sent with "Transfer-Encoding: chunked"
+    char               chunk_frame[HTTP_SERVER_CONN_CHUNK_FRAME_SIZE]; // Size line of the current chunk
+    size_t             chunk_frame_len;    // Length of the size line (0 if the content is sent without framing)
+    size_t             chunk_frame_offset; // Number of bytes of the size line which have been already sent
+    const char*        p_gen_chunk;        // The output of the JSON generator which is not staged yet
+    size_t             gen_chunk_len;      // Length of the output of the JSON generator
+    size_t             gen_chunk_offset;   // Number of bytes of the output which have been already staged
+    bool               flag_gen_end;       // The JSON generator has finished
+    size_t             bytes_sent;         // Total number of bytes sent (used to detect progress)
+    size_t             resp_bytes_sent;    // The value of bytes_sent at the beginning of the current response
+    uint32_t           cnt_segments;       // Number of writes of the content to lwIP for the current response
+} http_server_conn_resp_writer_t;
+
+/**
+ * @brief The state of the accepted connection which is kept between the requests received over it.
+ * @note Each HTTP worker serves its own connection, so everything that is used after the request handler
+ *       has returned (while the response is being sent) must be stored here rather than in static variables.
+ */
+typedef struct http_server_conn_ctx_t
+{
+    struct netconn*                p_netconn;           // The accepted connection
+    sta_ip_string_t                local_ip_str;        // Local IP address of the connection
+    sta_ip_string_t                remote_ip_str;       // Remote IP address of the connection
+    struct pbuf*                   p_pbuf;              // Received pbuf which contains the current request
+    char*                          p_lin_buf;           // Linear buffer, used if the request is not in one pbuf
+    char*                          p_req_buf;           // Points to the payload of p_pbuf or to p_lin_buf
+    uint32_t                       req_size;            // Number of bytes in the request buffer
+    uint32_t                       req_len;             // Length of the first complete request in the buffer
+    http_req_parser_t              req_parser;          // State of the parser of the first request in the buffer
+    uint32_t                       num_requests;        // Number of requests received over this connection
+    uint32_t                       bytes_received;      // Total number of bytes received (used to detect progress)
+    bool                           flag_body_stream;    // The body of the current request is passed in chunks
+    void*                          p_body_stream;       // The handle of the upload returned by the handler
+    uint32_t                       body_stream_rem_len; // Number of bytes of the body which are not received yet
+    bool                           flag_http_1_1;       // The current request is HTTP/1.1
+    bool                           flag_keep_alive;     // Keep the connection open after the current response
+    bool                           flag_head_req;       // The current request is HEAD, the content is not sent
+    bool                           flag_range_req;      // The current GET request contains a valid "Range"
+    http_req_range_t               req_range;           // The byte range requested by the current request
+    const char*                    p_if_none_match;     // "If-None-Match" in the request buffer (NULL if absent)
+    uint32_t                       if_none_match_len;   // Length of "If-None-Match"
+    time_t                         if_modified_since;   // Value of "If-Modified-Since" (0 if absent or invalid)
+    uint32_t                       accept_encoding;     // Encodings acceptable for the client (see "Accept-Encoding")
+    http_header_extra_fields_t     extra_header_fields; // Extra header fields for the current response
+    http_server_resp_status_json_t resp_status_json;    // Buffer for the content of "status.json"
+    http_server_resp_auth_json_t   resp_json_copy;      // Copy of a short JSON response from a shared static buffer
+    http_server_conn_resp_writer_t writer;              // The state of the response which is being sent
+} http_server_conn_ctx_t;
+
+typedef enum http_server_conn_recv_res_e
+{
+    HTTP_SERVER_CONN_RECV_RES_REQ_READY, // The complete request is in the buffer
+    HTTP_SERVER_CONN_RECV_RES_NEED_MORE, // No more data available at the moment, the request is not complete yet
+    HTTP_SERVER_CONN_RECV_RES_CLOSED,    // The connection was closed by the client or an error occurred
+} http_server_conn_recv_res_e;
+
+typedef enum http_server_conn_send_res_e
+{
+    HTTP_SERVER_CONN_SEND_RES_DONE,        // The response was sent completely
+    HTTP_SERVER_CONN_SEND_RES_WOULD_BLOCK, // The send buffer is full, call it again after NETCONN_EVT_SENDPLUS
+    HTTP_SERVER_CONN_SEND_RES_ERROR,       // Failed to send the response, the connection should be closed
+} http_server_conn_send_res_e;
+
+/**
+ * @brief Accept the connection pending in the listening netconn.
+ * @note This function should be called only when there is a connection in the accept queue.
+ *       If the mutex set by http_server_use_mutex_for_incoming_connection_handling is busy,
+ *       the function waits for it no longer than HTTP_SERVER_ACCEPT_MUTEX_WAIT_MS and returns NULL without accepting
+ *       the connection, so the caller can handle its signals and call it again.
+ * @param p_conn - ptr to the listening netconn
+ * @return ptr to the accepted connection or NULL
+ */
+struct netconn*
+http_server_accept_conn(struct netconn* const p_conn);
+
+/**
+ * @brief Send the canned response with HTTP error 503 to the connection which can't get a connection context.
+ * @note The request is not read, the connection should be closed after the call.
+ */
+void
+http_server_conn_resp_canned_503(struct netconn* const p_conn);
+
+/**
+ * @brief Initialize the connection context for the accepted connection.
+ * @note The context must be taken from the pool (see http_server_conn_pool_acquire), its buffers are kept.
+ * @return false if the connection was already closed.
+ */
+bool
+http_server_conn_ctx_init(http_server_conn_ctx_t* const p_ctx, struct netconn* const p_conn);
+
+/**
+ * @brief Release the resources of the connection context (the connection itself is not closed).
+ */
+void
+http_server_conn_ctx_deinit(http_server_conn_ctx_t* const p_ctx);
+
+/**
+ * @brief Read the data available in the non-blocking connection without waiting.
+ */
+http_server_conn_recv_res_e
+http_server_conn_recv_nonblocking(http_server_conn_ctx_t* const p_ctx);
+
+/**
+ * @brief Check if the connection is waiting for the next request after the previous one was served.
+ */
+bool
+http_server_conn_is_idle(const http_server_conn_ctx_t* const p_ctx);
+
+/**
+ * @brief Handle the complete request from the buffer and prepare the response for sending.
+ * @note If the content of the response can't be detached from the shared memory, the response is sent synchronously.
+ *       If p_ctx->flag_body_stream is set after the call, then the body must be received
+ *       with http_server_conn_recv_body_stream before sending the response.
+ */
+void
+http_server_conn_handle_req(http_server_conn_ctx_t* const p_ctx);
+
+/**
+ * @brief Receive the body of the request which is too large for the request buffer and pass it to the handler.
+ * @note In the blocking mode the function returns after the body is received completely.
+ * @return HTTP_SERVER_CONN_RECV_RES_REQ_READY when the response is prepared.
+ */
+http_server_conn_recv_res_e
+http_server_conn_recv_body_stream(http_server_conn_ctx_t* const p_ctx);
+
+/**
+ * @brief Send as much of the prepared response as possible without blocking.
+ */
+http_server_conn_send_res_e
+http_server_conn_resp_send_step(http_server_conn_ctx_t* const p_ctx);
+
+/**
+ * @brief Finish the current request after its response was sent.
+ * @return true if the connection should be kept open for the next request.
+ */
+bool
+http_server_conn_finish_req(http_server_conn_ctx_t* const p_ctx);
+
+/**
+ * @brief Close and delete the accepted connection.
+ */
+void
+http_server_close_conn(struct netconn* const p_conn);
+
+/**
+ * @brief Serve the requests received over the accepted connection, then close and delete it.
+ * @note It can be called from the listener task or from one of the HTTP worker tasks.
+ * @param p_conn - ptr to the accepted connection
+ */
 void
-http_server_accept_and_handle_conn(struct netconn* const p_conn);
+http_server_handle_conn(struct netconn* const p_conn);
 
 #ifdef __cplusplus
 }
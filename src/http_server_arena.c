@@ -0,0 +1,156 @@
+/**
+ * @file http_server_arena.c
+ * @author TheSomeMan
+ * @date 2026-10-17
+ * @copyright Ruuvi Innovations Ltd, license BSD-3-Clause.
+ */
+
+#include "http_server_arena.h"
+#include <assert.h>
+#include <stdint.h>
+#include <string.h>
+#include "cJSON.h"
+#include "os_malloc.h"
+#include "esp_type_wrapper.h"
+#include "http_server.h"
+#include "http_server_cfg.h"
+
+#define LOG_LOCAL_LEVEL LOG_LEVEL_INFO
+#include "log.h"
+
+#define HTTP_SERVER_ARENA_NUM_WORDS \
+    ((HTTP_SERVER_REQ_ARENA_SIZE + HTTP_SERVER_ARENA_ALIGNMENT - 1U) / HTTP_SERVER_ARENA_ALIGNMENT)
+
+typedef struct http_server_arena_t
+{
+    TaskHandle_t owner;         // The task which allocates from the arena (NULL if the arena is not used)
+    size_t       used;          // Number of bytes allocated from the arena
+    size_t       last_offset;   // Offset of the last allocation, which can be returned to the arena by free
+    size_t       used_max;      // High-water mark
+    uint32_t     cnt_fallbacks; // Number of allocations which did not fit into the arena
+} http_server_arena_t;
+
+static const char TAG[] = "http_server";
+
+static uint64_t            g_http_server_arena_buf[HTTP_SERVER_ARENA_NUM_WORDS];
+static http_server_arena_t g_http_server_arena;
+
+static bool
+http_server_arena_is_owner(void)
+{
+    return (NULL != g_http_server_arena.owner) && (xTaskGetCurrentTaskHandle() == g_http_server_arena.owner);
+}
+
+static bool
+http_server_arena_is_in_arena(const void* const p_mem)
+{
+    const uint8_t* const p_begin = (const uint8_t*)&g_http_server_arena_buf[0];
+    const uint8_t* const p_end   = p_begin + sizeof(g_http_server_arena_buf);
+    return ((const uint8_t*)p_mem >= p_begin) && ((const uint8_t*)p_mem < p_end);
+}
+
+void
+http_server_arena_begin(void)
+{
+    assert(0 == g_http_server_arena.used);
+    g_http_server_arena.owner = xTaskGetCurrentTaskHandle();
+}
+
+void
+http_server_arena_end(void)
+{
+    LOG_DBG(
+        "Request arena: used %u bytes, high-water mark %u bytes",
+        (printf_uint_t)g_http_server_arena.used,
+        (printf_uint_t)g_http_server_arena.used_max);
+    g_http_server_arena.owner       = NULL;
+    g_http_server_arena.used        = 0;
+    g_http_server_arena.last_offset = 0;
+}
+
+TaskHandle_t
+http_server_arena_suspend(void)
+{
+    const TaskHandle_t owner  = g_http_server_arena.owner;
+    g_http_server_arena.owner = NULL;
+    return owner;
+}
+
+void
+http_server_arena_resume(const TaskHandle_t owner)
+{
+    g_http_server_arena.owner = owner;
+}
+
+void*
+http_server_arena_malloc(const size_t size)
+{
+    if (!http_server_arena_is_owner())
+    {
+        return os_malloc(size);
+    }
+    const size_t aligned_size = (size + HTTP_SERVER_ARENA_ALIGNMENT - 1U) & ~(HTTP_SERVER_ARENA_ALIGNMENT - 1U);
+    if ((0 == size) || (aligned_size > (sizeof(g_http_server_arena_buf) - g_http_server_arena.used)))
+    {
+        g_http_server_arena.cnt_fallbacks += 1;
+        LOG_DBG("Request arena: no space for %u bytes, allocate from heap", (printf_uint_t)size);
+        return os_malloc(size);
+    }
+    void* const p_mem               = &((uint8_t*)g_http_server_arena_buf)[g_http_server_arena.used];
+    g_http_server_arena.last_offset = g_http_server_arena.used;
+    g_http_server_arena.used += aligned_size;
+    if (g_http_server_arena.used > g_http_server_arena.used_max)
+    {
+        g_http_server_arena.used_max = g_http_server_arena.used;
+    }
+    return p_mem;
+}
+
+void*
+http_server_arena_calloc(const size_t num, const size_t size)
+{
+    if ((0 != num) && (size > (SIZE_MAX / num)))
+    {
+        return NULL;
+    }
+    void* const p_mem = http_server_arena_malloc(num * size);
+    if (NULL != p_mem)
+    {
+        memset(p_mem, 0, num * size);
+    }
+    return p_mem;
+}
+
+void
+http_server_arena_free(void* const p_mem)
+{
+    if (http_server_arena_is_in_arena(p_mem))
+    {
+        // Only the last allocation can be returned to the arena, the others are released by http_server_arena_end
+        if (p_mem == &((uint8_t*)g_http_server_arena_buf)[g_http_server_arena.last_offset])
+        {
+            g_http_server_arena.used = g_http_server_arena.last_offset;
+        }
+        return;
+    }
+    void* p_heap_mem = p_mem;
+    os_free(p_heap_mem);
+}
+
+void
+http_server_arena_install_cjson_hooks(void)
+{
+    cJSON_Hooks hooks = {
+        .malloc_fn = &http_server_arena_malloc,
+        .free_fn   = &http_server_arena_free,
+    };
+    cJSON_InitHooks(&hooks);
+}
+
+void
+http_server_get_req_arena_stat(http_server_req_arena_stat_t* const p_stat)
+{
+    p_stat->arena_size    = sizeof(g_http_server_arena_buf);
+    p_stat->used_max      = g_http_server_arena.used_max;
+    p_stat->cnt_fallbacks = g_http_server_arena.cnt_fallbacks;
+}
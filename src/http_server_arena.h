@@ -0,0 +1,75 @@
+/**
+ * @file http_server_arena.h
+ * @author TheSomeMan
+ * @date 2026-10-17
+ * @copyright Ruuvi Innovations Ltd, license BSD-3-Clause.
+ */
+
+#ifndef RUUVI_ESP_WIFI_MANAGER_HTTP_SERVER_ARENA_H
+#define RUUVI_ESP_WIFI_MANAGER_HTTP_SERVER_ARENA_H
+
+#include <stddef.h>
+#include "freertos/FreeRTOS.h"
+#include "freertos/task.h"
+
+#ifdef __cplusplus
+extern "C" {
+#endif
+
+#define HTTP_SERVER_ARENA_ALIGNMENT (8U)
+
+/**
+ * @brief Start allocating the temporary buffers of the request handler from the arena.
+ * @note The arena is shared by all the HTTP workers, so this function must be called with the handler lock held
+ *       (see http_server_handler_lock). Only the calling task allocates from the arena,
+ *       all the other tasks allocate from the heap.
+ */
+void
+http_server_arena_begin(void);
+
+/**
+ * @brief Release everything allocated from the arena since http_server_arena_begin.
+ * @note This function must be called before releasing the handler lock.
+ */
+void
+http_server_arena_end(void);
+
+/**
+ * @brief Temporarily stop allocating from the arena, e.g. while a callback of the application is called,
+ *        because the application can keep the allocated memory after the request is handled.
+ * @return the owner of the arena which must be passed to http_server_arena_resume.
+ */
+TaskHandle_t
+http_server_arena_suspend(void);
+
+void
+http_server_arena_resume(const TaskHandle_t owner);
+
+/**
+ * @brief Allocate the buffer from the arena if the calling task is inside the arena scope, otherwise from the heap.
+ * @note If there is not enough space in the arena, the buffer is allocated from the heap.
+ */
+void*
+http_server_arena_malloc(const size_t size);
+
+void*
+http_server_arena_calloc(const size_t num, const size_t size);
+
+/**
+ * @brief Free the buffer allocated by http_server_arena_malloc or http_server_arena_calloc.
+ * @note The buffers allocated from the arena are released all at once by http_server_arena_end.
+ */
+void
+http_server_arena_free(void* const p_mem);
+
+/**
+ * @brief Make cJSON allocate the parsed trees from the arena while the request is handled.
+ */
+void
+http_server_arena_install_cjson_hooks(void);
+
+#ifdef __cplusplus
+}
+#endif
+
+#endif // RUUVI_ESP_WIFI_MANAGER_HTTP_SERVER_ARENA_H
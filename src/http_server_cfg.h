@@ -0,0 +1,140 @@
+/**
+ * @file http_server_cfg.h
+ * @author TheSomeMan
+ * @date 2026-10-17
+ * @copyright Ruuvi Innovations Ltd, license BSD-3-Clause.
+ */
+
+#ifndef RUUVI_ESP_WIFI_MANAGER_HTTP_SERVER_CFG_H
+#define RUUVI_ESP_WIFI_MANAGER_HTTP_SERVER_CFG_H
+
+#include "sdkconfig.h"
+
+#ifdef __cplusplus
+extern "C" {
+#endif
+
+#if defined(CONFIG_WIFI_MANAGER_HTTP_SERVER_KEEP_ALIVE)
+#define HTTP_SERVER_KEEP_ALIVE_ENABLE (1)
+#else
+#define HTTP_SERVER_KEEP_ALIVE_ENABLE (0)
+#endif
+
+#if defined(CONFIG_WIFI_MANAGER_HTTP_SERVER_KEEP_ALIVE_IDLE_TIMEOUT_MS)
+#define HTTP_SERVER_KEEP_ALIVE_IDLE_TIMEOUT_MS (CONFIG_WIFI_MANAGER_HTTP_SERVER_KEEP_ALIVE_IDLE_TIMEOUT_MS)
+#else
+#define HTTP_SERVER_KEEP_ALIVE_IDLE_TIMEOUT_MS (5000)
+#endif
+
+#if defined(CONFIG_WIFI_MANAGER_HTTP_SERVER_KEEP_ALIVE_MAX_REQUESTS)
+#define HTTP_SERVER_KEEP_ALIVE_MAX_REQUESTS (CONFIG_WIFI_MANAGER_HTTP_SERVER_KEEP_ALIVE_MAX_REQUESTS)
+#else
+#define HTTP_SERVER_KEEP_ALIVE_MAX_REQUESTS (100)
+#endif
+
+#if defined(CONFIG_WIFI_MANAGER_HTTP_SERVER_MUX)
+#define HTTP_SERVER_MUX_ENABLE (1)
+#else
+#define HTTP_SERVER_MUX_ENABLE (0)
+#endif
+
+#if defined(CONFIG_WIFI_MANAGER_HTTP_SERVER_MUX_MAX_CONNS)
+#define HTTP_SERVER_MUX_MAX_CONNS (CONFIG_WIFI_MANAGER_HTTP_SERVER_MUX_MAX_CONNS)
+#else
+#define HTTP_SERVER_MUX_MAX_CONNS (4)
+#endif
+
+#if HTTP_SERVER_MUX_ENABLE
+// In the multiplexed mode all connections are served by the HTTP server task itself
+#define HTTP_SERVER_NUM_WORKERS (0)
+#elif defined(CONFIG_WIFI_MANAGER_HTTP_SERVER_NUM_WORKERS)
+#define HTTP_SERVER_NUM_WORKERS (CONFIG_WIFI_MANAGER_HTTP_SERVER_NUM_WORKERS)
+#else
+#define HTTP_SERVER_NUM_WORKERS (2)
+#endif
+
+#if defined(CONFIG_WIFI_MANAGER_HTTP_SERVER_WORKER_STACK_SIZE)
+#define HTTP_SERVER_WORKER_STACK_SIZE (CONFIG_WIFI_MANAGER_HTTP_SERVER_WORKER_STACK_SIZE)
+#else
+#define HTTP_SERVER_WORKER_STACK_SIZE (7680)
+#endif
+
+#if defined(CONFIG_WIFI_MANAGER_HTTP_SERVER_CONN_QUEUE_LEN)
+#define HTTP_SERVER_CONN_QUEUE_LEN (CONFIG_WIFI_MANAGER_HTTP_SERVER_CONN_QUEUE_LEN)
+#else
+#define HTTP_SERVER_CONN_QUEUE_LEN (4)
+#endif
+
+#if defined(CONFIG_WIFI_MANAGER_HTTP_SERVER_MAX_APP_ROUTES)
+#define HTTP_SERVER_MAX_APP_ROUTES (CONFIG_WIFI_MANAGER_HTTP_SERVER_MAX_APP_ROUTES)
+#else
+#define HTTP_SERVER_MAX_APP_ROUTES (16)
+#endif
+
+#if defined(CONFIG_WIFI_MANAGER_HTTP_SERVER_REQ_ARENA_SIZE)
+#define HTTP_SERVER_REQ_ARENA_SIZE (CONFIG_WIFI_MANAGER_HTTP_SERVER_REQ_ARENA_SIZE)
+#else
+#define HTTP_SERVER_REQ_ARENA_SIZE (4096)
+#endif
+
+#if defined(CONFIG_WIFI_MANAGER_HTTP_SERVER_REQ_ARENA_CJSON_HOOKS)
+#define HTTP_SERVER_REQ_ARENA_CJSON_HOOKS (1)
+#else
+#define HTTP_SERVER_REQ_ARENA_CJSON_HOOKS (0)
+#endif
+
+#if defined(CONFIG_WIFI_MANAGER_HTTP_SERVER_CONN_POOL_SIZE)
+#define HTTP_SERVER_CONN_POOL_SIZE (CONFIG_WIFI_MANAGER_HTTP_SERVER_CONN_POOL_SIZE)
+#elif HTTP_SERVER_MUX_ENABLE
+#define HTTP_SERVER_CONN_POOL_SIZE (HTTP_SERVER_MUX_MAX_CONNS)
+#else
+#define HTTP_SERVER_CONN_POOL_SIZE (2)
+#endif
+
+#if defined(CONFIG_WIFI_MANAGER_HTTP_SERVER_CONN_REQ_BUF_SIZE)
+#define HTTP_SERVER_CONN_REQ_BUF_SIZE (CONFIG_WIFI_MANAGER_HTTP_SERVER_CONN_REQ_BUF_SIZE)
+#else
+#define HTTP_SERVER_CONN_REQ_BUF_SIZE (4096)
+#endif
+
+#if defined(CONFIG_WIFI_MANAGER_HTTP_SERVER_CONN_CHUNK_BUF_SIZE)
+#define HTTP_SERVER_CONN_CHUNK_BUF_SIZE (CONFIG_WIFI_MANAGER_HTTP_SERVER_CONN_CHUNK_BUF_SIZE)
+#else
+#define HTTP_SERVER_CONN_CHUNK_BUF_SIZE (4096)
+#endif
+
+#if defined(CONFIG_WIFI_MANAGER_HTTP_SERVER_CACHE_IMMUTABLE_MAX_AGE)
+#define HTTP_SERVER_CACHE_IMMUTABLE_MAX_AGE (CONFIG_WIFI_MANAGER_HTTP_SERVER_CACHE_IMMUTABLE_MAX_AGE)
+#else
+#define HTTP_SERVER_CACHE_IMMUTABLE_MAX_AGE (31536000)
+#endif
+
+#if defined(CONFIG_WIFI_MANAGER_HTTP_SERVER_CACHE_FINGERPRINT_MIN_LEN)
+#define HTTP_SERVER_CACHE_FINGERPRINT_MIN_LEN (CONFIG_WIFI_MANAGER_HTTP_SERVER_CACHE_FINGERPRINT_MIN_LEN)
+#else
+#define HTTP_SERVER_CACHE_FINGERPRINT_MIN_LEN (8)
+#endif
+
+#if defined(CONFIG_WIFI_MANAGER_HTTP_SERVER_DEFLATE)
+#define HTTP_SERVER_DEFLATE_ENABLE (1)
+#else
+#define HTTP_SERVER_DEFLATE_ENABLE (0)
+#endif
+
+#if defined(CONFIG_WIFI_MANAGER_HTTP_SERVER_DEFLATE_WINDOW_BITS)
+#define HTTP_SERVER_DEFLATE_WINDOW_BITS (CONFIG_WIFI_MANAGER_HTTP_SERVER_DEFLATE_WINDOW_BITS)
+#else
+#define HTTP_SERVER_DEFLATE_WINDOW_BITS (10)
+#endif
+
+#if defined(CONFIG_WIFI_MANAGER_HTTP_SERVER_DEFLATE_MIN_LEN)
+#define HTTP_SERVER_DEFLATE_MIN_LEN (CONFIG_WIFI_MANAGER_HTTP_SERVER_DEFLATE_MIN_LEN)
+#else
+#define HTTP_SERVER_DEFLATE_MIN_LEN (1024)
+#endif
+
+#ifdef __cplusplus
+}
+#endif
+
+#endif // RUUVI_ESP_WIFI_MANAGER_HTTP_SERVER_CFG_H
@@ -0,0 +1,104 @@
+/**
+ * @file http_server_conn_pool.c
+ * @author TheSomeMan
+ * @date 2026-10-17
+ * @copyright Ruuvi Innovations Ltd, license BSD-3-Clause.
+ */
+
+#include "http_server_conn_pool.h"
+#include <assert.h>
+#include "os_mutex.h"
+#include "esp_type_wrapper.h"
+#include "http_server.h"
+#include "http_server_cfg.h"
+
+#define LOG_LOCAL_LEVEL LOG_LEVEL_INFO
+#include "log.h"
+
+static const char TAG[] = "http_server";
+
+static os_mutex_static_t g_http_server_conn_pool_mutex_mem;
+static os_mutex_t        g_http_server_conn_pool_mutex;
+
+static http_server_conn_ctx_t g_http_server_conn_pool_ctx[HTTP_SERVER_CONN_POOL_SIZE];
+static bool                   g_http_server_conn_pool_is_used[HTTP_SERVER_CONN_POOL_SIZE];
+static char                   g_http_server_conn_pool_req_buf[HTTP_SERVER_CONN_POOL_SIZE][HTTP_SERVER_REQ_BUF_SIZE];
+static uint8_t g_http_server_conn_pool_chunk_buf[HTTP_SERVER_CONN_POOL_SIZE][HTTP_SERVER_CONN_CHUNK_BUF_SIZE];
+
+static uint32_t g_http_server_conn_pool_num_used;
+static uint32_t g_http_server_conn_pool_num_used_max;
+static uint32_t g_http_server_conn_pool_cnt_exhausted;
+
+void
+http_server_conn_pool_init(void)
+{
+    if (NULL != g_http_server_conn_pool_mutex)
+    {
+        return;
+    }
+    g_http_server_conn_pool_mutex = os_mutex_create_static(&g_http_server_conn_pool_mutex_mem);
+    for (uint32_t i = 0; i < HTTP_SERVER_CONN_POOL_SIZE; ++i)
+    {
+        http_server_conn_ctx_t* const p_ctx = &g_http_server_conn_pool_ctx[i];
+        p_ctx->p_lin_buf                    = &g_http_server_conn_pool_req_buf[i][0];
+        p_ctx->writer.p_chunk_buf           = &g_http_server_conn_pool_chunk_buf[i][0];
+        g_http_server_conn_pool_is_used[i]  = false;
+    }
+}
+
+http_server_conn_ctx_t*
+http_server_conn_pool_acquire(void)
+{
+    http_server_conn_ctx_t* p_ctx = NULL;
+    os_mutex_lock(g_http_server_conn_pool_mutex);
+    for (uint32_t i = 0; i < HTTP_SERVER_CONN_POOL_SIZE; ++i)
+    {
+        if (!g_http_server_conn_pool_is_used[i])
+        {
+            g_http_server_conn_pool_is_used[i] = true;
+            p_ctx                              = &g_http_server_conn_pool_ctx[i];
+            break;
+        }
+    }
+    if (NULL != p_ctx)
+    {
+        g_http_server_conn_pool_num_used += 1;
+        if (g_http_server_conn_pool_num_used > g_http_server_conn_pool_num_used_max)
+        {
+            g_http_server_conn_pool_num_used_max = g_http_server_conn_pool_num_used;
+        }
+    }
+    else
+    {
+        g_http_server_conn_pool_cnt_exhausted += 1;
+    }
+    os_mutex_unlock(g_http_server_conn_pool_mutex);
+    if (NULL == p_ctx)
+    {
+        LOG_WARN("All %u connection contexts are in use", (printf_uint_t)HTTP_SERVER_CONN_POOL_SIZE);
+    }
+    return p_ctx;
+}
+
+void
+http_server_conn_pool_release(http_server_conn_ctx_t* const p_ctx)
+{
+    const ptrdiff_t idx = p_ctx - &g_http_server_conn_pool_ctx[0];
+    assert((idx >= 0) && (idx < HTTP_SERVER_CONN_POOL_SIZE));
+    os_mutex_lock(g_http_server_conn_pool_mutex);
+    assert(g_http_server_conn_pool_is_used[idx]);
+    g_http_server_conn_pool_is_used[idx] = false;
+    g_http_server_conn_pool_num_used -= 1;
+    os_mutex_unlock(g_http_server_conn_pool_mutex);
+}
+
+void
+http_server_get_conn_pool_stat(http_server_conn_pool_stat_t* const p_stat)
+{
+    os_mutex_lock(g_http_server_conn_pool_mutex);
+    p_stat->pool_size     = HTTP_SERVER_CONN_POOL_SIZE;
+    p_stat->num_used      = g_http_server_conn_pool_num_used;
+    p_stat->num_used_max  = g_http_server_conn_pool_num_used_max;
+    p_stat->cnt_exhausted = g_http_server_conn_pool_cnt_exhausted;
+    os_mutex_unlock(g_http_server_conn_pool_mutex);
+}
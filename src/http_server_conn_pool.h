@@ -0,0 +1,43 @@
+/**
+ * @file http_server_conn_pool.h
+ * @author TheSomeMan
+ * @date 2026-10-17
+ * @copyright Ruuvi Innovations Ltd, license BSD-3-Clause.
+ */
+
+#ifndef RUUVI_ESP_WIFI_MANAGER_HTTP_SERVER_CONN_POOL_H
+#define RUUVI_ESP_WIFI_MANAGER_HTTP_SERVER_CONN_POOL_H
+
+#include "http_server_accept_and_handle_conn.h"
+
+#ifdef __cplusplus
+extern "C" {
+#endif
+
+/**
+ * @brief Create the mutex of the pool and assign the statically allocated buffers to the connection contexts.
+ * @note This function should be called once from http_server_init.
+ */
+void
+http_server_conn_pool_init(void);
+
+/**
+ * @brief Take a free connection context from the pool.
+ * @note The request buffer and the response buffer are assigned to the context once by http_server_conn_pool_init,
+ *       they are kept by http_server_conn_ctx_init.
+ * @return ptr to the connection context or NULL if all the contexts are in use.
+ */
+http_server_conn_ctx_t*
+http_server_conn_pool_acquire(void);
+
+/**
+ * @brief Return the connection context to the pool (it must be deinitialized by http_server_conn_ctx_deinit).
+ */
+void
+http_server_conn_pool_release(http_server_conn_ctx_t* const p_ctx);
+
+#ifdef __cplusplus
+}
+#endif
+
+#endif // RUUVI_ESP_WIFI_MANAGER_HTTP_SERVER_CONN_POOL_H
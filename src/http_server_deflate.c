@@ -0,0 +1,432 @@
+/**
+ * @file http_server_deflate.c
+ * @author TheSomeMan
+ * @date 2026-10-17
+ * @copyright Ruuvi Innovations Ltd, license BSD-3-Clause.
+ */
+
+#include "http_server_deflate.h"
+#include <string.h>
+
+#define HTTP_SERVER_DEFLATE_MIN_MATCH (3U)
+#define HTTP_SERVER_DEFLATE_MAX_MATCH (258U)
+#define HTTP_SERVER_DEFLATE_MAX_CHAIN (16U)
+#define HTTP_SERVER_DEFLATE_MAX_DIST  (32768U)
+
+#define HTTP_SERVER_DEFLATE_SYM_END_OF_BLOCK (256U)
+#define HTTP_SERVER_DEFLATE_SYM_FIRST_LEN    (257U)
+
+#define HTTP_SERVER_DEFLATE_NUM_LEN_CODES  (29U)
+#define HTTP_SERVER_DEFLATE_NUM_DIST_CODES (30U)
+#define HTTP_SERVER_DEFLATE_DIST_CODE_BITS (5U)
+
+#define HTTP_SERVER_DEFLATE_GZIP_HDR_LEN     (10U)
+#define HTTP_SERVER_DEFLATE_GZIP_TRAILER_LEN (8U)
+
+#define HTTP_SERVER_DEFLATE_CRC32_INIT (0xFFFFFFFFU)
+
+#define HTTP_SERVER_DEFLATE_HASH_MULTIPLIER (2654435761U)
+
+#define BITS_PER_BYTE (8U)
+#define BYTE_MASK     (0xFFU)
+
+_Static_assert(
+    HTTP_SERVER_DEFLATE_WINDOW_SIZE >= (2U * HTTP_SERVER_DEFLATE_MAX_MATCH),
+    "The window of the compressor is too small");
+
+_Static_assert(
+    (2U * HTTP_SERVER_DEFLATE_WINDOW_SIZE) <= HTTP_SERVER_DEFLATE_MAX_DIST,
+    "The window of the compressor is too large for deflate or for 16-bit hash chains");
+
+// 10-byte gzip header: ID1, ID2, CM=deflate, FLG=0, MTIME=0, XFL=0, OS=unknown
+static const uint8_t g_http_server_deflate_gzip_hdr[HTTP_SERVER_DEFLATE_GZIP_HDR_LEN] = {
+    0x1F, 0x8B, 0x08, 0x00, 0x00, 0x00, 0x00, 0x00, 0x00, 0xFF,
+};
+
+static const uint16_t g_http_server_deflate_len_base[HTTP_SERVER_DEFLATE_NUM_LEN_CODES] = {
+    3, 4, 5, 6, 7, 8, 9, 10, 11, 13, 15, 17, 19, 23, 27, 31, 35, 43, 51, 59, 67, 83, 99, 115, 131, 163, 195, 227, 258,
+};
+
+static const uint8_t g_http_server_deflate_len_extra[HTTP_SERVER_DEFLATE_NUM_LEN_CODES] = {
+    0, 0, 0, 0, 0, 0, 0, 0, 1, 1, 1, 1, 2, 2, 2, 2, 3, 3, 3, 3, 4, 4, 4, 4, 5, 5, 5, 5, 0,
+};
+
+static const uint16_t g_http_server_deflate_dist_base[HTTP_SERVER_DEFLATE_NUM_DIST_CODES] = {
+    1,   2,   3,   4,   5,   7,    9,    13,   17,   25,   33,   49,   65,    97,    129,
+    193, 257, 385, 513, 769, 1025, 1537, 2049, 3073, 4097, 6145, 8193, 12289, 16385, 24577,
+};
+
+static const uint8_t g_http_server_deflate_dist_extra[HTTP_SERVER_DEFLATE_NUM_DIST_CODES] = {
+    0, 0, 0, 0, 1, 1, 2, 2, 3, 3, 4, 4, 5, 5, 6, 6, 7, 7, 8, 8, 9, 9, 10, 10, 11, 11, 12, 12, 13, 13,
+};
+
+// CRC-32 (IEEE 802.3, reflected) with the table for 4 bits to save RAM and flash
+static const uint32_t g_http_server_deflate_crc32_table[16] = {
+    0x00000000U, 0x1DB71064U, 0x3B6E20C8U, 0x26D930ACU, 0x76DC4190U, 0x6B6B51F4U, 0x4DB26158U, 0x5005713CU,
+    0xEDB88320U, 0xF00F9344U, 0xD6D6A3E8U, 0xCB61B38CU, 0x9B64C2B0U, 0x86D3D2D4U, 0xA00AE278U, 0xBDBDF21CU,
+};
+
+static uint32_t
+http_server_deflate_crc32_update(uint32_t crc, const uint8_t* const p_buf, const size_t len)
+{
+    for (size_t i = 0; i < len; ++i)
+    {
+        crc ^= p_buf[i];
+        crc = (crc >> 4U) ^ g_http_server_deflate_crc32_table[crc & 0x0FU];
+        crc = (crc >> 4U) ^ g_http_server_deflate_crc32_table[crc & 0x0FU];
+    }
+    return crc;
+}
+
+void
+http_server_deflate_init(http_server_deflate_t* const p_deflate)
+{
+    memset(p_deflate, 0, sizeof(*p_deflate));
+    p_deflate->crc = HTTP_SERVER_DEFLATE_CRC32_INIT;
+}
+
+/**
+ * @brief Append the bits to the output, the bits are packed starting from the least significant bit.
+ * @note The caller checks that there is HTTP_SERVER_DEFLATE_OUT_MARGIN bytes free in the output buffer.
+ */
+static void
+http_server_deflate_put_bits(
+    http_server_deflate_t* const p_deflate,
+    const uint32_t               bits,
+    const uint32_t               num_bits,
+    uint8_t* const               p_out,
+    size_t* const                p_out_len)
+{
+    p_deflate->bit_buf |= bits << p_deflate->bit_cnt;
+    p_deflate->bit_cnt += num_bits;
+    while (p_deflate->bit_cnt >= BITS_PER_BYTE)
+    {
+        p_out[*p_out_len] = (uint8_t)(p_deflate->bit_buf & BYTE_MASK);
+        *p_out_len += 1;
+        p_deflate->bit_buf >>= BITS_PER_BYTE;
+        p_deflate->bit_cnt -= BITS_PER_BYTE;
+    }
+}
+
+/**
+ * @brief Append the Huffman code, it's packed starting from the most significant bit.
+ */
+static void
+http_server_deflate_put_code(
+    http_server_deflate_t* const p_deflate,
+    const uint32_t               code,
+    const uint32_t               num_bits,
+    uint8_t* const               p_out,
+    size_t* const                p_out_len)
+{
+    uint32_t reversed = 0;
+    for (uint32_t i = 0; i < num_bits; ++i)
+    {
+        reversed |= ((code >> i) & 1U) << (num_bits - 1U - i);
+    }
+    http_server_deflate_put_bits(p_deflate, reversed, num_bits, p_out, p_out_len);
+}
+
+/**
+ * @brief Append the literal or the length symbol encoded with the fixed Huffman code (RFC 1951, 3.2.6).
+ */
+static void
+http_server_deflate_put_lit_len_sym(
+    http_server_deflate_t* const p_deflate,
+    const uint32_t               sym,
+    uint8_t* const               p_out,
+    size_t* const                p_out_len)
+{
+    if (sym <= 143U)
+    {
+        http_server_deflate_put_code(p_deflate, 0x30U + sym, 8U, p_out, p_out_len);
+    }
+    else if (sym <= 255U)
+    {
+        http_server_deflate_put_code(p_deflate, 0x190U + (sym - 144U), 9U, p_out, p_out_len);
+    }
+    else if (sym <= 279U)
+    {
+        http_server_deflate_put_code(p_deflate, sym - 256U, 7U, p_out, p_out_len);
+    }
+    else
+    {
+        http_server_deflate_put_code(p_deflate, 0xC0U + (sym - 280U), 8U, p_out, p_out_len);
+    }
+}
+
+static void
+http_server_deflate_put_match(
+    http_server_deflate_t* const p_deflate,
+    const uint32_t               len,
+    const uint32_t               dist,
+    uint8_t* const               p_out,
+    size_t* const                p_out_len)
+{
+    uint32_t len_code = HTTP_SERVER_DEFLATE_NUM_LEN_CODES - 1U;
+    while (g_http_server_deflate_len_base[len_code] > len)
+    {
+        len_code -= 1;
+    }
+    http_server_deflate_put_lit_len_sym(p_deflate, HTTP_SERVER_DEFLATE_SYM_FIRST_LEN + len_code, p_out, p_out_len);
+    http_server_deflate_put_bits(
+        p_deflate,
+        len - g_http_server_deflate_len_base[len_code],
+        g_http_server_deflate_len_extra[len_code],
+        p_out,
+        p_out_len);
+
+    uint32_t dist_code = HTTP_SERVER_DEFLATE_NUM_DIST_CODES - 1U;
+    while (g_http_server_deflate_dist_base[dist_code] > dist)
+    {
+        dist_code -= 1;
+    }
+    http_server_deflate_put_code(p_deflate, dist_code, HTTP_SERVER_DEFLATE_DIST_CODE_BITS, p_out, p_out_len);
+    http_server_deflate_put_bits(
+        p_deflate,
+        dist - g_http_server_deflate_dist_base[dist_code],
+        g_http_server_deflate_dist_extra[dist_code],
+        p_out,
+        p_out_len);
+}
+
+static uint32_t
+http_server_deflate_hash(const uint8_t* const p_buf)
+{
+    const uint32_t val = ((uint32_t)p_buf[0] << 16U) | ((uint32_t)p_buf[1] << 8U) | (uint32_t)p_buf[2];
+    return (val * HTTP_SERVER_DEFLATE_HASH_MULTIPLIER) >> (32U - HTTP_SERVER_DEFLATE_HASH_BITS);
+}
+
+static void
+http_server_deflate_insert(http_server_deflate_t* const p_deflate, const size_t pos)
+{
+    if ((pos + HTTP_SERVER_DEFLATE_MIN_MATCH) > p_deflate->win_len)
+    {
+        return;
+    }
+    const uint32_t hash = http_server_deflate_hash(&p_deflate->win_buf[pos]);
+
+    p_deflate->hash_prev[pos & (HTTP_SERVER_DEFLATE_WINDOW_SIZE - 1U)] = p_deflate->hash_head[hash];
+    p_deflate->hash_head[hash]                                         = (uint16_t)(pos + 1U);
+}
+
+/**
+ * @brief Find the longest match for the current position in the chain of the previous positions with the same hash.
+ * @return the length of the match (0 if there is no match of HTTP_SERVER_DEFLATE_MIN_MATCH bytes).
+ */
+static uint32_t
+http_server_deflate_find_match(const http_server_deflate_t* const p_deflate, uint32_t* const p_dist)
+{
+    const size_t pos       = p_deflate->pos;
+    const size_t lookahead = p_deflate->win_len - pos;
+    const size_t max_len   = (lookahead < HTTP_SERVER_DEFLATE_MAX_MATCH) ? lookahead : HTTP_SERVER_DEFLATE_MAX_MATCH;
+    if (max_len < HTTP_SERVER_DEFLATE_MIN_MATCH)
+    {
+        return 0;
+    }
+    const uint8_t* const p_cur = &p_deflate->win_buf[pos];
+
+    uint32_t best_len  = 0;
+    size_t   prev_pos  = pos;
+    uint32_t candidate = p_deflate->hash_head[http_server_deflate_hash(p_cur)];
+    for (uint32_t i = 0; (i < HTTP_SERVER_DEFLATE_MAX_CHAIN) && (0 != candidate); ++i)
+    {
+        const size_t cand_pos = candidate - 1U;
+        // The slot of hash_prev could be reused for a newer position, so the chain must go strictly backwards
+        if (cand_pos >= prev_pos)
+        {
+            break;
+        }
+        prev_pos                    = cand_pos;
+        const uint8_t* const p_cand = &p_deflate->win_buf[cand_pos];
+
+        uint32_t len = 0;
+        while ((len < max_len) && (p_cand[len] == p_cur[len]))
+        {
+            len += 1;
+        }
+        if (len > best_len)
+        {
+            best_len = len;
+            *p_dist  = (uint32_t)(pos - cand_pos);
+            if (len == max_len)
+            {
+                break;
+            }
+        }
+        candidate = p_deflate->hash_prev[cand_pos & (HTTP_SERVER_DEFLATE_WINDOW_SIZE - 1U)];
+    }
+    return (best_len >= HTTP_SERVER_DEFLATE_MIN_MATCH) ? best_len : 0;
+}
+
+/**
+ * @brief Encode the buffered input while there is enough space in the output buffer.
+ * @param flag_flush - encode all the buffered input, otherwise keep HTTP_SERVER_DEFLATE_MAX_MATCH bytes
+ *                     of lookahead to find the longest matches when the next part of the input is added.
+ */
+static void
+http_server_deflate_process(
+    http_server_deflate_t* const p_deflate,
+    const bool                   flag_flush,
+    uint8_t* const               p_out,
+    const size_t                 out_size,
+    size_t* const                p_out_len)
+{
+    while (p_deflate->pos < p_deflate->win_len)
+    {
+        if ((!flag_flush) && ((p_deflate->win_len - p_deflate->pos) < HTTP_SERVER_DEFLATE_MAX_MATCH))
+        {
+            break;
+        }
+        if ((out_size - *p_out_len) < HTTP_SERVER_DEFLATE_OUT_MARGIN)
+        {
+            break;
+        }
+        uint32_t       dist = 0;
+        const uint32_t len  = http_server_deflate_find_match(p_deflate, &dist);
+        if (0 == len)
+        {
+            http_server_deflate_put_lit_len_sym(p_deflate, p_deflate->win_buf[p_deflate->pos], p_out, p_out_len);
+            http_server_deflate_insert(p_deflate, p_deflate->pos);
+            p_deflate->pos += 1;
+            continue;
+        }
+        http_server_deflate_put_match(p_deflate, len, dist, p_out, p_out_len);
+        for (uint32_t i = 0; i < len; ++i)
+        {
+            http_server_deflate_insert(p_deflate, p_deflate->pos + i);
+        }
+        p_deflate->pos += len;
+    }
+}
+
+static uint16_t
+http_server_deflate_slide_pos(const uint16_t val)
+{
+    return (val > HTTP_SERVER_DEFLATE_WINDOW_SIZE) ? (uint16_t)(val - HTTP_SERVER_DEFLATE_WINDOW_SIZE) : 0U;
+}
+
+/**
+ * @brief Discard the older half of the window to make space for the next part of the input.
+ */
+static void
+http_server_deflate_slide_window(http_server_deflate_t* const p_deflate)
+{
+    memmove(
+        &p_deflate->win_buf[0],
+        &p_deflate->win_buf[HTTP_SERVER_DEFLATE_WINDOW_SIZE],
+        p_deflate->win_len - HTTP_SERVER_DEFLATE_WINDOW_SIZE);
+    p_deflate->win_len -= HTTP_SERVER_DEFLATE_WINDOW_SIZE;
+    p_deflate->pos -= HTTP_SERVER_DEFLATE_WINDOW_SIZE;
+    for (uint32_t i = 0; i < HTTP_SERVER_DEFLATE_HASH_SIZE; ++i)
+    {
+        p_deflate->hash_head[i] = http_server_deflate_slide_pos(p_deflate->hash_head[i]);
+    }
+    for (uint32_t i = 0; i < HTTP_SERVER_DEFLATE_WINDOW_SIZE; ++i)
+    {
+        p_deflate->hash_prev[i] = http_server_deflate_slide_pos(p_deflate->hash_prev[i]);
+    }
+}
+
+/**
+ * @brief Write the gzip header and the header of the single block with the fixed Huffman codes.
+ * @return false if there is not enough space in the output buffer.
+ */
+static bool
+http_server_deflate_start(
+    http_server_deflate_t* const p_deflate,
+    uint8_t* const               p_out,
+    const size_t                 out_size,
+    size_t* const                p_out_len)
+{
+    if (p_deflate->flag_started)
+    {
+        return true;
+    }
+    if ((out_size - *p_out_len) < (HTTP_SERVER_DEFLATE_GZIP_HDR_LEN + HTTP_SERVER_DEFLATE_OUT_MARGIN))
+    {
+        return false;
+    }
+    memcpy(&p_out[*p_out_len], g_http_server_deflate_gzip_hdr, sizeof(g_http_server_deflate_gzip_hdr));
+    *p_out_len += sizeof(g_http_server_deflate_gzip_hdr);
+    // BFINAL=1, BTYPE=01 (fixed Huffman codes)
+    http_server_deflate_put_bits(p_deflate, 1U, 1U, p_out, p_out_len);
+    http_server_deflate_put_bits(p_deflate, 1U, 2U, p_out, p_out_len);
+    p_deflate->flag_started = true;
+    return true;
+}
+
+size_t
+http_server_deflate_write(
+    http_server_deflate_t* const p_deflate,
+    const uint8_t* const         p_in,
+    const size_t                 in_len,
+    size_t* const                p_in_consumed,
+    uint8_t* const               p_out,
+    const size_t                 out_size)
+{
+    size_t out_len  = 0;
+    size_t consumed = 0;
+    if (http_server_deflate_start(p_deflate, p_out, out_size, &out_len))
+    {
+        for (;;)
+        {
+            http_server_deflate_process(p_deflate, false, p_out, out_size, &out_len);
+            if ((consumed == in_len) || ((out_size - out_len) < HTTP_SERVER_DEFLATE_OUT_MARGIN))
+            {
+                break;
+            }
+            if ((sizeof(p_deflate->win_buf) == p_deflate->win_len)
+                && (p_deflate->pos >= HTTP_SERVER_DEFLATE_WINDOW_SIZE))
+            {
+                http_server_deflate_slide_window(p_deflate);
+            }
+            const size_t free_len = sizeof(p_deflate->win_buf) - p_deflate->win_len;
+            const size_t len      = ((in_len - consumed) < free_len) ? (in_len - consumed) : free_len;
+            memcpy(&p_deflate->win_buf[p_deflate->win_len], &p_in[consumed], len);
+            p_deflate->crc = http_server_deflate_crc32_update(p_deflate->crc, &p_in[consumed], len);
+            p_deflate->win_len += len;
+            consumed += len;
+        }
+    }
+    p_deflate->total_in += consumed;
+    p_deflate->total_out += out_len;
+    *p_in_consumed = consumed;
+    return out_len;
+}
+
+static void
+http_server_deflate_put_uint32_le(uint8_t* const p_out, size_t* const p_out_len, const uint32_t val)
+{
+    for (uint32_t i = 0; i < sizeof(val); ++i)
+    {
+        p_out[*p_out_len] = (uint8_t)((val >> (i * BITS_PER_BYTE)) & BYTE_MASK);
+        *p_out_len += 1;
+    }
+}
+
+size_t
+http_server_deflate_finish(http_server_deflate_t* const p_deflate, uint8_t* const p_out, const size_t out_size)
+{
+    size_t out_len = 0;
+    if (p_deflate->flag_finished || (!http_server_deflate_start(p_deflate, p_out, out_size, &out_len)))
+    {
+        return out_len;
+    }
+    http_server_deflate_process(p_deflate, true, p_out, out_size, &out_len);
+    if ((p_deflate->pos == p_deflate->win_len)
+        && ((out_size - out_len) >= (HTTP_SERVER_DEFLATE_GZIP_TRAILER_LEN + HTTP_SERVER_DEFLATE_OUT_MARGIN)))
+    {
+        http_server_deflate_put_lit_len_sym(p_deflate, HTTP_SERVER_DEFLATE_SYM_END_OF_BLOCK, p_out, &out_len);
+        if (0 != p_deflate->bit_cnt)
+        {
+            // Pad the last byte with zero bits
+            http_server_deflate_put_bits(p_deflate, 0, BITS_PER_BYTE - p_deflate->bit_cnt, p_out, &out_len);
+        }
+        http_server_deflate_put_uint32_le(p_out, &out_len, p_deflate->crc ^ HTTP_SERVER_DEFLATE_CRC32_INIT);
+        http_server_deflate_put_uint32_le(p_out, &out_len, (uint32_t)p_deflate->total_in);
+        p_deflate->flag_finished = true;
+    }
+    p_deflate->total_out += out_len;
+    return out_len;
+}
@@ -0,0 +1,91 @@
+/**
+ * @file http_server_deflate.h
+ * @author TheSomeMan
+ * @date 2026-10-17
+ * @copyright Ruuvi Innovations Ltd, license BSD-3-Clause.
+ */
+
+#ifndef RUUVI_ESP_WIFI_MANAGER_HTTP_SERVER_DEFLATE_H
+#define RUUVI_ESP_WIFI_MANAGER_HTTP_SERVER_DEFLATE_H
+
+#include <stdbool.h>
+#include <stddef.h>
+#include <stdint.h>
+#include "http_server_cfg.h"
+
+#ifdef __cplusplus
+extern "C" {
+#endif
+
+#define HTTP_SERVER_DEFLATE_WINDOW_SIZE (1U << HTTP_SERVER_DEFLATE_WINDOW_BITS)
+#define HTTP_SERVER_DEFLATE_HASH_BITS   (HTTP_SERVER_DEFLATE_WINDOW_BITS - 1U)
+#define HTTP_SERVER_DEFLATE_HASH_SIZE   (1U << HTTP_SERVER_DEFLATE_HASH_BITS)
+
+/**
+ * The compressor emits the next symbol only if there is at least this number of bytes free in the output buffer,
+ * it's enough for the longest symbol (length and distance with the extra bits), the gzip header or the trailer.
+ */
+#define HTTP_SERVER_DEFLATE_OUT_MARGIN (16U)
+
+/**
+ * @brief The state of the streaming gzip compressor.
+ * @note The input is compressed with LZ77 in the sliding window of HTTP_SERVER_DEFLATE_WINDOW_SIZE bytes
+ *       and encoded in a single block with the fixed Huffman codes, so no memory is needed for the dynamic trees.
+ */
+typedef struct http_server_deflate_t
+{
+    uint8_t  win_buf[2U * HTTP_SERVER_DEFLATE_WINDOW_SIZE]; // History and the input which is not compressed yet
+    uint16_t hash_head[HTTP_SERVER_DEFLATE_HASH_SIZE];      // Last position + 1 for each hash (0 if none)
+    uint16_t hash_prev[HTTP_SERVER_DEFLATE_WINDOW_SIZE];    // Previous position + 1 with the same hash
+    size_t   win_len;                                       // Number of bytes in win_buf
+    size_t   pos;                                           // First byte in win_buf which is not compressed yet
+    uint32_t bit_buf;                                       // Bits which are not written to the output yet
+    uint32_t bit_cnt;                                       // Number of bits in bit_buf
+    uint32_t crc;                                           // CRC-32 of the input
+    size_t   total_in;                                      // Number of bytes of the input consumed by the compressor
+    size_t   total_out;                                     // Number of bytes written to the output
+    bool     flag_started;                                  // The gzip header has been written
+    bool     flag_finished;                                 // The gzip trailer has been written
+} http_server_deflate_t;
+
+/**
+ * @brief Init the state of the compressor.
+ */
+void
+http_server_deflate_init(http_server_deflate_t* const p_deflate);
+
+/**
+ * @brief Compress the next part of the input.
+ * @note The input can be consumed partly if the output buffer is full,
+ *       the output buffer must be at least HTTP_SERVER_DEFLATE_OUT_MARGIN bytes to make progress.
+ * @param p_in - ptr to the input
+ * @param in_len - length of the input
+ * @param[out] p_in_consumed - the number of bytes of the input which were consumed
+ * @param p_out - ptr to the output buffer
+ * @param out_size - size of the output buffer
+ * @return the number of bytes written to the output buffer.
+ */
+size_t
+http_server_deflate_write(
+    http_server_deflate_t* const p_deflate,
+    const uint8_t* const         p_in,
+    const size_t                 in_len,
+    size_t* const                p_in_consumed,
+    uint8_t* const               p_out,
+    const size_t                 out_size);
+
+/**
+ * @brief Compress the rest of the input and write the end of the stream.
+ * @note It should be called until p_deflate->flag_finished is set.
+ * @param p_out - ptr to the output buffer
+ * @param out_size - size of the output buffer
+ * @return the number of bytes written to the output buffer.
+ */
+size_t
+http_server_deflate_finish(http_server_deflate_t* const p_deflate, uint8_t* const p_out, const size_t out_size);
+
+#ifdef __cplusplus
+}
+#endif
+
+#endif // RUUVI_ESP_WIFI_MANAGER_HTTP_SERVER_DEFLATE_H
@@ -14,7 +14,7 @@
 #include "mbedtls/aes.h"
 #include "cJSON.h"
 #include "esp_type_wrapper.h"
-#include "os_malloc.h"
+#include "http_server_arena.h"
 #include "wifi_manager_defs.h"
 
 #define LOG_LOCAL_LEVEL LOG_LEVEL_INFO
@@ -212,7 +212,7 @@ http_server_ecdh_b64_decode(const char* const p_b64_str, http_server_ecdh_array_
         return false;
     }
 
-    p_arr_buf->p_buf = os_malloc(olen);
+    p_arr_buf->p_buf = http_server_arena_malloc(olen);
     if (NULL == p_arr_buf->p_buf)
     {
         LOG_ERR("Can't allocate %u bytes for encrypted buffer", (printf_uint_t)olen);
@@ -230,7 +230,7 @@ http_server_ecdh_b64_decode(const char* const p_b64_str, http_server_ecdh_array_
             strlen(p_b64_str)))
     {
         LOG_ERR("%s failed", "mbedtls_base64_decode");
-        os_free(p_arr_buf->p_buf);
+        http_server_arena_free(p_arr_buf->p_buf);
         p_arr_buf->p_buf = NULL;
         return false;
     }
@@ -353,7 +353,7 @@ http_server_ecdh_handshake(
     const http_server_ecdh_pub_key_b64_t* const p_pub_key_b64_cli,
     http_server_ecdh_pub_key_b64_t* const       p_pub_key_b64_srv)
 {
-    http_server_ecdh_handshake_tmp_buffers_t* p_tmp_buf = os_calloc(1, sizeof(*p_tmp_buf));
+    http_server_ecdh_handshake_tmp_buffers_t* p_tmp_buf = http_server_arena_calloc(1, sizeof(*p_tmp_buf));
     if (NULL == p_tmp_buf)
     {
         LOG_ERR("Can't allocate memory");
@@ -362,7 +362,7 @@ http_server_ecdh_handshake(
 
     const bool res = http_server_ecdh_handshake_internal(p_pub_key_b64_cli, p_pub_key_b64_srv, p_tmp_buf);
 
-    os_free(p_tmp_buf);
+    http_server_arena_free(p_tmp_buf);
 
     return res;
 }
@@ -441,30 +441,30 @@ http_server_ecdh_decrypt(const http_server_ecdh_encrypted_req_t* const p_enc_req
     if ((buf_size % HTTP_SERVER_ECDH_AES_BLOCK_SIZE) != 0)
     {
         LOG_ERR("Encrypted buf length is not multiple of 16");
-        os_free(encrypted_arr_buf.p_buf);
+        http_server_arena_free(encrypted_arr_buf.p_buf);
         return false;
     }
 
     http_server_ecdh_array_buf_t decrypted_arr_buf = {
-        .p_buf    = os_malloc(buf_size),
+        .p_buf    = http_server_arena_malloc(buf_size),
         .buf_size = buf_size,
     };
     if (NULL == decrypted_arr_buf.p_buf)
     {
         LOG_ERR("Can't allocate %u bytes for decrypted buf", (printf_uint_t)(buf_size + 1));
-        os_free(encrypted_arr_buf.p_buf);
+        http_server_arena_free(encrypted_arr_buf.p_buf);
         return false;
     }
     if (!http_server_ecdh_aes_decrypt(&encrypted_arr_buf, &aes_iv, &decrypted_arr_buf))
     {
         LOG_ERR("Failed to decrypt");
-        os_free(encrypted_arr_buf.p_buf);
-        os_free(decrypted_arr_buf.p_buf);
+        http_server_arena_free(encrypted_arr_buf.p_buf);
+        http_server_arena_free(decrypted_arr_buf.p_buf);
         return false;
     }
     LOG_DUMP_DBG(decrypted_arr_buf.p_buf, decrypted_arr_buf.buf_size, "Decrypted:");
 
-    os_free(encrypted_arr_buf.p_buf);
+    http_server_arena_free(encrypted_arr_buf.p_buf);
 
     http_server_ecdh_sha256_t hash_sha256 = { 0 };
     http_server_ecdh_calc_sha256(decrypted_arr_buf.p_buf, decrypted_arr_buf.buf_size, &hash_sha256);
@@ -473,12 +473,12 @@ http_server_ecdh_decrypt(const http_server_ecdh_encrypted_req_t* const p_enc_req
     if (0 != memcmp(hash_sha256.buf, hash_expected.buf, sizeof(hash_sha256.buf)))
     {
         LOG_ERR("Hashes does not match");
-        os_free(decrypted_arr_buf.p_buf);
+        http_server_arena_free(decrypted_arr_buf.p_buf);
         return false;
     }
 
     *p_str_buf = str_buf_printf_with_alloc("%.*s", (printf_int_t)decrypted_arr_buf.buf_size, decrypted_arr_buf.p_buf);
-    os_free(decrypted_arr_buf.p_buf);
+    http_server_arena_free(decrypted_arr_buf.p_buf);
     if (NULL == p_str_buf->buf)
     {
         LOG_ERR("Failed to create decrypted_str_buf");
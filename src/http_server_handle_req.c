@@ -23,6 +23,9 @@
 #include "http_server_handle_req_post_auth.h"
 #include "http_server_handle_req_delete_auth.h"
 #include "http_server_ecdh.h"
+#include "http_server_arena.h"
+#include "http_server_mutex.h"
+#include "http_server_route_internal.h"
 #include "dns_server.h"
 
 #define LOG_LOCAL_LEVEL LOG_LEVEL_INFO
@@ -36,8 +39,9 @@ static const char TAG[] = "http_server";
 
 typedef struct http_server_gen_resp_status_json_param_t
 {
-    http_server_resp_t* const p_http_resp;
-    bool                      flag_access_from_lan;
+    http_server_resp_t* const             p_http_resp;
+    http_server_resp_status_json_t* const p_resp_status_json;
+    bool                                  flag_access_from_lan;
 } http_server_gen_resp_status_json_param_t;
 
 typedef struct wifi_ssid_password_t
@@ -48,8 +52,6 @@ typedef struct wifi_ssid_password_t
     wifiman_wifi_password_t password;
 } wifi_ssid_password_t;
 
-static http_server_resp_status_json_t g_resp_status_json;
-
 static void
 http_server_gen_resp_status_json(const json_network_info_t* const p_info, void* const p_param)
 {
@@ -62,177 +64,252 @@ http_server_gen_resp_status_json(const json_network_info_t* const p_info, void*
     }
     else
     {
-        json_network_info_do_generate_internal(p_info, &g_resp_status_json);
-        LOG_DBG("status.json: %s", g_resp_status_json.buf);
-        *p_params->p_http_resp = http_server_resp_200_json(g_resp_status_json.buf);
+        json_network_info_do_generate_internal(p_info, p_params->p_resp_status_json);
+        LOG_DBG("status.json: %s", p_params->p_resp_status_json->buf);
+        *p_params->p_http_resp = http_server_resp_200_json(p_params->p_resp_status_json->buf);
     }
 }
 
-static http_server_resp_t
-http_server_handle_req_get(
-    const char* const                           p_file_name_unchecked,
+/**
+ * @brief Check the access to the route according to its policy.
+ * @param[out] p_resp - the response which is sent if the access is denied
+ * @return true if the access is allowed.
+ */
+static bool
+http_server_handle_req_check_access(
+    const http_server_route_t* const            p_route,
     const http_server_handle_req_param_t* const p_param,
-    http_header_extra_fields_t* const           p_extra_header_fields)
+    const wifiman_hostinfo_t* const             p_hostinfo,
+    http_header_extra_fields_t* const           p_extra_header_fields,
+    http_server_resp_t* const                   p_resp)
 {
-    const char* const       p_uri_params = p_param->p_req_info->http_uri_params.ptr;
-    const http_req_header_t http_header  = p_param->p_req_info->http_header;
-
-    LOG_DBG("http_server_handle_req_get /%s", p_file_name_unchecked);
-
-    const char* const p_file_name = (0 == strcmp(p_file_name_unchecked, "")) ? "index.html" : p_file_name_unchecked;
-
-    const wifiman_hostinfo_t host_info = wifiman_config_sta_get_hostinfo();
-
-    if (0 == strcmp(p_file_name, "auth"))
-    {
-        const http_server_handle_req_auth_param_t param = {
-            .flag_access_from_lan                   = p_param->flag_access_from_lan,
-            .flag_check_rw_access_with_bearer_token = false,
-            .http_header                            = http_header,
-            .p_remote_ip                            = p_param->p_remote_ip,
-            .p_auth_info                            = p_param->p_auth_info,
-            .p_hostinfo                             = &host_info,
-        };
-
-        return http_server_handle_req_get_auth(&param, p_extra_header_fields);
-    }
-
-    bool flag_check_rw_access_with_bearer_token = false;
-    if (0 == strcmp(p_file_name, "ap.json"))
-    {
-        flag_check_rw_access_with_bearer_token = true;
-    }
-
-    const char* const p_file_ext = strrchr(p_file_name, '.');
-    if ((NULL == p_file_ext) || ((NULL != p_file_ext) && (0 == strcmp(p_file_ext, ".json"))))
+    if (HTTP_SERVER_ROUTE_AUTH_NONE != p_route->policy.auth)
     {
         bool flag_access_by_bearer_token = false;
 
         const http_server_handle_req_auth_param_t param = {
             .flag_access_from_lan                   = p_param->flag_access_from_lan,
-            .flag_check_rw_access_with_bearer_token = flag_check_rw_access_with_bearer_token,
-            .http_header                            = http_header,
+            .flag_check_rw_access_with_bearer_token = (HTTP_SERVER_ROUTE_AUTH_BEARER_RW == p_route->policy.auth),
+            .http_header                            = p_param->p_req_info->http_header,
             .p_remote_ip                            = p_param->p_remote_ip,
             .p_auth_info                            = p_param->p_auth_info,
-            .p_hostinfo                             = &host_info,
+            .p_hostinfo                             = p_hostinfo,
         };
 
         const http_server_resp_t resp_auth_check = http_server_handle_req_check_auth(
             &param,
             p_extra_header_fields,
             &flag_access_by_bearer_token);
-        if ((!flag_access_by_bearer_token) && (HTTP_RESP_CODE_401 == resp_auth_check.http_resp_code)
+        if ((HTTP_SERVER_ROUTE_METHOD_GET == p_route->method) && (!flag_access_by_bearer_token)
+            && (HTTP_RESP_CODE_401 == resp_auth_check.http_resp_code)
             && ((HTTP_SERVER_AUTH_TYPE_RUUVI == p_param->p_auth_info->auth_type)
                 || (HTTP_SERVER_AUTH_TYPE_DEFAULT == p_param->p_auth_info->auth_type)))
         {
-            if ((0 != strcmp(p_file_name, "ap.json")) && (0 != strcmp(p_file_name, "status.json")))
+            if ((HTTP_SERVER_ROUTE_ID_GET_AP_JSON != p_route->id)
+                && (HTTP_SERVER_ROUTE_ID_GET_STATUS_JSON != p_route->id))
             {
                 (void)snprintf(
                     p_extra_header_fields->buf,
                     sizeof(p_extra_header_fields->buf),
                     "Set-Cookie: %s=/%s",
                     HTTP_SERVER_AUTH_RUUVI_COOKIE_PREV_URL,
-                    p_file_name);
+                    p_route->p_path);
             }
-            return http_server_resp_302();
+            *p_resp = http_server_resp_302();
+            return false;
         }
         if (HTTP_RESP_CODE_200 != resp_auth_check.http_resp_code)
         {
-            LOG_DBG("GET /%s: failed to check auth, return HTTP error %d", p_file_name, resp_auth_check.http_resp_code);
-            return resp_auth_check;
+            LOG_DBG("/%s: failed to check auth, return HTTP error %d", p_route->p_path, resp_auth_check.http_resp_code);
+            *p_resp = resp_auth_check;
+            return false;
         }
     }
-
-    if (0 == strcmp(p_file_name, "ap.json"))
+    if ((!p_route->policy.flag_lan_allowed) && p_param->flag_access_from_lan)
     {
-        const char* const p_buff = wifi_manager_scan_sync();
-        if (NULL == p_buff)
-        {
-            LOG_ERR("GET /ap.json: failed to get json, return HTTP error 503");
-            return http_server_resp_503();
-        }
-        LOG_INFO("ap.json: %s", p_buff);
-        return http_server_resp_200_json_in_heap(p_buff);
+        LOG_ERR("/%s - access from LAN is not allowed", p_route->p_path);
+        *p_resp = http_server_resp_403_forbidden();
+        return false;
     }
+    return true;
+}
+
+static http_server_resp_t
+http_server_handle_req_get_ap_json(void)
+{
+    // WiFi scanning takes several seconds, allow the other HTTP workers to handle requests meanwhile.
+    // The arena is shared by the workers, so it is released and taken again like the handler lock.
+    http_server_arena_end();
+    http_server_handler_unlock();
+    const char* const p_buff = wifi_manager_scan_sync();
+    http_server_handler_lock();
+    http_server_arena_begin();
+    if (NULL == p_buff)
+    {
+        LOG_ERR("GET /ap.json: failed to get json, return HTTP error 503");
+        return http_server_resp_503();
+    }
+    LOG_INFO("ap.json: %s", p_buff);
+    return http_server_resp_200_json_in_heap(p_buff);
+}
+
+static http_server_resp_t
+http_server_handle_req_get_status_json(const http_server_handle_req_param_t* const p_param)
+{
+    http_server_resp_t                       http_resp = { 0 };
+    http_server_gen_resp_status_json_param_t params    = {
+           .p_http_resp          = &http_resp,
+           .p_resp_status_json   = p_param->p_resp_status_json,
+           .flag_access_from_lan = p_param->flag_access_from_lan,
+    };
+    const os_delta_ticks_t ticks_to_wait = pdMS_TO_TICKS(500U);
+    json_network_info_do_const_action_with_timeout(&http_server_gen_resp_status_json, &params, ticks_to_wait);
+    const TaskHandle_t arena_owner = http_server_arena_suspend();
+    wifi_manager_cb_on_request_status_json();
+    http_server_arena_resume(arena_owner);
+    return http_resp;
+}
 
-    if (0 == strcmp(p_file_name, "status.json"))
+static http_server_resp_t
+http_server_handle_req_call_app_route(
+    const http_server_route_t* const            p_route,
+    const http_server_handle_req_param_t* const p_param,
+    const char* const                           p_body)
+{
+    const http_server_route_req_t req = {
+        .p_path               = p_route->p_path,
+        .p_uri_params         = p_param->p_req_info->http_uri_params.ptr,
+        .p_body               = p_body,
+        .flag_access_from_lan = p_param->flag_access_from_lan,
+    };
+    // The application can keep the memory allocated by the handler, so it is not allocated from the arena
+    const TaskHandle_t       arena_owner = http_server_arena_suspend();
+    const http_server_resp_t resp        = p_route->handler(&req, p_route->p_user_data);
+    http_server_arena_resume(arena_owner);
+    return resp;
+}
+
+static http_server_resp_t
+http_server_handle_req_get(
+    const http_server_route_t* const            p_route,
+    const http_server_handle_req_param_t* const p_param,
+    http_header_extra_fields_t* const           p_extra_header_fields)
+{
+    const char* const p_uri_params = p_param->p_req_info->http_uri_params.ptr;
+
+    LOG_DBG("http_server_handle_req_get /%s", p_route->p_path);
+
+    const wifiman_hostinfo_t host_info = wifiman_config_sta_get_hostinfo();
+
+    if (HTTP_SERVER_ROUTE_ID_GET_AUTH == p_route->id)
     {
-        http_server_resp_t                       http_resp = { 0 };
-        http_server_gen_resp_status_json_param_t params    = {
-               .p_http_resp          = &http_resp,
-               .flag_access_from_lan = p_param->flag_access_from_lan,
+        const http_server_handle_req_auth_param_t param = {
+            .flag_access_from_lan                   = p_param->flag_access_from_lan,
+            .flag_check_rw_access_with_bearer_token = false,
+            .http_header                            = p_param->p_req_info->http_header,
+            .p_remote_ip                            = p_param->p_remote_ip,
+            .p_auth_info                            = p_param->p_auth_info,
+            .p_hostinfo                             = &host_info,
         };
-        const os_delta_ticks_t ticks_to_wait = pdMS_TO_TICKS(500U);
-        json_network_info_do_const_action_with_timeout(&http_server_gen_resp_status_json, &params, ticks_to_wait);
-        wifi_manager_cb_on_request_status_json();
-        return http_resp;
+
+        return http_server_handle_req_get_auth(&param, p_extra_header_fields);
+    }
+
+    http_server_resp_t resp_access_denied = { 0 };
+    if (!http_server_handle_req_check_access(p_route, p_param, &host_info, p_extra_header_fields, &resp_access_denied))
+    {
+        return resp_access_denied;
     }
 
-    return wifi_manager_cb_on_http_get(p_file_name, p_uri_params, p_param->flag_access_from_lan, NULL);
+    switch (p_route->id)
+    {
+        case HTTP_SERVER_ROUTE_ID_GET_AP_JSON:
+            return http_server_handle_req_get_ap_json();
+        case HTTP_SERVER_ROUTE_ID_GET_STATUS_JSON:
+            return http_server_handle_req_get_status_json(p_param);
+        default:
+            break;
+    }
+    http_server_resp_t resp = { 0 };
+    if (HTTP_SERVER_ROUTE_ID_APP == p_route->id)
+    {
+        resp = http_server_handle_req_call_app_route(p_route, p_param, NULL);
+    }
+    else
+    {
+        const TaskHandle_t arena_owner = http_server_arena_suspend();
+        resp = wifi_manager_cb_on_http_get(p_route->p_path, p_uri_params, p_param->flag_access_from_lan, NULL);
+        http_server_arena_resume(arena_owner);
+    }
+    // The static assets with a content hash in the file name are cached by the browser without revalidation
+    http_server_resp_set_default_cache_policy(&resp, p_route->p_path);
+    return resp;
+}
+
+static http_server_resp_t
+http_server_handle_req_delete_connect_json(void)
+{
+    LOG_INFO("http_server_netconn_serve: DELETE /connect.json");
+    dns_server_stop();
+    wifi_manager_disable_wps();
+    wifi_manager_lock();
+    json_network_info_set_reason_user_disconnect();
+    wifi_manager_unlock();
+    if (wifi_manager_is_connected_to_ethernet())
+    {
+        wifi_manager_disconnect_eth();
+    }
+    else
+    {
+        /* request a disconnection from Wi-Fi */
+        wifi_manager_disconnect_wifi();
+    }
+    return http_server_resp_200_json("{}");
 }
 
 static http_server_resp_t
 http_server_handle_req_delete(
-    const char* const                           p_file_name,
+    const http_server_route_t* const            p_route,
     const http_server_handle_req_param_t* const p_param,
     http_header_extra_fields_t* const           p_extra_header_fields)
 {
     const char* const       p_uri_params = p_param->p_req_info->http_uri_params.ptr;
     const http_req_header_t http_header  = p_param->p_req_info->http_header;
 
-    LOG_INFO("DELETE /%s, params=%s", p_file_name, (NULL != p_uri_params) ? p_uri_params : "");
+    LOG_INFO("DELETE /%s, params=%s", p_route->p_path, (NULL != p_uri_params) ? p_uri_params : "");
     const wifiman_hostinfo_t host_info = wifiman_config_sta_get_hostinfo();
 
-    bool flag_access_by_bearer_token = false;
-
-    const http_server_handle_req_auth_param_t param = {
-        .flag_access_from_lan                   = p_param->flag_access_from_lan,
-        .flag_check_rw_access_with_bearer_token = true,
-        .http_header                            = http_header,
-        .p_remote_ip                            = p_param->p_remote_ip,
-        .p_auth_info                            = p_param->p_auth_info,
-        .p_hostinfo                             = &host_info,
-    };
-
-    const http_server_resp_t resp_auth_check = http_server_handle_req_check_auth(
-        &param,
-        p_extra_header_fields,
-        &flag_access_by_bearer_token);
-
-    if (HTTP_RESP_CODE_200 != resp_auth_check.http_resp_code)
+    http_server_resp_t resp_access_denied = { 0 };
+    if (!http_server_handle_req_check_access(p_route, p_param, &host_info, p_extra_header_fields, &resp_access_denied))
     {
-        return resp_auth_check;
+        return resp_access_denied;
     }
 
-    if (0 == strcmp(p_file_name, "auth"))
+    switch (p_route->id)
     {
-        return http_server_handle_req_delete_auth(http_header, p_param->p_remote_ip, p_param->p_auth_info, &host_info);
+        case HTTP_SERVER_ROUTE_ID_DELETE_AUTH:
+            return http_server_handle_req_delete_auth(
+                http_header,
+                p_param->p_remote_ip,
+                p_param->p_auth_info,
+                &host_info);
+        case HTTP_SERVER_ROUTE_ID_DELETE_CONNECT_JSON:
+            return http_server_handle_req_delete_connect_json();
+        default:
+            break;
     }
-    if (0 == strcmp(p_file_name, "connect.json"))
+    if (HTTP_SERVER_ROUTE_ID_APP == p_route->id)
     {
-        LOG_INFO("http_server_netconn_serve: DELETE /connect.json");
-        if (p_param->flag_access_from_lan)
-        {
-            LOG_ERR("http_server_netconn_serve: DELETE /connect.json - access from LAN is not allowed");
-            return http_server_resp_403_forbidden();
-        }
-        dns_server_stop();
-        wifi_manager_disable_wps();
-        wifi_manager_lock();
-        json_network_info_set_reason_user_disconnect();
-        wifi_manager_unlock();
-        if (wifi_manager_is_connected_to_ethernet())
-        {
-            wifi_manager_disconnect_eth();
-        }
-        else
-        {
-            /* request a disconnection from Wi-Fi */
-            wifi_manager_disconnect_wifi();
-        }
-        return http_server_resp_200_json("{}");
+        return http_server_handle_req_call_app_route(p_route, p_param, NULL);
     }
-    return wifi_manager_cb_on_http_delete(p_file_name, p_uri_params, p_param->flag_access_from_lan, NULL);
+    const TaskHandle_t       arena_owner = http_server_arena_suspend();
+    const http_server_resp_t resp        = wifi_manager_cb_on_http_delete(
+        p_route->p_path,
+        p_uri_params,
+        p_param->flag_access_from_lan,
+        NULL);
+    http_server_arena_resume(arena_owner);
+    return resp;
 }
 
 static const char*
@@ -477,7 +554,7 @@ http_server_handle_req_post_connect_wps(void)
 
 static http_server_resp_t
 http_server_handle_req_post(
-    const char*                                 p_file_name,
+    const http_server_route_t* const            p_route,
     const http_server_handle_req_param_t* const p_param,
     const http_req_body_t                       http_body,
     http_header_extra_fields_t* const           p_extra_header_fields)
@@ -485,11 +562,11 @@ http_server_handle_req_post(
     const char*             p_uri_params = p_param->p_req_info->http_uri_params.ptr;
     const http_req_header_t http_header  = p_param->p_req_info->http_header;
 
-    LOG_INFO("POST /%s, params=%s", p_file_name, (NULL != p_uri_params) ? p_uri_params : "");
+    LOG_INFO("POST /%s, params=%s", p_route->p_path, (NULL != p_uri_params) ? p_uri_params : "");
 
     const wifiman_hostinfo_t hostinfo = wifiman_config_sta_get_hostinfo();
 
-    if (0 == strcmp(p_file_name, "auth"))
+    if (HTTP_SERVER_ROUTE_ID_POST_AUTH == p_route->id)
     {
         return http_server_handle_req_post_auth(
             p_param->flag_access_from_lan,
@@ -501,55 +578,42 @@ http_server_handle_req_post(
             p_extra_header_fields);
     }
 
-    bool flag_access_by_bearer_token = false;
-
-    const http_server_handle_req_auth_param_t param = {
-        .flag_access_from_lan                   = p_param->flag_access_from_lan,
-        .flag_check_rw_access_with_bearer_token = true,
-        .http_header                            = http_header,
-        .p_remote_ip                            = p_param->p_remote_ip,
-        .p_auth_info                            = p_param->p_auth_info,
-        .p_hostinfo                             = &hostinfo,
-    };
-
-    const http_server_resp_t resp_auth_check = http_server_handle_req_check_auth(
-        &param,
-        p_extra_header_fields,
-        &flag_access_by_bearer_token);
-
-    if (HTTP_RESP_CODE_200 != resp_auth_check.http_resp_code)
+    http_server_resp_t resp_access_denied = { 0 };
+    if (!http_server_handle_req_check_access(p_route, p_param, &hostinfo, p_extra_header_fields, &resp_access_denied))
     {
-        return resp_auth_check;
+        return resp_access_denied;
     }
 
-    if (0 == strcmp(p_file_name, "connect.json"))
+    switch (p_route->id)
     {
-        if (p_param->flag_access_from_lan)
-        {
-            LOG_ERR("POST /connect.json - access from LAN is not allowed");
-            return http_server_resp_403_forbidden();
-        }
-        return http_server_handle_req_post_connect_json(http_body);
+        case HTTP_SERVER_ROUTE_ID_POST_CONNECT_JSON:
+            return http_server_handle_req_post_connect_json(http_body);
+        case HTTP_SERVER_ROUTE_ID_POST_CONNECT_WPS:
+            return http_server_handle_req_post_connect_wps();
+        default:
+            break;
     }
-    if (0 == strcmp(p_file_name, "connect_wps"))
+    if (HTTP_SERVER_ROUTE_ID_APP == p_route->id)
     {
-        if (p_param->flag_access_from_lan)
-        {
-            LOG_ERR("POST /connect_wps - access from LAN is not allowed");
-            return http_server_resp_403_forbidden();
-        }
-        return http_server_handle_req_post_connect_wps();
+        return http_server_handle_req_call_app_route(p_route, p_param, http_body.ptr);
     }
-    return wifi_manager_cb_on_http_post(p_file_name, p_uri_params, http_body, p_param->flag_access_from_lan);
+    const TaskHandle_t       arena_owner = http_server_arena_suspend();
+    const http_server_resp_t resp        = wifi_manager_cb_on_http_post(
+        p_route->p_path,
+        p_uri_params,
+        http_body,
+        p_param->flag_access_from_lan);
+    http_server_arena_resume(arena_owner);
+    return resp;
 }
 
 static http_server_resp_t
 http_server_handle_req_get_with_ecdh_key(
-    const char* const                           p_path,
+    const http_server_route_t* const            p_route,
     const http_server_handle_req_param_t* const p_param,
     http_header_extra_fields_t* const           p_extra_header_fields)
 {
-    http_server_resp_t resp = http_server_handle_req_get(p_path, p_param, p_extra_header_fields);
+    http_server_resp_t resp = http_server_handle_req_get(p_route, p_param, p_extra_header_fields);
 
     uint32_t          len_ruuvi_ecdh_pub_key = 0;
     const char* const p_ruuvi_ecdh_pub_key   = http_req_header_get_field(
@@ -581,7 +645,7 @@ http_server_handle_req_get_with_ecdh_key(
 
 static http_server_resp_t
 http_server_handle_req_post_with_ecdh_key(
-    const char* const                           p_path,
+    const http_server_route_t* const            p_route,
     const http_server_handle_req_param_t* const p_param,
     http_header_extra_fields_t* const           p_extra_header_fields)
 {
@@ -610,7 +674,7 @@ http_server_handle_req_post_with_ecdh_key(
     }
 
     const http_server_resp_t resp = http_server_handle_req_post(
-        p_path,
+        p_route,
         p_param,
         flag_encrypted ? http_body_decrypted : p_param->p_req_info->http_body,
         p_extra_header_fields);
@@ -622,31 +686,156 @@ http_server_handle_req_post_with_ecdh_key(
     return resp;
 }
 
-http_server_resp_t
-http_server_handle_req(
+/**
+ * @brief Find the route of the request.
+ * @note If the path is not registered, then the request is passed to the HTTP callbacks of the application
+ *       with the default access policy.
+ * @return false if the method is not supported.
+ */
+static bool
+http_server_handle_req_find_route(
     const http_server_handle_req_param_t* const p_param,
-    http_header_extra_fields_t* const           p_extra_header_fields)
+    http_server_route_t* const                  p_route)
 {
-    assert(NULL != p_extra_header_fields);
-    p_extra_header_fields->buf[0] = '\0';
-
     const char* p_path = p_param->p_req_info->http_uri.ptr;
     if ('/' == p_path[0])
     {
         p_path += 1;
     }
+    p_route->p_path = p_path;
+
+    http_server_route_method_e method = HTTP_SERVER_ROUTE_METHOD_GET;
+    if (!http_server_route_parse_method(p_param->p_req_info->http_cmd.ptr, &method))
+    {
+        return false;
+    }
+    if ((HTTP_SERVER_ROUTE_METHOD_GET == method) && ('\0' == p_path[0]))
+    {
+        p_path = "index.html";
+    }
+    if (http_server_route_find(method, p_path, p_route))
+    {
+        return true;
+    }
+    p_route->id                      = HTTP_SERVER_ROUTE_ID_APP_CALLBACK;
+    p_route->method                  = method;
+    p_route->p_path                  = p_path;
+    p_route->policy.auth             = HTTP_SERVER_ROUTE_AUTH_BEARER_RW;
+    p_route->policy.flag_lan_allowed = true;
+    p_route->handler                 = NULL;
+    p_route->p_user_data             = NULL;
+    if (HTTP_SERVER_ROUTE_METHOD_GET == method)
+    {
+        // Pages and JSON require authentication, the static files (scripts, styles, images) are public
+        const char* const p_file_ext = strrchr(p_path, '.');
+        p_route->policy.auth         = ((NULL == p_file_ext) || (0 == strcmp(p_file_ext, ".json")))
+                                           ? HTTP_SERVER_ROUTE_AUTH_REQUIRED
+                                           : HTTP_SERVER_ROUTE_AUTH_NONE;
+    }
+    return true;
+}
+
+void*
+http_server_handle_req_post_stream_begin(
+    const http_server_handle_req_param_t* const p_param,
+    const size_t                                content_len,
+    http_header_extra_fields_t* const           p_extra_header_fields,
+    http_server_resp_t* const                   p_resp)
+{
+    assert(NULL != p_extra_header_fields);
+    p_extra_header_fields->buf[0] = '\0';
+
+    http_server_route_t route    = { 0 };
+    const bool          is_found = http_server_handle_req_find_route(p_param, &route);
+
+    const char* const p_path       = route.p_path;
+    const char* const p_uri_params = p_param->p_req_info->http_uri_params.ptr;
+
+    LOG_INFO(
+        "%s /%s, params=%s: stream the body of %lu bytes",
+        p_param->p_req_info->http_cmd.ptr,
+        p_path,
+        (NULL != p_uri_params) ? p_uri_params : "",
+        (printf_ulong_t)content_len);
+
+    uint32_t          len_ruuvi_ecdh_encrypted = 0;
+    const char* const p_ruuvi_ecdh_encrypted   = http_req_header_get_field(
+        p_param->p_req_info->http_header,
+        "Ruuvi-Ecdh-Encrypted:",
+        &len_ruuvi_ecdh_encrypted);
+    const bool flag_encrypted = (NULL != p_ruuvi_ecdh_encrypted)
+                                && (0 == strncmp(p_ruuvi_ecdh_encrypted, "true", len_ruuvi_ecdh_encrypted));
+
+    // The built-in handlers, the registered routes and the encrypted requests need the whole body at once
+    if ((!is_found) || (HTTP_SERVER_ROUTE_METHOD_POST != route.method)
+        || (HTTP_SERVER_ROUTE_ID_APP_CALLBACK != route.id) || flag_encrypted)
+    {
+        LOG_ERR("Request is too large");
+        *p_resp = http_server_resp_413();
+        return NULL;
+    }
 
-    if (0 == strcmp("GET", p_param->p_req_info->http_cmd.ptr))
+    const wifiman_hostinfo_t hostinfo = wifiman_config_sta_get_hostinfo();
+    if (!http_server_handle_req_check_access(&route, p_param, &hostinfo, p_extra_header_fields, p_resp))
     {
-        return http_server_handle_req_get_with_ecdh_key(p_path, p_param, p_extra_header_fields);
+        return NULL;
+    }
+
+    const TaskHandle_t arena_owner = http_server_arena_suspend();
+    void* const        p_stream    = wifi_manager_cb_on_http_post_stream_begin(
+        p_path,
+        p_uri_params,
+        content_len,
+        p_param->flag_access_from_lan);
+    http_server_arena_resume(arena_owner);
+    if (NULL == p_stream)
+    {
+        LOG_ERR("POST /%s: streaming of the body is not supported", p_path);
+        *p_resp = http_server_resp_413();
+        return NULL;
     }
-    if (0 == strcmp("DELETE", p_param->p_req_info->http_cmd.ptr))
+    return p_stream;
+}
+
+bool
+http_server_handle_req_post_stream_data(void* const p_stream, const uint8_t* const p_buf, const size_t len)
+{
+    return wifi_manager_cb_on_http_post_stream_data(p_stream, p_buf, len);
+}
+
+http_server_resp_t
+http_server_handle_req_post_stream_end(void* const p_stream)
+{
+    return wifi_manager_cb_on_http_post_stream_end(p_stream);
+}
+
+void
+http_server_handle_req_post_stream_abort(void* const p_stream)
+{
+    wifi_manager_cb_on_http_post_stream_abort(p_stream);
+}
+
+http_server_resp_t
+http_server_handle_req(
+    const http_server_handle_req_param_t* const p_param,
+    http_header_extra_fields_t* const           p_extra_header_fields)
+{
+    assert(NULL != p_extra_header_fields);
+    p_extra_header_fields->buf[0] = '\0';
+
+    http_server_route_t route = { 0 };
+    if (!http_server_handle_req_find_route(p_param, &route))
     {
-        return http_server_handle_req_delete(p_path, p_param, p_extra_header_fields);
+        return http_server_resp_400();
     }
-    if (0 == strcmp("POST", p_param->p_req_info->http_cmd.ptr))
+    switch (route.method)
     {
-        return http_server_handle_req_post_with_ecdh_key(p_path, p_param, p_extra_header_fields);
+        case HTTP_SERVER_ROUTE_METHOD_GET:
+            return http_server_handle_req_get_with_ecdh_key(&route, p_param, p_extra_header_fields);
+        case HTTP_SERVER_ROUTE_METHOD_DELETE:
+            return http_server_handle_req_delete(&route, p_param, p_extra_header_fields);
+        case HTTP_SERVER_ROUTE_METHOD_POST:
+            return http_server_handle_req_post_with_ecdh_key(&route, p_param, p_extra_header_fields);
     }
     return http_server_resp_400();
 }
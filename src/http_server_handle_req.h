@@ -11,6 +11,7 @@
 #include "http_server_resp.h"
 #include "http_req.h"
 #include "http_server_auth.h"
+#include "json_network_info.h"
 
 #ifdef __cplusplus
 extern "C" {
@@ -18,10 +19,11 @@ extern "C" {
 
 typedef struct http_server_handle_req_param_t
 {
-    const http_req_info_t* const         p_req_info;
-    const sta_ip_string_t* const         p_remote_ip;
-    const http_server_auth_info_t* const p_auth_info;
-    const bool                           flag_access_from_lan;
+    const http_req_info_t* const          p_req_info;
+    const sta_ip_string_t* const          p_remote_ip;
+    const http_server_auth_info_t* const  p_auth_info;
+    const bool                            flag_access_from_lan;
+    http_server_resp_status_json_t* const p_resp_status_json; // Per-connection buffer for "status.json"
 } http_server_handle_req_param_t;
 
 http_server_resp_t
@@ -29,6 +31,41 @@ http_server_handle_req(
     const http_server_handle_req_param_t* const p_param,
     http_header_extra_fields_t* const           p_extra_header_fields);
 
+/**
+ * @brief Check the access to the POST request which body is too large for the request buffer
+ *        and start passing the body to the application in chunks.
+ * @param p_param - ptr to the request params (the body is not received yet)
+ * @param content_len - the value of "Content-Length"
+ * @param p_extra_header_fields - ptr to the buffer for the extra header fields of the response
+ * @param[out] p_resp - the response which is sent if the request is rejected
+ * @return the handle of the upload or NULL if the request is rejected
+ */
+void*
+http_server_handle_req_post_stream_begin(
+    const http_server_handle_req_param_t* const p_param,
+    const size_t                                content_len,
+    http_header_extra_fields_t* const           p_extra_header_fields,
+    http_server_resp_t* const                   p_resp);
+
+/**
+ * @brief Pass the next chunk of the body of the POST request to the application.
+ * @return false if the application aborted the upload.
+ */
+bool
+http_server_handle_req_post_stream_data(void* const p_stream, const uint8_t* const p_buf, const size_t len);
+
+/**
+ * @brief Finish the upload and get the response to the POST request from the application.
+ */
+http_server_resp_t
+http_server_handle_req_post_stream_end(void* const p_stream);
+
+/**
+ * @brief Notify the application that the upload was aborted.
+ */
+void
+http_server_handle_req_post_stream_abort(void* const p_stream);
+
 #ifdef __cplusplus
 }
 #endif
@@ -6,6 +6,7 @@
  */
 
 #include "http_server_mutex.h"
+#include <assert.h>
 #include <esp_attr.h>
 #include "os_mutex.h"
 #include "http_server.h"
@@ -15,6 +16,9 @@ static const char TAG[] = "http_server";
 
 static os_mutex_t IRAM_ATTR g_p_mutex_accept_conn;
 
+static os_mutex_static_t    g_http_server_handler_mutex_mem;
+static os_mutex_t IRAM_ATTR g_p_http_server_handler_mutex;
+
 void
 http_server_use_mutex_for_incoming_connection_handling(os_mutex_t p_mutex)
 {
@@ -41,3 +45,26 @@ http_server_get_mutex(void)
 {
     return g_p_mutex_accept_conn;
 }
+
+void
+http_server_handler_mutex_init(void)
+{
+    if (NULL == g_p_http_server_handler_mutex)
+    {
+        g_p_http_server_handler_mutex = os_mutex_create_static(&g_http_server_handler_mutex_mem);
+    }
+}
+
+void
+http_server_handler_lock(void)
+{
+    assert(NULL != g_p_http_server_handler_mutex);
+    os_mutex_lock(g_p_http_server_handler_mutex);
+}
+
+void
+http_server_handler_unlock(void)
+{
+    assert(NULL != g_p_http_server_handler_mutex);
+    os_mutex_unlock(g_p_http_server_handler_mutex);
+}
@@ -17,6 +17,21 @@ extern "C" {
 os_mutex_t
 http_server_get_mutex(void);
 
+/**
+ * @brief Create the mutex which serializes the request handlers.
+ * @note The request handlers and the callbacks of the application are not reentrant,
+ *       so with several HTTP workers only one of them can handle a request at a time,
+ *       while sending the responses is done in parallel.
+ */
+void
+http_server_handler_mutex_init(void);
+
+void
+http_server_handler_lock(void);
+
+void
+http_server_handler_unlock(void);
+
 #ifdef __cplusplus
 }
 #endif
@@ -0,0 +1,313 @@
+/**
+ * @file http_server_mux.c
+ * @author TheSomeMan
+ * @date 2026-10-17
+ * @copyright Ruuvi Innovations Ltd, license BSD-3-Clause.
+ */
+
+#include "http_server_mux.h"
+#include <string.h>
+#include "freertos/FreeRTOS.h"
+#include "freertos/task.h"
+#include "esp_type_wrapper.h"
+#include "http_server.h"
+#include "http_server_cfg.h"
+#include "http_server_accept_and_handle_conn.h"
+#include "http_server_conn_pool.h"
+
+#define LOG_LOCAL_LEVEL LOG_LEVEL_INFO
+#include "log.h"
+
+typedef enum http_server_mux_conn_state_e
+{
+    HTTP_SERVER_MUX_CONN_STATE_FREE,      // The slot is not used
+    HTTP_SERVER_MUX_CONN_STATE_RECV_REQ,  // Waiting for the complete request
+    HTTP_SERVER_MUX_CONN_STATE_RECV_BODY, // Passing the large body of the request to the handler
+    HTTP_SERVER_MUX_CONN_STATE_SEND_RESP, // Waiting for free space in the send buffer
+} http_server_mux_conn_state_e;
+
+typedef struct http_server_mux_conn_t
+{
+    http_server_mux_conn_state_e state;
+    TickType_t                   tick_last_activity;
+    size_t                       last_bytes_sent;
+    uint32_t                     last_bytes_received;
+    http_server_conn_ctx_t*      p_ctx; // The connection context taken from the pool
+} http_server_mux_conn_t;
+
+static const char TAG[] = "http_server";
+
+static http_server_mux_conn_t g_http_server_mux_conns[HTTP_SERVER_MUX_MAX_CONNS];
+
+static http_server_mux_conn_t*
+http_server_mux_find_free_slot(void)
+{
+    for (uint32_t i = 0; i < HTTP_SERVER_MUX_MAX_CONNS; ++i)
+    {
+        http_server_mux_conn_t* const p_slot = &g_http_server_mux_conns[i];
+        if (HTTP_SERVER_MUX_CONN_STATE_FREE == p_slot->state)
+        {
+            return p_slot;
+        }
+    }
+    return NULL;
+}
+
+bool
+http_server_mux_has_free_slot(void)
+{
+    return (NULL != http_server_mux_find_free_slot()) ? true : false;
+}
+
+static void
+http_server_mux_close_slot(http_server_mux_conn_t* const p_slot)
+{
+    struct netconn* const p_conn = p_slot->p_ctx->p_netconn;
+    http_server_conn_ctx_deinit(p_slot->p_ctx);
+    http_server_conn_pool_release(p_slot->p_ctx);
+    http_server_close_conn(p_conn);
+    p_slot->p_ctx = NULL;
+    p_slot->state = HTTP_SERVER_MUX_CONN_STATE_FREE;
+}
+
+bool
+http_server_mux_add_conn(struct netconn* const p_conn)
+{
+    http_server_mux_conn_t* const p_slot = http_server_mux_find_free_slot();
+    if (NULL == p_slot)
+    {
+        LOG_ERR("No free slots for the new connection");
+        http_server_close_conn(p_conn);
+        return false;
+    }
+    http_server_conn_ctx_t* const p_ctx = http_server_conn_pool_acquire();
+    if (NULL == p_ctx)
+    {
+        http_server_conn_resp_canned_503(p_conn);
+        http_server_close_conn(p_conn);
+        return false;
+    }
+    netconn_set_nonblocking(p_conn, 1);
+    if (!http_server_conn_ctx_init(p_ctx, p_conn))
+    {
+        http_server_conn_ctx_deinit(p_ctx);
+        http_server_conn_pool_release(p_ctx);
+        http_server_close_conn(p_conn);
+        return false;
+    }
+    p_slot->p_ctx               = p_ctx;
+    p_slot->state               = HTTP_SERVER_MUX_CONN_STATE_RECV_REQ;
+    p_slot->tick_last_activity  = xTaskGetTickCount();
+    p_slot->last_bytes_sent     = 0;
+    p_slot->last_bytes_received = 0;
+    LOG_DBG(
+        "Connection from %s added to slot %u",
+        p_slot->p_ctx->remote_ip_str.buf,
+        (printf_uint_t)(p_slot - &g_http_server_mux_conns[0]));
+    return true;
+}
+
+/**
+ * @brief Send the next portion of the response.
+ * @return false if the connection should be closed.
+ */
+static bool
+http_server_mux_poll_send(http_server_mux_conn_t* const p_slot)
+{
+    http_server_sema_send_wait_immediate();
+    const http_server_conn_send_res_e res = http_server_conn_resp_send_step(p_slot->p_ctx);
+    if (HTTP_SERVER_CONN_SEND_RES_ERROR == res)
+    {
+        return false;
+    }
+    if (HTTP_SERVER_CONN_SEND_RES_WOULD_BLOCK == res)
+    {
+        return true;
+    }
+    if (!http_server_conn_finish_req(p_slot->p_ctx))
+    {
+        return false;
+    }
+    p_slot->state = HTTP_SERVER_MUX_CONN_STATE_RECV_REQ;
+    return true;
+}
+
+/**
+ * @brief Pass the available part of the body to the handler.
+ * @return false if the connection should be closed.
+ */
+static bool
+http_server_mux_poll_recv_body(http_server_mux_conn_t* const p_slot)
+{
+    const http_server_conn_recv_res_e res = http_server_conn_recv_body_stream(p_slot->p_ctx);
+    if (HTTP_SERVER_CONN_RECV_RES_CLOSED == res)
+    {
+        return false;
+    }
+    if (HTTP_SERVER_CONN_RECV_RES_NEED_MORE == res)
+    {
+        return true;
+    }
+    p_slot->state = HTTP_SERVER_MUX_CONN_STATE_SEND_RESP;
+    return http_server_mux_poll_send(p_slot);
+}
+
+/**
+ * @brief Receive the available data and handle the request if it's complete.
+ * @return false if the connection should be closed.
+ */
+static bool
+http_server_mux_poll_recv(http_server_mux_conn_t* const p_slot)
+{
+    const http_server_conn_recv_res_e res = http_server_conn_recv_nonblocking(p_slot->p_ctx);
+    if (HTTP_SERVER_CONN_RECV_RES_CLOSED == res)
+    {
+        if (0 == p_slot->p_ctx->num_requests)
+        {
+            LOG_WARN("The connection was closed by the client side");
+        }
+        return false;
+    }
+    if (HTTP_SERVER_CONN_RECV_RES_NEED_MORE == res)
+    {
+        return true;
+    }
+    http_server_conn_handle_req(p_slot->p_ctx);
+    if (p_slot->p_ctx->flag_body_stream)
+    {
+        p_slot->state = HTTP_SERVER_MUX_CONN_STATE_RECV_BODY;
+        return http_server_mux_poll_recv_body(p_slot);
+    }
+    p_slot->state = HTTP_SERVER_MUX_CONN_STATE_SEND_RESP;
+    return http_server_mux_poll_send(p_slot);
+}
+
+/**
+ * @brief Check the timeout of the connection.
+ * @note The timeout is counted from the last progress (received or sent bytes), not from the beginning of the request.
+ * @return false if the connection should be closed.
+ */
+static bool
+http_server_mux_check_timeout(http_server_mux_conn_t* const p_slot)
+{
+    const TickType_t tick_now = xTaskGetTickCount();
+    if ((p_slot->last_bytes_sent != p_slot->p_ctx->writer.bytes_sent)
+        || (p_slot->last_bytes_received != p_slot->p_ctx->bytes_received))
+    {
+        p_slot->last_bytes_sent     = p_slot->p_ctx->writer.bytes_sent;
+        p_slot->last_bytes_received = p_slot->p_ctx->bytes_received;
+        p_slot->tick_last_activity  = tick_now;
+        return true;
+    }
+    const TickType_t delta_ticks = tick_now - p_slot->tick_last_activity;
+    if (HTTP_SERVER_MUX_CONN_STATE_SEND_RESP == p_slot->state)
+    {
+        if (delta_ticks > pdMS_TO_TICKS(HTTP_SERVER_SEND_TIMEOUT_MS))
+        {
+            LOG_ERR("Send timeout (%u ms)", (printf_uint_t)HTTP_SERVER_SEND_TIMEOUT_MS);
+            return false;
+        }
+        return true;
+    }
+    if (http_server_conn_is_idle(p_slot->p_ctx))
+    {
+        if (http_server_is_new_conn_pending() && !http_server_mux_has_free_slot())
+        {
+            LOG_DBG("Close idle keep-alive connection: there is a new connection pending");
+            return false;
+        }
+        if (delta_ticks >= pdMS_TO_TICKS(HTTP_SERVER_KEEP_ALIVE_IDLE_TIMEOUT_MS))
+        {
+            LOG_DBG("Close idle keep-alive connection: timeout");
+            return false;
+        }
+        return true;
+    }
+    if (delta_ticks >= pdMS_TO_TICKS(HTTP_SERVER_RECV_TIMEOUT_MS))
+    {
+        LOG_ERR("netconn recv: timeout (%u ms)", (printf_uint_t)HTTP_SERVER_RECV_TIMEOUT_MS);
+        return false;
+    }
+    return true;
+}
+
+/**
+ * @brief Advance the state machine of the connection until it has to wait for the next event.
+ * @return false if the connection should be closed.
+ */
+static bool
+http_server_mux_poll_conn(http_server_mux_conn_t* const p_slot)
+{
+    for (;;)
+    {
+        const http_server_mux_conn_state_e prev_state        = p_slot->state;
+        const uint32_t                     prev_num_requests = p_slot->p_ctx->num_requests;
+
+        bool flag_keep_conn = false;
+        switch (p_slot->state)
+        {
+            case HTTP_SERVER_MUX_CONN_STATE_RECV_REQ:
+                flag_keep_conn = http_server_mux_poll_recv(p_slot);
+                break;
+            case HTTP_SERVER_MUX_CONN_STATE_RECV_BODY:
+                flag_keep_conn = http_server_mux_poll_recv_body(p_slot);
+                break;
+            default:
+                flag_keep_conn = http_server_mux_poll_send(p_slot);
+                break;
+        }
+        if (!flag_keep_conn)
+        {
+            return false;
+        }
+        // If the response was sent completely, the buffer can already contain the next pipelined request.
+        if ((prev_state == p_slot->state) && (prev_num_requests == p_slot->p_ctx->num_requests))
+        {
+            return http_server_mux_check_timeout(p_slot);
+        }
+    }
+}
+
+void
+http_server_mux_poll(void)
+{
+    for (uint32_t i = 0; i < HTTP_SERVER_MUX_MAX_CONNS; ++i)
+    {
+        http_server_mux_conn_t* const p_slot = &g_http_server_mux_conns[i];
+        if (HTTP_SERVER_MUX_CONN_STATE_FREE == p_slot->state)
+        {
+            continue;
+        }
+        if (!http_server_mux_poll_conn(p_slot))
+        {
+            http_server_mux_close_slot(p_slot);
+        }
+    }
+}
+
+uint32_t
+http_server_mux_get_num_active_conns(void)
+{
+    uint32_t num_conns = 0;
+    for (uint32_t i = 0; i < HTTP_SERVER_MUX_MAX_CONNS; ++i)
+    {
+        if (HTTP_SERVER_MUX_CONN_STATE_FREE != g_http_server_mux_conns[i].state)
+        {
+            num_conns += 1;
+        }
+    }
+    return num_conns;
+}
+
+void
+http_server_mux_close_all(void)
+{
+    for (uint32_t i = 0; i < HTTP_SERVER_MUX_MAX_CONNS; ++i)
+    {
+        http_server_mux_conn_t* const p_slot = &g_http_server_mux_conns[i];
+        if (HTTP_SERVER_MUX_CONN_STATE_FREE != p_slot->state)
+        {
+            http_server_mux_close_slot(p_slot);
+        }
+    }
+}
@@ -0,0 +1,59 @@
+/**
+ * @file http_server_mux.h
+ * @author TheSomeMan
+ * @date 2026-10-17
+ * @copyright Ruuvi Innovations Ltd, license BSD-3-Clause.
+ */
+
+#ifndef RUUVI_ESP_WIFI_MANAGER_HTTP_SERVER_MUX_H
+#define RUUVI_ESP_WIFI_MANAGER_HTTP_SERVER_MUX_H
+
+#include <stdbool.h>
+#include <stdint.h>
+#include "lwip/api.h"
+
+#ifdef __cplusplus
+extern "C" {
+#endif
+
+/**
+ * @brief Check if there is a free slot for one more connection.
+ */
+bool
+http_server_mux_has_free_slot(void);
+
+/**
+ * @brief Add the accepted connection to the set of connections served by the HTTP server task.
+ * @note The connection is switched to the non-blocking mode, it's closed and deleted
+ *       by http_server_mux_poll or http_server_mux_close_all.
+ * @param p_conn - ptr to the accepted connection
+ * @return false if there are no free slots or there is not enough memory (the connection is closed in this case).
+ */
+bool
+http_server_mux_add_conn(struct netconn* const p_conn);
+
+/**
+ * @brief Advance the state machines of all the connections without blocking.
+ * @note It should be called on every event of the connections (RCVPLUS, SENDPLUS, ERROR)
+ *       and periodically to check the timeouts.
+ */
+void
+http_server_mux_poll(void);
+
+/**
+ * @brief Get the number of connections which are currently served.
+ */
+uint32_t
+http_server_mux_get_num_active_conns(void);
+
+/**
+ * @brief Close and delete all the connections.
+ */
+void
+http_server_mux_close_all(void);
+
+#ifdef __cplusplus
+}
+#endif
+
+#endif // RUUVI_ESP_WIFI_MANAGER_HTTP_SERVER_MUX_H
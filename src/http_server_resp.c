@@ -6,13 +6,34 @@
  */
 
 #include "http_server_resp.h"
+#include <stdint.h>
 #include <string.h>
+#include <ctype.h>
 #include <esp_system.h>
 #include "http_server_auth.h"
+#include "http_server_cfg.h"
+#include "http_req.h"
 #include "json_stream_gen.h"
 
+#define HTTP_SERVER_RESP_ETAG_FNV1A_OFFSET_BASIS (2166136261U)
+#define HTTP_SERVER_RESP_ETAG_FNV1A_PRIME        (16777619U)
+
 static http_server_resp_auth_json_t g_auth_json;
 
+/**
+ * @brief Convert flag_no_cache of the functions which prepare the response to the cache policy.
+ * @note If the content can be cached, then the policy is selected by http_server_resp_set_default_cache_policy.
+ */
+static http_server_cache_policy_t
+http_server_resp_cache_policy_no_store(const bool flag_no_cache)
+{
+    const http_server_cache_policy_t cache_policy = {
+        .type    = flag_no_cache ? HTTP_CACHE_CONTROL_NO_STORE : HTTP_CACHE_CONTROL_DEFAULT,
+        .max_age = 0,
+    };
+    return cache_policy;
+}
+
 http_server_resp_t
 http_server_resp_200_json(const char* p_json_content)
 {
@@ -36,7 +57,7 @@ http_server_resp_json_in_heap(const http_resp_code_e http_resp_code, const char*
     const http_server_resp_t resp = {
         .http_resp_code       = http_resp_code,
         .content_location     = HTTP_CONTENT_LOCATION_HEAP,
-        .flag_no_cache        = flag_no_cache,
+        .cache_policy         = http_server_resp_cache_policy_no_store(flag_no_cache),
         .flag_add_header_date = flag_add_header_date,
         .content_type         = HTTP_CONTENT_TYPE_APPLICATION_JSON,
         .p_content_type_param = NULL,
@@ -65,11 +86,11 @@ http_server_resp_json_generator(const http_resp_code_e http_resp_code, json_stre
     const http_server_resp_t resp = {
         .http_resp_code       = http_resp_code,
         .content_location     = HTTP_CONTENT_LOCATION_JSON_GENERATOR,
-        .flag_no_cache        = flag_no_cache,
+        .cache_policy         = http_server_resp_cache_policy_no_store(flag_no_cache),
         .flag_add_header_date = flag_add_header_date,
         .content_type         = HTTP_CONTENT_TYPE_APPLICATION_JSON,
         .p_content_type_param = NULL,
-        .content_len          = json_stream_gen_calc_size(p_json_gen),
+        .content_len          = SIZE_MAX,
         .content_encoding     = HTTP_CONTENT_ENCODING_NONE,
         .select_location      = {
             .json_generator = {
@@ -77,7 +98,6 @@ http_server_resp_json_generator(const http_resp_code_e http_resp_code, json_stre
             },
         },
     };
-    json_stream_gen_reset(p_json_gen);
     return resp;
 }
 
@@ -93,7 +113,7 @@ http_server_resp_err(const http_resp_code_e http_resp_code)
     const http_server_resp_t resp = {
         .http_resp_code       = http_resp_code,
         .content_location     = HTTP_CONTENT_LOCATION_NO_CONTENT,
-        .flag_no_cache        = true,
+        .cache_policy         = http_server_resp_cache_policy_no_store(true),
         .flag_add_header_date = true,
         .content_type         = HTTP_CONTENT_TYPE_TEXT_HTML,
         .p_content_type_param = NULL,
@@ -118,7 +138,7 @@ http_server_resp_err_json_in_static_mem(const http_resp_code_e http_resp_code, c
     const http_server_resp_t resp = {
         .http_resp_code       = http_resp_code,
         .content_location     = HTTP_CONTENT_LOCATION_STATIC_MEM,
-        .flag_no_cache        = true,
+        .cache_policy         = http_server_resp_cache_policy_no_store(true),
         .flag_add_header_date = true,
         .content_type         = HTTP_CONTENT_TYPE_APPLICATION_JSON,
         .p_content_type_param = NULL,
@@ -143,7 +163,7 @@ http_server_resp_err_json_in_heap(const http_resp_code_e http_resp_code, const c
     const http_server_resp_t resp = {
         .http_resp_code       = http_resp_code,
         .content_location     = HTTP_CONTENT_LOCATION_HEAP,
-        .flag_no_cache        = true,
+        .cache_policy         = http_server_resp_cache_policy_no_store(true),
         .flag_add_header_date = true,
         .content_type         = HTTP_CONTENT_TYPE_APPLICATION_JSON,
         .p_content_type_param = NULL,
@@ -194,6 +214,12 @@ http_server_resp_409(void)
     return http_server_resp_err(HTTP_RESP_CODE_409);
 }
 
+http_server_resp_t
+http_server_resp_413(void)
+{
+    return http_server_resp_err(HTTP_RESP_CODE_413);
+}
+
 http_server_resp_t
 http_server_resp_500(void)
 {
@@ -236,7 +262,7 @@ http_server_resp_data_in_flash(
     const http_server_resp_t resp = {
         .http_resp_code       = HTTP_RESP_CODE_200,
         .content_location     = HTTP_CONTENT_LOCATION_FLASH_MEM,
-        .flag_no_cache        = flag_no_cache,
+        .cache_policy         = http_server_resp_cache_policy_no_store(flag_no_cache),
         .flag_add_header_date = false,
         .content_type         = content_type,
         .p_content_type_param = p_content_type_param,
@@ -251,6 +277,75 @@ http_server_resp_data_in_flash(
     return resp;
 }
 
+http_server_resp_t
+http_server_resp_data_in_flash_with_variants(
+    const http_content_type_e                  content_type,
+    const char*                                p_content_type_param,
+    const size_t                               content_len,
+    const uint8_t*                             p_buf,
+    const http_server_content_variant_t* const p_variants,
+    const uint32_t                             num_variants,
+    const bool                                 flag_no_cache)
+{
+    http_server_resp_t resp = http_server_resp_data_in_flash(
+        content_type,
+        p_content_type_param,
+        content_len,
+        HTTP_CONTENT_ENCODING_NONE,
+        p_buf,
+        flag_no_cache);
+    resp.p_variants   = p_variants;
+    resp.num_variants = num_variants;
+    return resp;
+}
+
+static uint32_t
+http_server_resp_encoding_to_accept_mask(const http_content_encoding_e content_encoding)
+{
+    switch (content_encoding)
+    {
+        case HTTP_CONTENT_ENCODING_NONE:
+            return HTTP_REQ_ACCEPT_ENCODING_IDENTITY;
+        case HTTP_CONTENT_ENCODING_GZIP:
+            return HTTP_REQ_ACCEPT_ENCODING_GZIP;
+        case HTTP_CONTENT_ENCODING_BR:
+            return HTTP_REQ_ACCEPT_ENCODING_BR;
+    }
+    return 0;
+}
+
+void
+http_server_resp_select_variant(http_server_resp_t* const p_resp, const uint32_t accept_encoding)
+{
+    if ((NULL == p_resp->p_variants) || (0 == p_resp->num_variants))
+    {
+        return;
+    }
+    const http_server_content_variant_t* p_selected = NULL;
+    size_t                               min_len    = p_resp->content_len;
+    for (uint32_t i = 0; i < p_resp->num_variants; ++i)
+    {
+        const http_server_content_variant_t* const p_variant = &p_resp->p_variants[i];
+        if ((0 != (http_server_resp_encoding_to_accept_mask(p_variant->content_encoding) & accept_encoding))
+            && (p_variant->content_len < min_len))
+        {
+            p_selected = p_variant;
+            min_len    = p_variant->content_len;
+        }
+    }
+    if (NULL != p_selected)
+    {
+        p_resp->content_encoding             = p_selected->content_encoding;
+        p_resp->content_len                  = p_selected->content_len;
+        p_resp->select_location.memory.p_buf = p_selected->p_buf;
+        // Each representation must have its own strong validator
+        p_resp->etag = p_selected->etag;
+    }
+    p_resp->p_variants         = NULL;
+    p_resp->num_variants       = 0;
+    p_resp->flag_vary_encoding = true;
+}
+
 http_server_resp_t
 http_server_resp_data_in_static_mem(
     const http_content_type_e     content_type,
@@ -264,7 +359,7 @@ http_server_resp_data_in_static_mem(
     const http_server_resp_t resp = {
         .http_resp_code       = HTTP_RESP_CODE_200,
         .content_location     = HTTP_CONTENT_LOCATION_STATIC_MEM,
-        .flag_no_cache        = flag_no_cache,
+        .cache_policy         = http_server_resp_cache_policy_no_store(flag_no_cache),
         .flag_add_header_date = flag_add_header_date,
         .content_type         = content_type,
         .p_content_type_param = p_content_type_param,
@@ -292,7 +387,7 @@ http_server_resp_200_data_in_heap(
     const http_server_resp_t resp = {
         .http_resp_code       = HTTP_RESP_CODE_200,
         .content_location     = HTTP_CONTENT_LOCATION_HEAP,
-        .flag_no_cache        = flag_no_cache,
+        .cache_policy         = http_server_resp_cache_policy_no_store(flag_no_cache),
         .flag_add_header_date = flag_add_header_date,
         .content_type         = content_type,
         .p_content_type_param = p_content_type_param,
@@ -320,7 +415,7 @@ http_server_resp_data_from_file(
     const http_server_resp_t resp = {
         .http_resp_code       = http_resp_code,
         .content_location     = HTTP_CONTENT_LOCATION_FATFS,
-        .flag_no_cache        = flag_no_cache,
+        .cache_policy         = http_server_resp_cache_policy_no_store(flag_no_cache),
         .flag_add_header_date = false,
         .content_type         = content_type,
         .p_content_type_param = p_content_type_param,
@@ -335,6 +430,109 @@ http_server_resp_data_from_file(
     return resp;
 }
 
+void
+http_server_resp_set_cache_policy(
+    http_server_resp_t* const  p_resp,
+    const http_cache_control_e type,
+    const uint32_t             max_age)
+{
+    p_resp->cache_policy.type    = type;
+    p_resp->cache_policy.max_age = max_age;
+}
+
+static bool
+http_server_resp_is_fingerprint(const char* const p_token, const size_t token_len)
+{
+    if (token_len < HTTP_SERVER_CACHE_FINGERPRINT_MIN_LEN)
+    {
+        return false;
+    }
+    for (size_t i = 0; i < token_len; ++i)
+    {
+        if (0 == isxdigit((unsigned char)p_token[i]))
+        {
+            return false;
+        }
+    }
+    return true;
+}
+
+bool
+http_server_resp_is_fingerprinted_path(const char* const p_path)
+{
+    const char* const p_slash = strrchr(p_path, '/');
+    const char*       p_token = (NULL != p_slash) ? (p_slash + 1) : p_path;
+    while ('\0' != *p_token)
+    {
+        const size_t token_len = strcspn(p_token, ".-");
+        if ('\0' == p_token[token_len])
+        {
+            // The last part of the file name (usually the extension) is not a fingerprint
+            break;
+        }
+        if (http_server_resp_is_fingerprint(p_token, token_len))
+        {
+            return true;
+        }
+        p_token += token_len + 1;
+    }
+    return false;
+}
+
+void
+http_server_resp_set_default_cache_policy(http_server_resp_t* const p_resp, const char* const p_path)
+{
+    if (HTTP_CACHE_CONTROL_DEFAULT != p_resp->cache_policy.type)
+    {
+        return;
+    }
+    if ((HTTP_CONTENT_LOCATION_FLASH_MEM != p_resp->content_location)
+        && (HTTP_CONTENT_LOCATION_FATFS != p_resp->content_location))
+    {
+        return;
+    }
+    if ((NULL != p_path) && http_server_resp_is_fingerprinted_path(p_path))
+    {
+        http_server_resp_set_cache_policy(p_resp, HTTP_CACHE_CONTROL_IMMUTABLE, HTTP_SERVER_CACHE_IMMUTABLE_MAX_AGE);
+    }
+}
+
+static uint32_t
+http_server_resp_etag_update(uint32_t hash, const uint8_t* const p_buf, const size_t len)
+{
+    for (size_t i = 0; i < len; ++i)
+    {
+        hash ^= p_buf[i];
+        hash *= HTTP_SERVER_RESP_ETAG_FNV1A_PRIME;
+    }
+    return hash;
+}
+
+uint32_t
+http_server_resp_calc_etag(const uint8_t* const p_buf, const size_t len)
+{
+    const uint32_t hash = http_server_resp_etag_update(HTTP_SERVER_RESP_ETAG_FNV1A_OFFSET_BASIS, p_buf, len);
+    return (0 != hash) ? hash : 1U;
+}
+
+uint32_t
+http_server_resp_calc_etag_for_file(const size_t file_size, const time_t mtime)
+{
+    const uint64_t size_val  = (uint64_t)file_size;
+    const uint64_t mtime_val = (uint64_t)mtime;
+    uint32_t       hash      = HTTP_SERVER_RESP_ETAG_FNV1A_OFFSET_BASIS;
+    hash = http_server_resp_etag_update(hash, (const uint8_t*)&size_val, sizeof(size_val));
+    hash = http_server_resp_etag_update(hash, (const uint8_t*)&mtime_val, sizeof(mtime_val));
+    return (0 != hash) ? hash : 1U;
+}
+
+void
+http_server_resp_set_validators(http_server_resp_t* const p_resp, const uint32_t etag, const time_t last_modified)
+{
+    p_resp->etag          = etag;
+    p_resp->last_modified = last_modified;
+}
+
 static void
 http_server_fill_buf_with_random_u8(uint8_t* const p_buf, const size_t buf_size)
 {
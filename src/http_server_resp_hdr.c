@@ -0,0 +1,181 @@
+/**
+ * @file http_server_resp_hdr.c
+ * @author TheSomeMan
+ * @date 2026-10-17
+ * @copyright Ruuvi Innovations Ltd, license BSD-3-Clause.
+ */
+
+#include "http_server_resp_hdr.h"
+#include <stdio.h>
+#include <string.h>
+#include <time.h>
+#include "os_mutex.h"
+
+#define HTTP_SERVER_RESP_HDR_UINT_MAX_DIGITS (20U)
+
+#define HTTP_SERVER_RESP_HDR_LAST_MODIFIED_EXAMPLE "Last-Modified: Thu, 01 Jan 2021 00:00:00 GMT\r\n"
+
+static const char g_http_server_resp_hdr_no_store[]
+    = "Cache-Control: no-store, no-cache, must-revalidate, max-age=0\r\n"
+      "Pragma: no-cache\r\n";
+
+typedef struct http_server_resp_hdr_date_cache_t
+{
+    bool   flag_valid;
+    time_t time;
+    char   buf[sizeof(HTTP_SERVER_RESP_HDR_DATE_EXAMPLE)];
+} http_server_resp_hdr_date_cache_t;
+
+static os_mutex_static_t                 g_http_server_resp_hdr_mutex_mem;
+static os_mutex_t                        g_http_server_resp_hdr_mutex;
+static http_server_resp_hdr_date_cache_t g_http_server_resp_hdr_date_cache;
+
+void
+http_server_resp_hdr_init(void)
+{
+    if (NULL == g_http_server_resp_hdr_mutex)
+    {
+        g_http_server_resp_hdr_mutex = os_mutex_create_static(&g_http_server_resp_hdr_mutex_mem);
+    }
+}
+
+void
+http_server_resp_hdr_begin(http_server_resp_hdr_t* const p_hdr, char* const p_buf, const size_t buf_size)
+{
+    p_hdr->p_buf         = p_buf;
+    p_hdr->buf_size      = buf_size;
+    p_hdr->len           = 0;
+    p_hdr->flag_overflow = (0 == buf_size) ? true : false;
+}
+
+void
+http_server_resp_hdr_add_mem(http_server_resp_hdr_t* const p_hdr, const char* const p_data, const size_t len)
+{
+    if (p_hdr->flag_overflow)
+    {
+        return;
+    }
+    if (len >= (p_hdr->buf_size - p_hdr->len))
+    {
+        p_hdr->flag_overflow = true;
+        return;
+    }
+    memcpy(&p_hdr->p_buf[p_hdr->len], p_data, len);
+    p_hdr->len += len;
+}
+
+void
+http_server_resp_hdr_add_str(http_server_resp_hdr_t* const p_hdr, const char* const p_str)
+{
+    http_server_resp_hdr_add_mem(p_hdr, p_str, strlen(p_str));
+}
+
+void
+http_server_resp_hdr_add_uint(http_server_resp_hdr_t* const p_hdr, const size_t val)
+{
+    char   digits[HTTP_SERVER_RESP_HDR_UINT_MAX_DIGITS];
+    size_t idx = sizeof(digits);
+    size_t rem = val;
+    do
+    {
+        idx -= 1;
+        digits[idx] = (char)('0' + (rem % 10U));
+        rem /= 10U;
+    } while (0 != rem);
+    http_server_resp_hdr_add_mem(p_hdr, &digits[idx], sizeof(digits) - idx);
+}
+
+void
+http_server_resp_hdr_add_status_line(
+    http_server_resp_hdr_t* const p_hdr,
+    const bool                    flag_http_1_1,
+    const http_resp_code_e        resp_code,
+    const char* const             p_status_msg)
+{
+    http_server_resp_hdr_add_str(p_hdr, flag_http_1_1 ? "HTTP/1.1 " : "HTTP/1.0 ");
+    http_server_resp_hdr_add_uint(p_hdr, (size_t)resp_code);
+    http_server_resp_hdr_add_str(p_hdr, " ");
+    http_server_resp_hdr_add_str(p_hdr, p_status_msg);
+    http_server_resp_hdr_add_str(p_hdr, "\r\n");
+}
+
+void
+http_server_resp_hdr_add_date(http_server_resp_hdr_t* const p_hdr)
+{
+    http_server_resp_hdr_date_cache_t* const p_cache  = &g_http_server_resp_hdr_date_cache;
+    const time_t                             cur_time = time(NULL);
+
+    os_mutex_lock(g_http_server_resp_hdr_mutex);
+    if ((!p_cache->flag_valid) || (cur_time != p_cache->time))
+    {
+        struct tm tm_time = { 0 };
+        gmtime_r(&cur_time, &tm_time);
+        (void)strftime(p_cache->buf, sizeof(p_cache->buf), "Date: %a, %d %b %Y %H:%M:%S GMT\r\n", &tm_time);
+        p_cache->time       = cur_time;
+        p_cache->flag_valid = true;
+    }
+    http_server_resp_hdr_add_str(p_hdr, p_cache->buf);
+    os_mutex_unlock(g_http_server_resp_hdr_mutex);
+}
+
+bool
+http_server_resp_hdr_end(http_server_resp_hdr_t* const p_hdr)
+{
+    if (p_hdr->flag_overflow)
+    {
+        return false;
+    }
+    p_hdr->p_buf[p_hdr->len] = '\0';
+    return true;
+}
+
+void
+http_server_resp_hdr_add_cache_control(http_server_resp_hdr_t* const p_hdr, const http_server_resp_t* const p_resp)
+{
+    switch (p_resp->cache_policy.type)
+    {
+        case HTTP_CACHE_CONTROL_DEFAULT:
+            break;
+        case HTTP_CACHE_CONTROL_NO_STORE:
+            http_server_resp_hdr_add_str(p_hdr, g_http_server_resp_hdr_no_store);
+            break;
+        case HTTP_CACHE_CONTROL_MAX_AGE:
+            http_server_resp_hdr_add_str(p_hdr, "Cache-Control: max-age=");
+            http_server_resp_hdr_add_uint(p_hdr, p_resp->cache_policy.max_age);
+            http_server_resp_hdr_add_str(p_hdr, "\r\n");
+            break;
+        case HTTP_CACHE_CONTROL_IMMUTABLE:
+            http_server_resp_hdr_add_str(p_hdr, "Cache-Control: public, max-age=");
+            http_server_resp_hdr_add_uint(p_hdr, p_resp->cache_policy.max_age);
+            http_server_resp_hdr_add_str(p_hdr, ", immutable\r\n");
+            break;
+    }
+}
+
+http_server_resp_hdr_etag_str_t
+http_server_resp_hdr_etag_to_str(const uint32_t etag)
+{
+    http_server_resp_hdr_etag_str_t etag_str = { 0 };
+    (void)snprintf(etag_str.buf, sizeof(etag_str.buf), "\"%08lx\"", (printf_ulong_t)etag);
+    return etag_str;
+}
+
+void
+http_server_resp_hdr_add_validators(http_server_resp_hdr_t* const p_hdr, const http_server_resp_t* const p_resp)
+{
+    if (0 != p_resp->etag)
+    {
+        const http_server_resp_hdr_etag_str_t etag_str = http_server_resp_hdr_etag_to_str(p_resp->etag);
+        http_server_resp_hdr_add_str(p_hdr, "ETag: ");
+        http_server_resp_hdr_add_str(p_hdr, etag_str.buf);
+        http_server_resp_hdr_add_str(p_hdr, "\r\n");
+    }
+    if (0 != p_resp->last_modified)
+    {
+        struct tm tm_time = { 0 };
+        char      buf[sizeof(HTTP_SERVER_RESP_HDR_LAST_MODIFIED_EXAMPLE)];
+        gmtime_r(&p_resp->last_modified, &tm_time);
+        (void)strftime(buf, sizeof(buf), "Last-Modified: %a, %d %b %Y %H:%M:%S GMT\r\n", &tm_time);
+        http_server_resp_hdr_add_str(p_hdr, buf);
+    }
+}
@@ -0,0 +1,113 @@
+/**
+ * @file http_server_resp_hdr.h
+ * @author TheSomeMan
+ * @date 2026-10-17
+ * @copyright Ruuvi Innovations Ltd, license BSD-3-Clause.
+ */
+
+#ifndef RUUVI_ESP_WIFI_MANAGER_HTTP_SERVER_RESP_HDR_H
+#define RUUVI_ESP_WIFI_MANAGER_HTTP_SERVER_RESP_HDR_H
+
+#include <stdbool.h>
+#include <stddef.h>
+#include "wifi_manager_defs.h"
+
+#ifdef __cplusplus
+extern "C" {
+#endif
+
+#define HTTP_SERVER_RESP_HDR_DATE_EXAMPLE "Date: Thu, 01 Jan 2021 00:00:00 GMT\r\n"
+#define HTTP_SERVER_RESP_HDR_ETAG_EXAMPLE "\"0123abcd\""
+
+/**
+ * @brief The builder of the header of HTTP response in a fixed buffer (without heap allocation).
+ * @note If the buffer is too small, then flag_overflow is set and the rest of the data is ignored.
+ */
+typedef struct http_server_resp_hdr_t
+{
+    char*  p_buf;
+    size_t buf_size;
+    size_t len;
+    bool   flag_overflow;
+} http_server_resp_hdr_t;
+
+typedef struct http_server_resp_hdr_etag_str_t
+{
+    char buf[sizeof(HTTP_SERVER_RESP_HDR_ETAG_EXAMPLE)];
+} http_server_resp_hdr_etag_str_t;
+
+/**
+ * @brief Create the mutex which protects the cached "Date" header field.
+ * @note This function should be called once from http_server_init.
+ */
+void
+http_server_resp_hdr_init(void);
+
+/**
+ * @brief Start building the header in the buffer.
+ * @param p_hdr - ptr to the builder
+ * @param p_buf - ptr to the buffer
+ * @param buf_size - size of the buffer (one byte is reserved for the terminating '\0')
+ */
+void
+http_server_resp_hdr_begin(http_server_resp_hdr_t* const p_hdr, char* const p_buf, const size_t buf_size);
+
+void
+http_server_resp_hdr_add_mem(http_server_resp_hdr_t* const p_hdr, const char* const p_data, const size_t len);
+
+void
+http_server_resp_hdr_add_str(http_server_resp_hdr_t* const p_hdr, const char* const p_str);
+
+/**
+ * @brief Append the decimal representation of the value.
+ */
+void
+http_server_resp_hdr_add_uint(http_server_resp_hdr_t* const p_hdr, const size_t val);
+
+/**
+ * @brief Append the status line, e.g. "HTTP/1.1 200 OK\r\n".
+ */
+void
+http_server_resp_hdr_add_status_line(
+    http_server_resp_hdr_t* const p_hdr,
+    const bool                    flag_http_1_1,
+    const http_resp_code_e        resp_code,
+    const char* const             p_status_msg);
+
+/**
+ * @brief Append the "Date" header field.
+ * @note The string is formatted once per second and reused by all the responses sent within this second.
+ */
+void
+http_server_resp_hdr_add_date(http_server_resp_hdr_t* const p_hdr);
+
+/**
+ * @brief Convert the validator of the content to the entity tag (the quoted string of 8 hex digits).
+ */
+http_server_resp_hdr_etag_str_t
+http_server_resp_hdr_etag_to_str(const uint32_t etag);
+
+/**
+ * @brief Add "Cache-Control" header field according to the cache policy of the response.
+ */
+void
+http_server_resp_hdr_add_cache_control(http_server_resp_hdr_t* const p_hdr, const http_server_resp_t* const p_resp);
+
+/**
+ * @brief Add "ETag" and "Last-Modified" header fields if the validators are set in the response.
+ */
+void
+http_server_resp_hdr_add_validators(http_server_resp_hdr_t* const p_hdr, const http_server_resp_t* const p_resp);
+
+/**
+ * @brief Terminate the header with '\0'.
+ * @return false if the buffer was too small.
+ */
+bool
+http_server_resp_hdr_end(http_server_resp_hdr_t* const p_hdr);
+
+#ifdef __cplusplus
+}
+#endif
+
+#endif // RUUVI_ESP_WIFI_MANAGER_HTTP_SERVER_RESP_HDR_H
@@ -0,0 +1,348 @@
+/**
+ * @file http_server_route.c
+ * @author TheSomeMan
+ * @date 2026-10-17
+ * @copyright Ruuvi Innovations Ltd, license BSD-3-Clause.
+ */
+
+#include "http_server_route.h"
+#include "http_server_route_internal.h"
+#include <string.h>
+#include "os_mutex.h"
+#include "http_server_cfg.h"
+
+#define LOG_LOCAL_LEVEL LOG_LEVEL_INFO
+#include "log.h"
+
+#define HTTP_SERVER_ROUTE_FNV1A_OFFSET_BASIS (2166136261U)
+#define HTTP_SERVER_ROUTE_FNV1A_PRIME        (16777619U)
+
+#define HTTP_SERVER_ROUTE_BUILTIN_HASH_TABLE_SIZE (16U) // Must be a power of 2
+#define HTTP_SERVER_ROUTE_BUILTIN_HASH_MAX_SEED   (10000U)
+#define HTTP_SERVER_ROUTE_BUILTIN_SLOT_FREE       (0xFFU)
+
+typedef struct http_server_route_builtin_t
+{
+    http_server_route_method_e method;
+    const char*                p_path;
+    http_server_route_policy_t policy;
+} http_server_route_builtin_t;
+
+typedef struct http_server_route_app_t
+{
+    bool                is_used;
+    uint32_t            hash;
+    http_server_route_t route;
+} http_server_route_app_t;
+
+static const char TAG[] = "http_server";
+
+// The order of the built-in routes must match http_server_route_id_e
+static const http_server_route_builtin_t g_http_server_route_builtin[HTTP_SERVER_ROUTE_ID_NUM_BUILTIN] = {
+    [HTTP_SERVER_ROUTE_ID_GET_AUTH] = {
+        .method = HTTP_SERVER_ROUTE_METHOD_GET,
+        .p_path = "auth",
+        .policy = { .auth = HTTP_SERVER_ROUTE_AUTH_NONE, .flag_lan_allowed = true, },
+    },
+    [HTTP_SERVER_ROUTE_ID_GET_AP_JSON] = {
+        .method = HTTP_SERVER_ROUTE_METHOD_GET,
+        .p_path = "ap.json",
+        .policy = { .auth = HTTP_SERVER_ROUTE_AUTH_BEARER_RW, .flag_lan_allowed = true, },
+    },
+    [HTTP_SERVER_ROUTE_ID_GET_STATUS_JSON] = {
+        .method = HTTP_SERVER_ROUTE_METHOD_GET,
+        .p_path = "status.json",
+        .policy = { .auth = HTTP_SERVER_ROUTE_AUTH_REQUIRED, .flag_lan_allowed = true, },
+    },
+    [HTTP_SERVER_ROUTE_ID_POST_AUTH] = {
+        .method = HTTP_SERVER_ROUTE_METHOD_POST,
+        .p_path = "auth",
+        .policy = { .auth = HTTP_SERVER_ROUTE_AUTH_NONE, .flag_lan_allowed = true, },
+    },
+    [HTTP_SERVER_ROUTE_ID_POST_CONNECT_JSON] = {
+        .method = HTTP_SERVER_ROUTE_METHOD_POST,
+        .p_path = "connect.json",
+        .policy = { .auth = HTTP_SERVER_ROUTE_AUTH_BEARER_RW, .flag_lan_allowed = false, },
+    },
+    [HTTP_SERVER_ROUTE_ID_POST_CONNECT_WPS] = {
+        .method = HTTP_SERVER_ROUTE_METHOD_POST,
+        .p_path = "connect_wps",
+        .policy = { .auth = HTTP_SERVER_ROUTE_AUTH_BEARER_RW, .flag_lan_allowed = false, },
+    },
+    [HTTP_SERVER_ROUTE_ID_DELETE_AUTH] = {
+        .method = HTTP_SERVER_ROUTE_METHOD_DELETE,
+        .p_path = "auth",
+        .policy = { .auth = HTTP_SERVER_ROUTE_AUTH_BEARER_RW, .flag_lan_allowed = true, },
+    },
+    [HTTP_SERVER_ROUTE_ID_DELETE_CONNECT_JSON] = {
+        .method = HTTP_SERVER_ROUTE_METHOD_DELETE,
+        .p_path = "connect.json",
+        .policy = { .auth = HTTP_SERVER_ROUTE_AUTH_BEARER_RW, .flag_lan_allowed = false, },
+    },
+};
+
+static uint32_t g_http_server_route_builtin_seed;
+static bool     g_http_server_route_builtin_flag_perfect_hash;
+static uint8_t  g_http_server_route_builtin_slots[HTTP_SERVER_ROUTE_BUILTIN_HASH_TABLE_SIZE];
+
+static os_mutex_static_t       g_http_server_route_mutex_mem;
+static os_mutex_t              g_http_server_route_mutex;
+static http_server_route_app_t g_http_server_route_app[HTTP_SERVER_MAX_APP_ROUTES];
+
+static uint32_t
+http_server_route_calc_hash(const uint32_t seed, const http_server_route_method_e method, const char* const p_path)
+{
+    uint32_t hash = (HTTP_SERVER_ROUTE_FNV1A_OFFSET_BASIS ^ seed) * HTTP_SERVER_ROUTE_FNV1A_PRIME;
+    hash          = (hash ^ (uint32_t)method) * HTTP_SERVER_ROUTE_FNV1A_PRIME;
+    for (const char* p_ch = p_path; '\0' != *p_ch; ++p_ch)
+    {
+        hash = (hash ^ (uint32_t)(unsigned char)*p_ch) * HTTP_SERVER_ROUTE_FNV1A_PRIME;
+    }
+    return hash;
+}
+
+static uint32_t
+http_server_route_builtin_calc_slot(const uint32_t seed, const http_server_route_method_e method, const char* p_path)
+{
+    return http_server_route_calc_hash(seed, method, p_path) & (HTTP_SERVER_ROUTE_BUILTIN_HASH_TABLE_SIZE - 1U);
+}
+
+/**
+ * @brief Try to place all the built-in routes into the hash table without collisions using the given seed.
+ */
+static bool
+http_server_route_builtin_try_seed(const uint32_t seed)
+{
+    memset(
+        g_http_server_route_builtin_slots,
+        HTTP_SERVER_ROUTE_BUILTIN_SLOT_FREE,
+        sizeof(g_http_server_route_builtin_slots));
+    for (uint32_t i = 0; i < HTTP_SERVER_ROUTE_ID_NUM_BUILTIN; ++i)
+    {
+        const http_server_route_builtin_t* const p_builtin = &g_http_server_route_builtin[i];
+
+        const uint32_t slot = http_server_route_builtin_calc_slot(seed, p_builtin->method, p_builtin->p_path);
+        if (HTTP_SERVER_ROUTE_BUILTIN_SLOT_FREE != g_http_server_route_builtin_slots[slot])
+        {
+            return false;
+        }
+        g_http_server_route_builtin_slots[slot] = (uint8_t)i;
+    }
+    return true;
+}
+
+void
+http_server_route_init(void)
+{
+    if (NULL == g_http_server_route_mutex)
+    {
+        g_http_server_route_mutex = os_mutex_create_static(&g_http_server_route_mutex_mem);
+    }
+    if (g_http_server_route_builtin_flag_perfect_hash)
+    {
+        return;
+    }
+    // The set of the built-in routes is fixed, so the search of the seed always gives the same result.
+    for (uint32_t seed = 0; seed < HTTP_SERVER_ROUTE_BUILTIN_HASH_MAX_SEED; ++seed)
+    {
+        if (http_server_route_builtin_try_seed(seed))
+        {
+            g_http_server_route_builtin_seed              = seed;
+            g_http_server_route_builtin_flag_perfect_hash = true;
+            LOG_DBG("Built-in routes: seed of perfect hash: %u", (printf_uint_t)seed);
+            return;
+        }
+    }
+    LOG_ERR("Failed to find the seed of perfect hash for the built-in routes, use linear search");
+}
+
+bool
+http_server_route_parse_method(const char* const p_method, http_server_route_method_e* const p_method_id)
+{
+    if (0 == strcmp("GET", p_method))
+    {
+        *p_method_id = HTTP_SERVER_ROUTE_METHOD_GET;
+        return true;
+    }
+    if (0 == strcmp("HEAD", p_method))
+    {
+        // HEAD is handled as GET, the content of the response is dropped by the server
+        *p_method_id = HTTP_SERVER_ROUTE_METHOD_GET;
+        return true;
+    }
+    if (0 == strcmp("POST", p_method))
+    {
+        *p_method_id = HTTP_SERVER_ROUTE_METHOD_POST;
+        return true;
+    }
+    if (0 == strcmp("DELETE", p_method))
+    {
+        *p_method_id = HTTP_SERVER_ROUTE_METHOD_DELETE;
+        return true;
+    }
+    return false;
+}
+
+static void
+http_server_route_builtin_copy(const http_server_route_id_e id, http_server_route_t* const p_route)
+{
+    const http_server_route_builtin_t* const p_builtin = &g_http_server_route_builtin[id];
+
+    p_route->id          = id;
+    p_route->method      = p_builtin->method;
+    p_route->p_path      = p_builtin->p_path;
+    p_route->policy      = p_builtin->policy;
+    p_route->handler     = NULL;
+    p_route->p_user_data = NULL;
+}
+
+static bool
+http_server_route_builtin_is_match(
+    const http_server_route_id_e     id,
+    const http_server_route_method_e method,
+    const char* const                p_path)
+{
+    const http_server_route_builtin_t* const p_builtin = &g_http_server_route_builtin[id];
+    return (method == p_builtin->method) && (0 == strcmp(p_path, p_builtin->p_path));
+}
+
+static bool
+http_server_route_builtin_find(
+    const http_server_route_method_e method,
+    const char* const                p_path,
+    http_server_route_t* const       p_route)
+{
+    if (g_http_server_route_builtin_flag_perfect_hash)
+    {
+        const uint32_t slot = http_server_route_builtin_calc_slot(g_http_server_route_builtin_seed, method, p_path);
+        const uint8_t  idx  = g_http_server_route_builtin_slots[slot];
+        if ((HTTP_SERVER_ROUTE_BUILTIN_SLOT_FREE == idx)
+            || (!http_server_route_builtin_is_match((http_server_route_id_e)idx, method, p_path)))
+        {
+            return false;
+        }
+        http_server_route_builtin_copy((http_server_route_id_e)idx, p_route);
+        return true;
+    }
+    for (uint32_t i = 0; i < HTTP_SERVER_ROUTE_ID_NUM_BUILTIN; ++i)
+    {
+        if (http_server_route_builtin_is_match((http_server_route_id_e)i, method, p_path))
+        {
+            http_server_route_builtin_copy((http_server_route_id_e)i, p_route);
+            return true;
+        }
+    }
+    return false;
+}
+
+/**
+ * @note This function must be called with g_http_server_route_mutex locked.
+ */
+static http_server_route_app_t*
+http_server_route_app_find(const http_server_route_method_e method, const char* const p_path, const uint32_t hash)
+{
+    for (uint32_t i = 0; i < HTTP_SERVER_MAX_APP_ROUTES; ++i)
+    {
+        http_server_route_app_t* const p_app = &g_http_server_route_app[i];
+        if (p_app->is_used && (hash == p_app->hash) && (method == p_app->route.method)
+            && (0 == strcmp(p_path, p_app->route.p_path)))
+        {
+            return p_app;
+        }
+    }
+    return NULL;
+}
+
+bool
+http_server_route_find(
+    const http_server_route_method_e method,
+    const char* const                p_path,
+    http_server_route_t* const       p_route)
+{
+    if (http_server_route_builtin_find(method, p_path, p_route))
+    {
+        return true;
+    }
+    const uint32_t hash = http_server_route_calc_hash(0, method, p_path);
+
+    os_mutex_lock(g_http_server_route_mutex);
+    const http_server_route_app_t* const p_app = http_server_route_app_find(method, p_path, hash);
+    if (NULL != p_app)
+    {
+        *p_route = p_app->route;
+    }
+    os_mutex_unlock(g_http_server_route_mutex);
+
+    return (NULL != p_app) ? true : false;
+}
+
+static const char*
+http_server_route_skip_slash(const char* const p_path)
+{
+    return ('/' == p_path[0]) ? &p_path[1] : p_path;
+}
+
+bool
+http_server_route_register(
+    const http_server_route_method_e  method,
+    const char* const                 p_path,
+    const http_server_route_policy_t  policy,
+    const http_server_route_handler_t handler,
+    void* const                       p_user_data)
+{
+    const char* const   p_route_path = http_server_route_skip_slash(p_path);
+    http_server_route_t route_tmp    = { 0 };
+    if ((NULL == handler) || http_server_route_builtin_find(method, p_route_path, &route_tmp))
+    {
+        LOG_ERR("Can't register route for path '/%s'", p_route_path);
+        return false;
+    }
+    const uint32_t hash = http_server_route_calc_hash(0, method, p_route_path);
+
+    bool flag_registered = false;
+    os_mutex_lock(g_http_server_route_mutex);
+    if (NULL == http_server_route_app_find(method, p_route_path, hash))
+    {
+        for (uint32_t i = 0; i < HTTP_SERVER_MAX_APP_ROUTES; ++i)
+        {
+            http_server_route_app_t* const p_app = &g_http_server_route_app[i];
+            if (!p_app->is_used)
+            {
+                p_app->route.id          = HTTP_SERVER_ROUTE_ID_APP;
+                p_app->route.method      = method;
+                p_app->route.p_path      = p_route_path;
+                p_app->route.policy      = policy;
+                p_app->route.handler     = handler;
+                p_app->route.p_user_data = p_user_data;
+                p_app->hash              = hash;
+                p_app->is_used           = true;
+                flag_registered          = true;
+                break;
+            }
+        }
+    }
+    os_mutex_unlock(g_http_server_route_mutex);
+
+    if (!flag_registered)
+    {
+        LOG_ERR("Can't register route for path '/%s': already registered or no free slots", p_route_path);
+    }
+    return flag_registered;
+}
+
+bool
+http_server_route_unregister(const http_server_route_method_e method, const char* const p_path)
+{
+    const char* const p_route_path = http_server_route_skip_slash(p_path);
+    const uint32_t    hash         = http_server_route_calc_hash(0, method, p_route_path);
+
+    os_mutex_lock(g_http_server_route_mutex);
+    http_server_route_app_t* const p_app = http_server_route_app_find(method, p_route_path, hash);
+    if (NULL != p_app)
+    {
+        p_app->is_used = false;
+    }
+    os_mutex_unlock(g_http_server_route_mutex);
+
+    return (NULL != p_app) ? true : false;
+}
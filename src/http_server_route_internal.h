@@ -0,0 +1,74 @@
+/**
+ * @file http_server_route_internal.h
+ * @author TheSomeMan
+ * @date 2026-10-17
+ * @copyright Ruuvi Innovations Ltd, license BSD-3-Clause.
+ */
+
+#ifndef RUUVI_ESP_WIFI_MANAGER_HTTP_SERVER_ROUTE_INTERNAL_H
+#define RUUVI_ESP_WIFI_MANAGER_HTTP_SERVER_ROUTE_INTERNAL_H
+
+#include <stdbool.h>
+#include <stdint.h>
+#include "http_server_route.h"
+
+#ifdef __cplusplus
+extern "C" {
+#endif
+
+typedef enum http_server_route_id_e
+{
+    HTTP_SERVER_ROUTE_ID_GET_AUTH,
+    HTTP_SERVER_ROUTE_ID_GET_AP_JSON,
+    HTTP_SERVER_ROUTE_ID_GET_STATUS_JSON,
+    HTTP_SERVER_ROUTE_ID_POST_AUTH,
+    HTTP_SERVER_ROUTE_ID_POST_CONNECT_JSON,
+    HTTP_SERVER_ROUTE_ID_POST_CONNECT_WPS,
+    HTTP_SERVER_ROUTE_ID_DELETE_AUTH,
+    HTTP_SERVER_ROUTE_ID_DELETE_CONNECT_JSON,
+    HTTP_SERVER_ROUTE_ID_NUM_BUILTIN,
+    HTTP_SERVER_ROUTE_ID_APP = HTTP_SERVER_ROUTE_ID_NUM_BUILTIN, // The route registered by the application
+    HTTP_SERVER_ROUTE_ID_APP_CALLBACK, // Not registered, the request is passed to the HTTP callbacks of the application
+} http_server_route_id_e;
+
+typedef struct http_server_route_t
+{
+    http_server_route_id_e      id;
+    http_server_route_method_e  method;
+    const char*                 p_path;
+    http_server_route_policy_t  policy;
+    http_server_route_handler_t handler;     // NULL for the built-in routes
+    void*                       p_user_data; // NULL for the built-in routes
+} http_server_route_t;
+
+/**
+ * @brief Create the mutex which protects the routes of the application
+ *        and calculate the seed of the perfect hash of the built-in routes.
+ * @note This function should be called once from http_server_init.
+ */
+void
+http_server_route_init(void);
+
+/**
+ * @brief Convert the method of the request to http_server_route_method_e.
+ * @return false if the method is not supported.
+ */
+bool
+http_server_route_parse_method(const char* const p_method, http_server_route_method_e* const p_method_id);
+
+/**
+ * @brief Find the route for the method and the path (without the leading '/').
+ * @param[out] p_route - the copy of the route
+ * @return false if the route was not found.
+ */
+bool
+http_server_route_find(
+    const http_server_route_method_e method,
+    const char* const                p_path,
+    http_server_route_t* const       p_route);
+
+#ifdef __cplusplus
+}
+#endif
+
+#endif // RUUVI_ESP_WIFI_MANAGER_HTTP_SERVER_ROUTE_INTERNAL_H
@@ -0,0 +1,173 @@
+/**
+ * @file http_server_workers.c
+ * @author TheSomeMan
+ * @date 2026-10-17
+ * @copyright Ruuvi Innovations Ltd, license BSD-3-Clause.
+ */
+
+#include "http_server_workers.h"
+#include <esp_task_wdt.h>
+#include "freertos/FreeRTOS.h"
+#include "freertos/queue.h"
+#include "os_task.h"
+#include "esp_type_wrapper.h"
+#include "http_server.h"
+#include "http_server_cfg.h"
+#include "http_server_accept_and_handle_conn.h"
+
+#define LOG_LOCAL_LEVEL LOG_LEVEL_INFO
+#include "log.h"
+
+#define HTTP_SERVER_WORKER_TASK_PRIORITY (1)
+
+static const char TAG[] = "http_server";
+
+static QueueHandle_t gh_http_server_conn_queue;
+static StaticQueue_t g_http_server_conn_queue_mem;
+static uint8_t       g_http_server_conn_queue_storage[HTTP_SERVER_CONN_QUEUE_LEN * sizeof(struct netconn*)];
+
+static volatile uint32_t g_http_server_conn_queue_depth_max;
+static volatile uint32_t g_http_server_cnt_conn_dispatched;
+
+void
+http_server_workers_init(void)
+{
+    if (NULL != gh_http_server_conn_queue)
+    {
+        return;
+    }
+    gh_http_server_conn_queue = xQueueCreateStatic(
+        HTTP_SERVER_CONN_QUEUE_LEN,
+        sizeof(struct netconn*),
+        g_http_server_conn_queue_storage,
+        &g_http_server_conn_queue_mem);
+    if (NULL == gh_http_server_conn_queue)
+    {
+        LOG_ERR("%s failed", "xQueueCreateStatic");
+    }
+}
+
+static void
+http_server_worker_task_wdt_add(void)
+{
+    const esp_err_t err = esp_task_wdt_add(xTaskGetCurrentTaskHandle());
+    if (ESP_OK != err)
+    {
+        LOG_ERR_ESP(err, "%s failed", "esp_task_wdt_add");
+    }
+}
+
+static void
+http_server_worker_task_wdt_delete(void)
+{
+    const esp_err_t err = esp_task_wdt_delete(xTaskGetCurrentTaskHandle());
+    if (ESP_OK != err)
+    {
+        LOG_ERR_ESP(err, "%s failed", "esp_task_wdt_delete");
+    }
+}
+
+static void
+http_server_worker_task(void)
+{
+    LOG_INFO("HTTP-Server worker started");
+    for (;;)
+    {
+        struct netconn* p_conn = NULL;
+        if (pdPASS != xQueueReceive(gh_http_server_conn_queue, &p_conn, portMAX_DELAY))
+        {
+            LOG_ERR("%s failed", "xQueueReceive");
+            continue;
+        }
+        if (NULL == p_conn)
+        {
+            // NULL is sent by http_server_workers_stop
+            break;
+        }
+        // The task watchdog is used only while the connection is being served,
+        // the idle worker is blocked in xQueueReceive and does not wake up.
+        http_server_worker_task_wdt_add();
+        http_server_handle_conn(p_conn);
+        http_server_worker_task_wdt_delete();
+    }
+    LOG_INFO("HTTP-Server worker stopped");
+}
+
+void
+http_server_workers_start(void)
+{
+    if (NULL == gh_http_server_conn_queue)
+    {
+        return;
+    }
+    for (uint32_t i = 0; i < HTTP_SERVER_NUM_WORKERS; ++i)
+    {
+        if (!os_task_create_finite_without_param(
+                &http_server_worker_task,
+                "http_worker",
+                HTTP_SERVER_WORKER_STACK_SIZE,
+                HTTP_SERVER_WORKER_TASK_PRIORITY))
+        {
+            LOG_ERR("xTaskCreate failed: http_worker");
+        }
+    }
+}
+
+void
+http_server_workers_stop(void)
+{
+    if (NULL == gh_http_server_conn_queue)
+    {
+        return;
+    }
+    struct netconn* const p_conn_stop = NULL;
+    for (uint32_t i = 0; i < HTTP_SERVER_NUM_WORKERS; ++i)
+    {
+        if (pdPASS != xQueueSend(gh_http_server_conn_queue, &p_conn_stop, portMAX_DELAY))
+        {
+            LOG_ERR("%s failed", "xQueueSend");
+        }
+    }
+}
+
+bool
+http_server_workers_push_conn(struct netconn* const p_conn, const os_delta_ticks_t timeout_ticks)
+{
+    if (pdPASS != xQueueSend(gh_http_server_conn_queue, &p_conn, timeout_ticks))
+    {
+        LOG_DBG("Queue of connections is full");
+        return false;
+    }
+    g_http_server_cnt_conn_dispatched += 1;
+
+    const uint32_t queue_depth = http_server_workers_get_queue_depth();
+    if (queue_depth > g_http_server_conn_queue_depth_max)
+    {
+        g_http_server_conn_queue_depth_max = queue_depth;
+    }
+    LOG_DBG(
+        "Connection queued for workers: queue depth %u/%u",
+        (printf_uint_t)queue_depth,
+        (printf_uint_t)HTTP_SERVER_CONN_QUEUE_LEN);
+    return true;
+}
+
+uint32_t
+http_server_workers_get_queue_depth(void)
+{
+    if (NULL == gh_http_server_conn_queue)
+    {
+        return 0;
+    }
+    return (uint32_t)uxQueueMessagesWaiting(gh_http_server_conn_queue);
+}
+
+void
+http_server_get_conn_queue_stat(http_server_conn_queue_stat_t* const p_stat)
+{
+    p_stat->num_workers         = HTTP_SERVER_NUM_WORKERS;
+    p_stat->queue_len           = HTTP_SERVER_CONN_QUEUE_LEN;
+    p_stat->queue_depth         = http_server_workers_get_queue_depth();
+    p_stat->queue_depth_max     = g_http_server_conn_queue_depth_max;
+    p_stat->cnt_conn_dispatched = g_http_server_cnt_conn_dispatched;
+}
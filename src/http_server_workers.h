@@ -0,0 +1,58 @@
+/**
+ * @file http_server_workers.h
+ * @author TheSomeMan
+ * @date 2026-10-17
+ * @copyright Ruuvi Innovations Ltd, license BSD-3-Clause.
+ */
+
+#ifndef RUUVI_ESP_WIFI_MANAGER_HTTP_SERVER_WORKERS_H
+#define RUUVI_ESP_WIFI_MANAGER_HTTP_SERVER_WORKERS_H
+
+#include <stdbool.h>
+#include <stdint.h>
+#include "os_wrapper_types.h"
+#include "lwip/api.h"
+
+#ifdef __cplusplus
+extern "C" {
+#endif
+
+/**
+ * @brief Create the queue of accepted connections.
+ * @note This function should be called once from http_server_init.
+ */
+void
+http_server_workers_init(void);
+
+/**
+ * @brief Create HTTP_SERVER_NUM_WORKERS worker tasks which serve the connections from the queue.
+ */
+void
+http_server_workers_start(void);
+
+/**
+ * @brief Request the worker tasks to finish after serving the connections which are already in the queue.
+ */
+void
+http_server_workers_stop(void);
+
+/**
+ * @brief Pass the accepted connection to the worker tasks.
+ * @param p_conn - ptr to the accepted connection, the worker closes and deletes it after serving.
+ * @param timeout_ticks - max time to wait for free space in the queue.
+ * @return true if the connection was placed to the queue, false if the queue is still full after timeout.
+ */
+bool
+http_server_workers_push_conn(struct netconn* const p_conn, const os_delta_ticks_t timeout_ticks);
+
+/**
+ * @brief Get the number of accepted connections waiting in the queue for a free worker.
+ */
+uint32_t
+http_server_workers_get_queue_depth(void);
+
+#ifdef __cplusplus
+}
+#endif
+
+#endif // RUUVI_ESP_WIFI_MANAGER_HTTP_SERVER_WORKERS_H
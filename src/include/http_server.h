@@ -51,6 +51,30 @@ typedef enum http_server_user_req_code_e
     HTTP_SERVER_USER_REQ_CODE_2 = 2,
 } http_server_user_req_code_e;
 
+typedef struct http_server_conn_queue_stat_t
+{
+    uint32_t num_workers;         // Number of HTTP worker tasks
+    uint32_t queue_len;           // Max number of connections in the queue
+    uint32_t queue_depth;         // Number of connections waiting in the queue for a free worker
+    uint32_t queue_depth_max;     // Max queue depth since the start
+    uint32_t cnt_conn_dispatched; // Total number of connections passed to the workers
+} http_server_conn_queue_stat_t;
+
+typedef struct http_server_req_arena_stat_t
+{
+    uint32_t arena_size;    // Size of the arena for the temporary buffers of the request handlers
+    uint32_t used_max;      // Max number of bytes allocated from the arena since the start
+    uint32_t cnt_fallbacks; // Number of allocations which did not fit into the arena and were allocated from the heap
+} http_server_req_arena_stat_t;
+
+typedef struct http_server_conn_pool_stat_t
+{
+    uint32_t pool_size;     // Number of preallocated connection contexts
+    uint32_t num_used;      // Number of connection contexts in use
+    uint32_t num_used_max;  // Max number of connection contexts in use since the start
+    uint32_t cnt_exhausted; // Number of connections answered with HTTP error 503 because all contexts were in use
+} http_server_conn_pool_stat_t;
+
 /**
  * @brief Init the http server.
  * @brief This function should be executed before start/stop.
@@ -67,6 +91,34 @@ http_server_sema_send_wait_immediate(void);
 bool
 http_server_sema_send_wait_timeout(const uint32_t send_timeout_ms);
 
+/**
+ * @brief Check if there is a new incoming connection waiting to be served.
+ * @return true if at least one connection is waiting in the accept queue or in the queue for the HTTP workers.
+ */
+bool
+http_server_is_new_conn_pending(void);
+
+/**
+ * @brief Get statistics of the queue of the accepted connections waiting for the HTTP workers.
+ * @param[out] p_stat - ptr to the output structure
+ */
+void
+http_server_get_conn_queue_stat(http_server_conn_queue_stat_t* const p_stat);
+
+/**
+ * @brief Get statistics of the arena which is used for the temporary buffers while a request is handled.
+ * @param[out] p_stat - ptr to the output structure
+ */
+void
+http_server_get_req_arena_stat(http_server_req_arena_stat_t* const p_stat);
+
+/**
+ * @brief Get statistics of the pool of the preallocated connection contexts.
+ * @param[out] p_stat - ptr to the output structure
+ */
+void
+http_server_get_conn_pool_stat(http_server_conn_pool_stat_t* const p_stat);
+
 /**
  * @brief Create the task for the http server.
  */
@@ -42,6 +42,12 @@ http_server_resp_200_json(const char* p_json_content);
 http_server_resp_t
 http_server_resp_200_json_in_heap(const char* const p_json_content);
 
+/**
+ * @brief Prepare the response with JSON which is generated on the fly while sending.
+ * @note The content length is not calculated in advance, so the JSON is generated only once:
+ *       the body is sent with "Transfer-Encoding: chunked" to HTTP/1.1 clients,
+ *       for HTTP/1.0 clients the end of the body is signalled by closing the connection.
+ */
 http_server_resp_t
 http_server_resp_json_generator(const http_resp_code_e http_resp_code, json_stream_gen_t* const p_json_gen);
 
@@ -63,6 +69,9 @@ http_server_resp_404(void);
 http_server_resp_t
 http_server_resp_409(void);
 
+http_server_resp_t
+http_server_resp_413(void);
+
 http_server_resp_t
 http_server_resp_500(void);
 
@@ -87,6 +96,32 @@ http_server_resp_data_in_flash(
     const uint8_t*                p_buf,
     const bool                    flag_no_cache);
 
+/**
+ * @brief Prepare the response with the content in flash which has several precompressed variants.
+ * @note The server selects the smallest variant which is acceptable for the client according to "Accept-Encoding",
+ *       the uncompressed content (p_buf) is used if none of the variants is acceptable.
+ * @param content_len - the length of the uncompressed content
+ * @param p_buf - ptr to the uncompressed content
+ * @param p_variants - ptr to the array of the precompressed variants (it must be kept in flash or in static memory)
+ * @param num_variants - the number of the variants
+ */
+http_server_resp_t
+http_server_resp_data_in_flash_with_variants(
+    const http_content_type_e                  content_type,
+    const char*                                p_content_type_param,
+    const size_t                               content_len,
+    const uint8_t*                             p_buf,
+    const http_server_content_variant_t* const p_variants,
+    const uint32_t                             num_variants,
+    const bool                                 flag_no_cache);
+
+/**
+ * @brief Select the smallest variant of the content which is acceptable for the client.
+ * @param accept_encoding - the bit mask of the acceptable encodings (see http_req_parse_accept_encoding)
+ */
+void
+http_server_resp_select_variant(http_server_resp_t* const p_resp, const uint32_t accept_encoding);
+
 http_server_resp_t
 http_server_resp_data_in_static_mem(
     const http_content_type_e     content_type,
@@ -117,6 +152,55 @@ http_server_resp_data_from_file(
     const socket_t                fd,
     const bool                    flag_no_cache);
 
+/**
+ * @brief Set the policy which is sent in "Cache-Control" header field.
+ * @param type - the type of the policy
+ * @param max_age - the max age in seconds (used with HTTP_CACHE_CONTROL_MAX_AGE)
+ */
+void
+http_server_resp_set_cache_policy(
+    http_server_resp_t* const  p_resp,
+    const http_cache_control_e type,
+    const uint32_t             max_age);
+
+/**
+ * @brief Check if the file name contains a content hash (fingerprint), e.g. "app.3f9a1c2b.js".
+ * @note The fingerprint is the part of the file name delimited by '.' or '-' (but not the last one)
+ *       which consists of at least HTTP_SERVER_CACHE_FINGERPRINT_MIN_LEN hex digits.
+ */
+bool
+http_server_resp_is_fingerprinted_path(const char* const p_path);
+
+/**
+ * @brief Make the content from flash or FATFS immutable if the cache policy is not set explicitly
+ *        and the file name contains a fingerprint.
+ */
+void
+http_server_resp_set_default_cache_policy(http_server_resp_t* const p_resp, const char* const p_path);
+
+/**
+ * @brief Calculate the strong validator of the content (FNV-1a hash, it's never 0).
+ * @note The same algorithm can be used at build time to calculate the validators of the assets in flash.
+ */
+uint32_t
+http_server_resp_calc_etag(const uint8_t* const p_buf, const size_t len);
+
+/**
+ * @brief Calculate the validator of the file from its size and the time of the last modification.
+ */
+uint32_t
+http_server_resp_calc_etag_for_file(const size_t file_size, const time_t mtime);
+
+/**
+ * @brief Set the validators which are sent in "ETag" and "Last-Modified" header fields.
+ * @note The server responds with HTTP status 304 without the content
+ *       if the request with "If-None-Match" or "If-Modified-Since" matches them.
+ * @param etag - the strong validator of the content or 0 if it's not used
+ * @param last_modified - the time of the last modification of the content or 0 if it's unknown
+ */
+void
+http_server_resp_set_validators(http_server_resp_t* const p_resp, const uint32_t etag, const time_t last_modified);
+
 http_server_resp_t
 http_server_resp_401_auth_digest(
     const wifiman_hostinfo_t* const   p_hostinfo,
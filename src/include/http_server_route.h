@@ -0,0 +1,83 @@
+/**
+ * @file http_server_route.h
+ * @author TheSomeMan
+ * @date 2026-10-17
+ * @copyright Ruuvi Innovations Ltd, license BSD-3-Clause.
+ */
+
+#ifndef RUUVI_ESP_WIFI_MANAGER_HTTP_SERVER_ROUTE_H
+#define RUUVI_ESP_WIFI_MANAGER_HTTP_SERVER_ROUTE_H
+
+#include <stdbool.h>
+#include "wifi_manager_defs.h"
+
+#ifdef __cplusplus
+extern "C" {
+#endif
+
+typedef enum http_server_route_method_e
+{
+    HTTP_SERVER_ROUTE_METHOD_GET,
+    HTTP_SERVER_ROUTE_METHOD_POST,
+    HTTP_SERVER_ROUTE_METHOD_DELETE,
+} http_server_route_method_e;
+
+typedef enum http_server_route_auth_e
+{
+    HTTP_SERVER_ROUTE_AUTH_NONE,      // The access is not checked by the HTTP server (the handler checks it itself)
+    HTTP_SERVER_ROUTE_AUTH_REQUIRED,  // Authenticated session or any bearer token
+    HTTP_SERVER_ROUTE_AUTH_BEARER_RW, // Authenticated session or the read-write bearer token
+} http_server_route_auth_e;
+
+/**
+ * @brief The access policy which is checked before the route handler is called.
+ */
+typedef struct http_server_route_policy_t
+{
+    http_server_route_auth_e auth;
+    bool                     flag_lan_allowed; // If false, the access from LAN is rejected with HTTP error 403
+} http_server_route_policy_t;
+
+typedef struct http_server_route_req_t
+{
+    const char* p_path;       // The path of the request without the leading '/'
+    const char* p_uri_params; // The URI params of the request (or NULL)
+    const char* p_body;       // The body of POST request (decrypted if it was encrypted), NULL for GET and DELETE
+    bool        flag_access_from_lan;
+} http_server_route_req_t;
+
+typedef http_server_resp_t (*http_server_route_handler_t)(
+    const http_server_route_req_t* const p_req,
+    void* const                          p_user_data);
+
+/**
+ * @brief Register the handler for the method and the path.
+ * @note The requests to the registered routes are dispatched by one hash lookup
+ *       instead of the callbacks cb_on_http_get/cb_on_http_post/cb_on_http_delete.
+ * @param method - the method of the request
+ * @param p_path - the path with or without the leading '/' (the string must stay valid while the route is registered)
+ * @param policy - the access policy of the route
+ * @param handler - the handler of the request
+ * @param p_user_data - ptr which is passed to the handler
+ * @return false if the route is already registered or the table of routes is full.
+ */
+bool
+http_server_route_register(
+    const http_server_route_method_e  method,
+    const char* const                 p_path,
+    const http_server_route_policy_t  policy,
+    const http_server_route_handler_t handler,
+    void* const                       p_user_data);
+
+/**
+ * @brief Remove the route which was registered by http_server_route_register.
+ * @return false if the route was not found.
+ */
+bool
+http_server_route_unregister(const http_server_route_method_e method, const char* const p_path);
+
+#ifdef __cplusplus
+}
+#endif
+
+#endif // RUUVI_ESP_WIFI_MANAGER_HTTP_SERVER_ROUTE_H
@@ -35,6 +35,7 @@ Contains the freeRTOS task and all necessary support
 #include <stdint.h>
 #include <stdbool.h>
 #include <stddef.h>
+#include <time.h>
 #include "esp_wifi_types.h"
 #include "esp_type_wrapper.h"
 #include "esp_netif_ip_addr.h"
@@ -258,11 +259,14 @@ typedef enum http_resp_code_e
     HTTP_RESP_CODE_299 = 299, // OK (max value)
     HTTP_RESP_CODE_301 = 301, // Moved Permanently
     HTTP_RESP_CODE_302 = 302, // Found
+    HTTP_RESP_CODE_304 = 304, // Not Modified
     HTTP_RESP_CODE_400 = 400, // Bad Request
     HTTP_RESP_CODE_401 = 401, // Unauthorized
     HTTP_RESP_CODE_403 = 403, // Forbidden
     HTTP_RESP_CODE_404 = 404, // Not Found
     HTTP_RESP_CODE_409 = 409, // Conflict
+    HTTP_RESP_CODE_413 = 413, // Payload Too Large
+    HTTP_RESP_CODE_416 = 416, // Range Not Satisfiable
     HTTP_RESP_CODE_429 = 429, // Too Many Requests
     HTTP_RESP_CODE_500 = 500, // Internal Server Error
     HTTP_RESP_CODE_502 = 502, // Bad Gateway
@@ -286,8 +290,34 @@ typedef enum http_content_encoding_e
 {
     HTTP_CONTENT_ENCODING_NONE,
     HTTP_CONTENT_ENCODING_GZIP,
+    HTTP_CONTENT_ENCODING_BR,
 } http_content_encoding_e;
 
+/**
+ * @brief The precompressed variant of the content in flash.
+ */
+typedef struct http_server_content_variant_t
+{
+    http_content_encoding_e content_encoding;
+    size_t                  content_len;
+    const uint8_t*          p_buf;
+    uint32_t                etag; // Strong validator of the variant (0 if it's not used)
+} http_server_content_variant_t;
+
+typedef enum http_cache_control_e
+{
+    HTTP_CACHE_CONTROL_DEFAULT,   // Without "Cache-Control" (content from flash or FATFS can be made immutable)
+    HTTP_CACHE_CONTROL_NO_STORE,  // The content must not be cached
+    HTTP_CACHE_CONTROL_MAX_AGE,   // The content can be cached for max_age seconds
+    HTTP_CACHE_CONTROL_IMMUTABLE, // The content never changes (the file name contains a content hash)
+} http_cache_control_e;
+
+typedef struct http_server_cache_policy_t
+{
+    http_cache_control_e type;
+    uint32_t             max_age; // Max age in seconds (used with HTTP_CACHE_CONTROL_MAX_AGE)
+} http_server_cache_policy_t;
+
 typedef enum http_content_location_e
 {
     HTTP_CONTENT_LOCATION_NO_CONTENT,
@@ -300,14 +330,19 @@ typedef enum http_content_location_e
 
 typedef struct http_server_resp_t
 {
-    http_resp_code_e        http_resp_code;
-    http_content_location_e content_location;
-    bool                    flag_no_cache;
-    bool                    flag_add_header_date;
-    http_content_type_e     content_type;
-    const char*             p_content_type_param;
-    size_t                  content_len;
-    http_content_encoding_e content_encoding;
+    http_resp_code_e                     http_resp_code;
+    http_content_location_e              content_location;
+    http_server_cache_policy_t           cache_policy;
+    bool                                 flag_add_header_date;
+    http_content_type_e                  content_type;
+    const char*                          p_content_type_param;
+    size_t                               content_len; // SIZE_MAX if the length is not known in advance
+    http_content_encoding_e              content_encoding;
+    uint32_t                             etag;          // Strong validator of the content (0 if it's not used)
+    time_t                               last_modified; // Time of the last modification (0 if it's unknown)
+    const http_server_content_variant_t* p_variants;    // Precompressed variants of the content (NULL if not used)
+    uint32_t                             num_variants;  // Number of the precompressed variants
+    bool                                 flag_vary_encoding; // The variant was selected by "Accept-Encoding"
     union
     {
         struct
@@ -339,6 +374,42 @@ typedef http_server_resp_t (*wifi_manager_http_cb_on_post_t)(
     const char* const p_body,
     const bool        flag_access_from_lan);
 
+/**
+ * @brief Start receiving the body of the POST request which is too large to be received into the request buffer.
+ * @note The body is passed in chunks as it arrives, so the memory usage does not depend on the size of the upload.
+ * @param p_path - the path of the request
+ * @param p_uri_params - the URI params of the request (or NULL)
+ * @param content_len - the value of "Content-Length" of the request
+ * @param flag_access_from_lan - true if the request was received from LAN
+ * @return the handle of the upload which is passed to the other callbacks or NULL if the path does not support
+ *         streaming (the request is rejected with HTTP error 413 in this case).
+ */
+typedef void* (*wifi_manager_http_cb_on_post_stream_begin_t)(
+    const char* const p_path,
+    const char* const p_uri_params,
+    const size_t      content_len,
+    const bool        flag_access_from_lan);
+
+/**
+ * @brief Pass the next chunk of the body of the POST request.
+ * @return false to abort the upload (HTTP error 500 is sent and the callback "abort" is not called).
+ */
+typedef bool (*wifi_manager_http_cb_on_post_stream_data_t)(
+    void* const          p_stream,
+    const uint8_t* const p_buf,
+    const size_t         len);
+
+/**
+ * @brief The body of the POST request was received completely.
+ * @return the response to the POST request.
+ */
+typedef http_server_resp_t (*wifi_manager_http_cb_on_post_stream_end_t)(void* const p_stream);
+
+/**
+ * @brief The upload was aborted (the connection was closed or timed out before the body was received completely).
+ */
+typedef void (*wifi_manager_http_cb_on_post_stream_abort_t)(void* const p_stream);
+
 typedef struct wifiman_config_ap_t  wifiman_config_ap_t;
 typedef struct wifiman_config_sta_t wifiman_config_sta_t;
 typedef struct wifiman_config_t     wifiman_config_t;
@@ -374,6 +445,10 @@ typedef struct wifi_manager_callbacks_t
     wifi_manager_callback_on_ap_sta_disconnected_t cb_on_ap_sta_disconnected;
     wifi_manager_callback_save_wifi_config_sta_t   cb_save_wifi_config_sta;
     wifi_manager_callback_on_request_status_json_t cb_on_request_status_json;
+    wifi_manager_http_cb_on_post_stream_begin_t    cb_on_http_post_stream_begin;
+    wifi_manager_http_cb_on_post_stream_data_t     cb_on_http_post_stream_data;
+    wifi_manager_http_cb_on_post_stream_end_t      cb_on_http_post_stream_end;
+    wifi_manager_http_cb_on_post_stream_abort_t    cb_on_http_post_stream_abort;
 } wifi_manager_callbacks_t;
 
 typedef struct wifi_settings_ap_t
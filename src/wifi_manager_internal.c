@@ -138,6 +138,44 @@ wifi_manager_cb_on_http_post(
     return g_wifi_callbacks.cb_on_http_post(p_path, p_uri_params, http_body.ptr, flag_access_from_lan);
 }
 
+void*
+wifi_manager_cb_on_http_post_stream_begin(
+    const char* const p_path,
+    const char* const p_uri_params,
+    const size_t      content_len,
+    const bool        flag_access_from_lan)
+{
+    if ((NULL == g_wifi_callbacks.cb_on_http_post_stream_begin)
+        || (NULL == g_wifi_callbacks.cb_on_http_post_stream_data)
+        || (NULL == g_wifi_callbacks.cb_on_http_post_stream_end))
+    {
+        return NULL;
+    }
+    return g_wifi_callbacks.cb_on_http_post_stream_begin(p_path, p_uri_params, content_len, flag_access_from_lan);
+}
+
+bool
+wifi_manager_cb_on_http_post_stream_data(void* const p_stream, const uint8_t* const p_buf, const size_t len)
+{
+    return g_wifi_callbacks.cb_on_http_post_stream_data(p_stream, p_buf, len);
+}
+
+http_server_resp_t
+wifi_manager_cb_on_http_post_stream_end(void* const p_stream)
+{
+    return g_wifi_callbacks.cb_on_http_post_stream_end(p_stream);
+}
+
+void
+wifi_manager_cb_on_http_post_stream_abort(void* const p_stream)
+{
+    if (NULL == g_wifi_callbacks.cb_on_http_post_stream_abort)
+    {
+        return;
+    }
+    g_wifi_callbacks.cb_on_http_post_stream_abort(p_stream);
+}
+
 http_server_resp_t
 wifi_manager_cb_on_http_delete(
     const char* const               p_path,
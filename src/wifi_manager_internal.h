@@ -149,6 +149,22 @@ wifi_manager_cb_on_http_post(
     const http_req_body_t http_body,
     const bool            flag_access_from_lan);
 
+void*
+wifi_manager_cb_on_http_post_stream_begin(
+    const char* const p_path,
+    const char* const p_uri_params,
+    const size_t      content_len,
+    const bool        flag_access_from_lan);
+
+bool
+wifi_manager_cb_on_http_post_stream_data(void* const p_stream, const uint8_t* const p_buf, const size_t len);
+
+http_server_resp_t
+wifi_manager_cb_on_http_post_stream_end(void* const p_stream);
+
+void
+wifi_manager_cb_on_http_post_stream_abort(void* const p_stream);
+
 http_server_resp_t
 wifi_manager_cb_on_http_delete(
     const char* const               p_path,
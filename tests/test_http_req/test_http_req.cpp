@@ -8,6 +8,7 @@
 #include "gtest/gtest.h"
 #include "http_req.h"
 #include <string>
+#include <vector>
 
 using namespace std;
 
@@ -360,3 +361,327 @@ TEST_F(TestHttpReq, test_crlf_http_req_header_get_field) // NOLINT
         ASSERT_EQ(0, none_field_len);
     }
 }
+
+TEST_F(TestHttpReq, test_parser_feed_byte_by_byte) // NOLINT
+{
+    char req[]
+        = "POST /auth?param=1 HTTP/1.1\r\n"
+          "Host: 192.168.4.1\r\n"
+          "content-length: 4\r\n"
+          "\r\n"
+          "body";
+    const uint32_t req_size = (uint32_t)strlen(req);
+
+    http_req_parser_t parser = {};
+    http_req_parser_init(&parser);
+    for (uint32_t i = 1; i < req_size; ++i)
+    {
+        ASSERT_EQ(HTTP_REQ_PARSER_RES_NEED_MORE, http_req_parser_feed(&parser, req, i));
+        ASSERT_LE(parser.offset, i);
+    }
+    ASSERT_EQ(HTTP_REQ_PARSER_RES_COMPLETE, http_req_parser_feed(&parser, req, req_size));
+    ASSERT_EQ(4, parser.content_len);
+    ASSERT_EQ(req_size, http_req_parser_get_req_len(&parser));
+
+    const http_req_info_t req_info = http_req_parser_get_info(&parser, req);
+    ASSERT_TRUE(req_info.is_success);
+    ASSERT_EQ(string("POST"), req_info.http_cmd.ptr);
+    ASSERT_EQ(string("/auth"), req_info.http_uri.ptr);
+    ASSERT_EQ(string("param=1"), req_info.http_uri_params.ptr);
+    ASSERT_EQ(string("HTTP/1.1"), req_info.http_ver.ptr);
+    ASSERT_EQ(
+        string("Host: 192.168.4.1\r\n"
+               "content-length: 4\r\n"),
+        req_info.http_header.ptr);
+    ASSERT_EQ(string("body"), req_info.http_body.ptr);
+}
+
+TEST_F(TestHttpReq, test_parser_pipelined_requests) // NOLINT
+{
+    char req[]
+        = "POST /auth HTTP/1.1\r\n"
+          "Content-Length:  2\r\n"
+          "Content-Type: application/json\r\n"
+          "\r\n"
+          "{}"
+          "GET /status.json HTTP/1.1\r\n"
+          "\r\n";
+    const uint32_t req_size = (uint32_t)strlen(req);
+
+    http_req_parser_t parser = {};
+    http_req_parser_init(&parser);
+    ASSERT_EQ(HTTP_REQ_PARSER_RES_COMPLETE, http_req_parser_feed(&parser, req, req_size));
+    ASSERT_EQ(2, parser.content_len);
+    const uint32_t req_len = http_req_parser_get_req_len(&parser);
+    ASSERT_EQ(string("GET /status.json HTTP/1.1\r\n\r\n"), string(&req[req_len]));
+
+    req[req_len]                   = '\0';
+    const http_req_info_t req_info = http_req_parser_get_info(&parser, req);
+    ASSERT_TRUE(req_info.is_success);
+    ASSERT_EQ(string("POST"), req_info.http_cmd.ptr);
+    ASSERT_EQ(string("/auth"), req_info.http_uri.ptr);
+    ASSERT_EQ(nullptr, req_info.http_uri_params.ptr);
+    ASSERT_EQ(string("{}"), req_info.http_body.ptr);
+}
+
+TEST_F(TestHttpReq, test_parser_body_not_complete) // NOLINT
+{
+    char req[]
+        = "POST /auth HTTP/1.1\n"
+          "Content-Length: 10\n"
+          "\n"
+          "{}";
+    http_req_parser_t parser = {};
+    http_req_parser_init(&parser);
+    ASSERT_EQ(HTTP_REQ_PARSER_RES_NEED_MORE, http_req_parser_feed(&parser, req, (uint32_t)strlen(req)));
+    ASSERT_EQ(HTTP_REQ_PARSER_STATE_BODY, parser.state);
+    ASSERT_EQ(10, parser.content_len);
+}
+
+TEST_F(TestHttpReq, test_parser_bad_req_line_with_complete_header) // NOLINT
+{
+    char req[]
+        = "GET/connecttest.txt HTTP/1.1\r\n"
+          "Host: www.msftconnecttest.com\r\n"
+          "\r\n";
+    http_req_parser_t parser = {};
+    http_req_parser_init(&parser);
+    // The request is complete, so it can be answered with HTTP error 400
+    ASSERT_EQ(HTTP_REQ_PARSER_RES_COMPLETE, http_req_parser_feed(&parser, req, (uint32_t)strlen(req)));
+    const http_req_info_t req_info = http_req_parser_get_info(&parser, req);
+    ASSERT_FALSE(req_info.is_success);
+}
+
+TEST_F(TestHttpReq, test_header_index) // NOLINT
+{
+    char req[]
+        = "GET /index.html HTTP/1.1\r\n"
+          "Referer: http://x/?Host: evil\r\n"
+          "X-Host: wrong\r\n"
+          "host:   192.168.4.1\r\n"
+          "Cookie: \"\"\r\n"
+          "\r\n";
+    const http_req_info_t req_info = http_req_parse(req);
+    ASSERT_TRUE(req_info.is_success);
+    ASSERT_TRUE(req_info.http_header.index.is_valid);
+    ASSERT_FALSE(req_info.http_header.index.is_overflow);
+    ASSERT_EQ(4, req_info.http_header.index.num_fields);
+
+    uint32_t    len   = 0;
+    const char* p_val = http_req_header_get_field(req_info.http_header, "Host:", &len);
+    ASSERT_NE(nullptr, p_val);
+    ASSERT_EQ(string("192.168.4.1"), string(p_val, len));
+
+    p_val = http_req_header_get_field(req_info.http_header, "HOST", &len);
+    ASSERT_NE(nullptr, p_val);
+    ASSERT_EQ(string("192.168.4.1"), string(p_val, len));
+
+    p_val = http_req_header_get_field(req_info.http_header, "Cookie:", &len);
+    ASSERT_NE(nullptr, p_val);
+    ASSERT_EQ(0, len);
+
+    ASSERT_EQ(nullptr, http_req_header_get_field(req_info.http_header, "Connection:", &len));
+    ASSERT_EQ(0, len);
+}
+
+TEST_F(TestHttpReq, test_header_index_overflow) // NOLINT
+{
+    string req_str = "GET /index.html HTTP/1.1\r\n";
+    for (uint32_t i = 0; i < HTTP_REQ_HEADER_INDEX_SIZE; ++i)
+    {
+        req_str += "X-Field-" + std::to_string(i) + ": " + std::to_string(i) + "\r\n";
+    }
+    req_str += "Connection: close\r\n";
+    req_str += "Host: \"192.168.4.1\"\r\n";
+    req_str += "\r\n";
+    std::vector<char> req(req_str.begin(), req_str.end());
+    req.push_back('\0');
+
+    const http_req_info_t req_info = http_req_parse(req.data());
+    ASSERT_TRUE(req_info.is_success);
+    ASSERT_TRUE(req_info.http_header.index.is_overflow);
+    ASSERT_EQ(HTTP_REQ_HEADER_INDEX_SIZE, req_info.http_header.index.num_fields);
+
+    uint32_t    len   = 0;
+    const char* p_val = http_req_header_get_field(req_info.http_header, "X-Field-3:", &len);
+    ASSERT_NE(nullptr, p_val);
+    ASSERT_EQ(string("3"), string(p_val, len));
+
+    p_val = http_req_header_get_field(req_info.http_header, "Connection:", &len);
+    ASSERT_NE(nullptr, p_val);
+    ASSERT_EQ(string("close"), string(p_val, len));
+
+    p_val = http_req_header_get_field(req_info.http_header, "Host:", &len);
+    ASSERT_NE(nullptr, p_val);
+    ASSERT_EQ(string("192.168.4.1"), string(p_val, len));
+
+    ASSERT_EQ(nullptr, http_req_header_get_field(req_info.http_header, "Cookie:", &len));
+}
+
+TEST_F(TestHttpReq, test_parse_range) // NOLINT
+{
+    http_req_range_t range = {};
+
+    const string range1 = "bytes=0-499";
+    ASSERT_TRUE(http_req_parse_range(range1.c_str(), range1.length(), &range));
+    ASSERT_FALSE(range.flag_suffix);
+    ASSERT_EQ(0, range.first);
+    ASSERT_EQ(499, range.last);
+
+    const string range2 = "bytes=500-";
+    ASSERT_TRUE(http_req_parse_range(range2.c_str(), range2.length(), &range));
+    ASSERT_FALSE(range.flag_suffix);
+    ASSERT_EQ(500, range.first);
+    ASSERT_EQ(SIZE_MAX, range.last);
+
+    const string range3 = "bytes=-200 ";
+    ASSERT_TRUE(http_req_parse_range(range3.c_str(), range3.length(), &range));
+    ASSERT_TRUE(range.flag_suffix);
+    ASSERT_EQ(200, range.suffix_len);
+
+    // The value is not required to be terminated with '\0'
+    const string range4 = "bytes=10-20\r\nHost: 192.168.4.1";
+    ASSERT_TRUE(http_req_parse_range(range4.c_str(), strlen("bytes=10-20"), &range));
+    ASSERT_EQ(10, range.first);
+    ASSERT_EQ(20, range.last);
+}
+
+TEST_F(TestHttpReq, test_parse_range_invalid) // NOLINT
+{
+    http_req_range_t range = {};
+
+    const std::vector<string> invalid_ranges = {
+        "",
+        "bytes=",
+        "items=0-10",
+        "bytes=-",
+        "bytes=10",
+        "bytes=20-10",
+        "bytes=0-10,20-30",
+        "bytes=a-10",
+        "bytes=0-10x",
+        "bytes=99999999999999999999999-",
+    };
+    for (const auto& val : invalid_ranges)
+    {
+        ASSERT_FALSE(http_req_parse_range(val.c_str(), val.length(), &range)) << val;
+    }
+}
+
+TEST_F(TestHttpReq, test_range_resolve) // NOLINT
+{
+    http_req_range_t range = {};
+    size_t           first = 0;
+    size_t           last  = 0;
+
+    const string range1 = "bytes=100-199";
+    ASSERT_TRUE(http_req_parse_range(range1.c_str(), range1.length(), &range));
+    ASSERT_TRUE(http_req_range_resolve(&range, 1000, &first, &last));
+    ASSERT_EQ(100, first);
+    ASSERT_EQ(199, last);
+    // The last position is limited by the length of the content
+    ASSERT_TRUE(http_req_range_resolve(&range, 150, &first, &last));
+    ASSERT_EQ(100, first);
+    ASSERT_EQ(149, last);
+    // The first position is beyond the end of the content
+    ASSERT_FALSE(http_req_range_resolve(&range, 100, &first, &last));
+
+    const string range2 = "bytes=-300";
+    ASSERT_TRUE(http_req_parse_range(range2.c_str(), range2.length(), &range));
+    ASSERT_TRUE(http_req_range_resolve(&range, 1000, &first, &last));
+    ASSERT_EQ(700, first);
+    ASSERT_EQ(999, last);
+    ASSERT_TRUE(http_req_range_resolve(&range, 200, &first, &last));
+    ASSERT_EQ(0, first);
+    ASSERT_EQ(199, last);
+    ASSERT_FALSE(http_req_range_resolve(&range, 0, &first, &last));
+
+    const string range3 = "bytes=-0";
+    ASSERT_TRUE(http_req_parse_range(range3.c_str(), range3.length(), &range));
+    ASSERT_FALSE(http_req_range_resolve(&range, 1000, &first, &last));
+}
+
+TEST_F(TestHttpReq, test_if_none_match) // NOLINT
+{
+    const char* const p_etag = "\"0123abcd\"";
+
+    const string val1 = "\"0123abcd\"";
+    ASSERT_TRUE(http_req_if_none_match(val1.c_str(), val1.length(), p_etag));
+
+    const string val2 = "\"11111111\", W/\"0123abcd\"";
+    ASSERT_TRUE(http_req_if_none_match(val2.c_str(), val2.length(), p_etag));
+
+    const string val3 = "*";
+    ASSERT_TRUE(http_req_if_none_match(val3.c_str(), val3.length(), p_etag));
+
+    const string val4 = "\"11111111\",\"0123abcde\"";
+    ASSERT_FALSE(http_req_if_none_match(val4.c_str(), val4.length(), p_etag));
+
+    const string val5 = "0123abcd";
+    ASSERT_FALSE(http_req_if_none_match(val5.c_str(), val5.length(), p_etag));
+
+    ASSERT_FALSE(http_req_if_none_match("", 0, p_etag));
+}
+
+TEST_F(TestHttpReq, test_parse_http_date) // NOLINT
+{
+    time_t time_val = 0;
+
+    const string date1 = "Sun, 06 Nov 1994 08:49:37 GMT";
+    ASSERT_TRUE(http_req_parse_http_date(date1.c_str(), date1.length(), &time_val));
+    ASSERT_EQ(784111777, time_val);
+
+    const string date2 = "Thu, 01 Jan 1970 00:00:00 GMT";
+    ASSERT_TRUE(http_req_parse_http_date(date2.c_str(), date2.length(), &time_val));
+    ASSERT_EQ(0, time_val);
+
+    const string date3 = "Thu, 29 Feb 2024 23:59:59 GMT";
+    ASSERT_TRUE(http_req_parse_http_date(date3.c_str(), date3.length(), &time_val));
+    ASSERT_EQ(1709251199, time_val);
+
+    const std::vector<string> invalid_dates = {
+        "",
+        "Sunday, 06-Nov-94 08:49:37 GMT",
+        "Sun Nov  6 08:49:37 1994",
+        "Sun, 06 Xyz 1994 08:49:37 GMT",
+        "Sun, 06 Nov 1994 08:49:37 UTC",
+        "Sun, 6 Nov 1994 08:49:37 GMT ",
+        "Sun, 06 Nov 1994 24:49:37 GMT",
+    };
+    for (const auto& val : invalid_dates)
+    {
+        ASSERT_FALSE(http_req_parse_http_date(val.c_str(), val.length(), &time_val)) << val;
+    }
+}
+
+TEST_F(TestHttpReq, test_parse_accept_encoding) // NOLINT
+{
+    const uint32_t identity = HTTP_REQ_ACCEPT_ENCODING_IDENTITY;
+    const uint32_t gzip     = HTTP_REQ_ACCEPT_ENCODING_GZIP;
+    const uint32_t br       = HTTP_REQ_ACCEPT_ENCODING_BR;
+
+    ASSERT_EQ(identity, http_req_parse_accept_encoding(nullptr, 0));
+    ASSERT_EQ(identity, http_req_parse_accept_encoding("", 0));
+
+    const std::vector<std::pair<string, uint32_t>> test_cases = {
+        { "gzip, deflate, br", identity | gzip | br },
+        { "gzip", identity | gzip },
+        { "x-gzip", identity | gzip },
+        { "BR;q=1.0, gzip;q=0.5", identity | gzip | br },
+        { "br;q=0, gzip", identity | gzip },
+        { "gzip;q=0.000", identity },
+        { "gzip;q=0.001", identity | gzip },
+        { "*", identity | gzip | br },
+        { "br, *;q=0", br },
+        { "identity;q=0, gzip", gzip },
+        { "gzip, *;q=0", gzip },
+        { "deflate", identity },
+    };
+    for (const auto& test_case : test_cases)
+    {
+        ASSERT_EQ(
+            test_case.second,
+            http_req_parse_accept_encoding(test_case.first.c_str(), test_case.first.length()))
+            << test_case.first;
+    }
+}
@@ -0,0 +1,236 @@
+/**
+ * @file test_http_server_arena.cpp
+ * @author TheSomeMan
+ * @date 2026-10-17
+ * @copyright Ruuvi Innovations Ltd, license BSD-3-Clause.
+ */
+
+#include "gtest/gtest.h"
+#include "http_server_arena.h"
+#include <cstdint>
+#include <set>
+#include "cJSON.h"
+#include "http_server.h"
+#include "http_server_cfg.h"
+
+using namespace std;
+
+/*** Google-test class implementation *********************************************************************************/
+
+class TestHttpServerArena;
+
+static TestHttpServerArena* g_pTestObj;
+
+class TestHttpServerArena : public ::testing::Test
+{
+private:
+protected:
+    void
+    SetUp() override
+    {
+        g_pTestObj                 = this;
+        this->m_cur_task           = reinterpret_cast<TaskHandle_t>(0x1000);
+        this->m_cnt_heap_allocated = 0;
+        this->m_heap_mem.clear();
+        http_server_arena_install_cjson_hooks();
+    }
+
+    void
+    TearDown() override
+    {
+        cJSON_InitHooks(nullptr);
+        g_pTestObj = nullptr;
+    }
+
+public:
+    TaskHandle_t    m_cur_task;
+    uint32_t        m_cnt_heap_allocated;
+    std::set<void*> m_heap_mem;
+
+    TestHttpServerArena();
+
+    ~TestHttpServerArena() override;
+};
+
+TestHttpServerArena::TestHttpServerArena()
+    : Test()
+    , m_cur_task(nullptr)
+    , m_cnt_heap_allocated(0)
+{
+}
+
+TestHttpServerArena::~TestHttpServerArena() = default;
+
+extern "C" {
+
+TaskHandle_t
+xTaskGetCurrentTaskHandle(void)
+{
+    return g_pTestObj->m_cur_task;
+}
+
+void*
+os_malloc(const size_t size)
+{
+    void* const p_mem = malloc(size);
+    g_pTestObj->m_cnt_heap_allocated += 1;
+    g_pTestObj->m_heap_mem.insert(p_mem);
+    return p_mem;
+}
+
+void*
+os_calloc(const size_t nmemb, const size_t size)
+{
+    void* const p_mem = calloc(nmemb, size);
+    g_pTestObj->m_cnt_heap_allocated += 1;
+    g_pTestObj->m_heap_mem.insert(p_mem);
+    return p_mem;
+}
+
+void
+os_free_internal(void* ptr)
+{
+    if (nullptr == ptr)
+    {
+        return;
+    }
+    assert(0 != g_pTestObj->m_heap_mem.count(ptr));
+    g_pTestObj->m_heap_mem.erase(ptr);
+    free(ptr);
+}
+
+} // extern "C"
+
+/*** Unit-Tests *******************************************************************************************************/
+
+TEST_F(TestHttpServerArena, test_alloc_outside_of_scope) // NOLINT
+{
+    void* const p_mem = http_server_arena_malloc(16);
+    ASSERT_NE(nullptr, p_mem);
+    ASSERT_EQ(1, this->m_cnt_heap_allocated);
+    ASSERT_EQ(1, this->m_heap_mem.count(p_mem));
+    http_server_arena_free(p_mem);
+    ASSERT_TRUE(this->m_heap_mem.empty());
+}
+
+TEST_F(TestHttpServerArena, test_alloc_in_scope) // NOLINT
+{
+    http_server_arena_begin();
+    uint8_t* const p_mem1 = static_cast<uint8_t*>(http_server_arena_malloc(3));
+    uint8_t* const p_mem2 = static_cast<uint8_t*>(http_server_arena_malloc(16));
+    ASSERT_NE(nullptr, p_mem1);
+    ASSERT_NE(nullptr, p_mem2);
+    ASSERT_EQ(0, reinterpret_cast<uintptr_t>(p_mem1) % HTTP_SERVER_ARENA_ALIGNMENT);
+    ASSERT_EQ(p_mem1 + HTTP_SERVER_ARENA_ALIGNMENT, p_mem2);
+    ASSERT_EQ(0, this->m_cnt_heap_allocated);
+    http_server_arena_free(p_mem1);
+    http_server_arena_free(p_mem2);
+    http_server_arena_end();
+
+    http_server_req_arena_stat_t stat = { 0 };
+    http_server_get_req_arena_stat(&stat);
+    ASSERT_GE(stat.arena_size, HTTP_SERVER_REQ_ARENA_SIZE);
+    ASSERT_GE(stat.used_max, 8 + 16);
+
+    // The arena is reused from the beginning by the next request
+    http_server_arena_begin();
+    ASSERT_EQ(p_mem1, http_server_arena_malloc(8));
+    http_server_arena_end();
+}
+
+TEST_F(TestHttpServerArena, test_free_last_alloc_returns_mem_to_arena) // NOLINT
+{
+    http_server_arena_begin();
+    void* const p_mem1 = http_server_arena_malloc(8);
+    void* const p_mem2 = http_server_arena_malloc(64);
+    http_server_arena_free(p_mem1); // not the last one, the memory stays allocated until the end of the scope
+    http_server_arena_free(p_mem2);
+    void* const p_mem3 = http_server_arena_malloc(32);
+    ASSERT_EQ(p_mem2, p_mem3);
+    http_server_arena_end();
+    ASSERT_EQ(0, this->m_cnt_heap_allocated);
+}
+
+TEST_F(TestHttpServerArena, test_alloc_from_other_task) // NOLINT
+{
+    http_server_arena_begin();
+    this->m_cur_task  = reinterpret_cast<TaskHandle_t>(0x2000);
+    void* const p_mem = http_server_arena_malloc(16);
+    ASSERT_EQ(1, this->m_heap_mem.count(p_mem));
+    http_server_arena_free(p_mem);
+    ASSERT_TRUE(this->m_heap_mem.empty());
+    this->m_cur_task = reinterpret_cast<TaskHandle_t>(0x1000);
+    http_server_arena_end();
+}
+
+TEST_F(TestHttpServerArena, test_suspend_resume) // NOLINT
+{
+    http_server_arena_begin();
+    const TaskHandle_t owner  = http_server_arena_suspend();
+    void* const        p_mem1 = http_server_arena_malloc(16);
+    ASSERT_EQ(1, this->m_heap_mem.count(p_mem1));
+    http_server_arena_resume(owner);
+    void* const p_mem2 = http_server_arena_malloc(16);
+    ASSERT_EQ(0, this->m_heap_mem.count(p_mem2));
+    http_server_arena_end();
+
+    // The memory allocated while the arena was suspended stays valid after the end of the scope
+    http_server_arena_free(p_mem1);
+    ASSERT_TRUE(this->m_heap_mem.empty());
+}
+
+TEST_F(TestHttpServerArena, test_fallback_to_heap_when_full) // NOLINT
+{
+    http_server_req_arena_stat_t stat_before = { 0 };
+    http_server_get_req_arena_stat(&stat_before);
+
+    http_server_arena_begin();
+    void* const p_mem1 = http_server_arena_malloc(stat_before.arena_size - 8);
+    ASSERT_EQ(0, this->m_heap_mem.count(p_mem1));
+    void* const p_mem2 = http_server_arena_malloc(16);
+    ASSERT_EQ(1, this->m_heap_mem.count(p_mem2));
+    http_server_arena_free(p_mem2);
+    http_server_arena_end();
+    ASSERT_TRUE(this->m_heap_mem.empty());
+
+    http_server_req_arena_stat_t stat = { 0 };
+    http_server_get_req_arena_stat(&stat);
+    ASSERT_EQ(stat_before.cnt_fallbacks + 1, stat.cnt_fallbacks);
+    ASSERT_EQ(stat.arena_size - 8, stat.used_max);
+}
+
+TEST_F(TestHttpServerArena, test_calloc) // NOLINT
+{
+    http_server_arena_begin();
+    uint8_t* const p_mem1 = static_cast<uint8_t*>(http_server_arena_malloc(16));
+    memset(p_mem1, 0xAA, 16);
+    http_server_arena_free(p_mem1);
+    const uint8_t* const p_mem2 = static_cast<uint8_t*>(http_server_arena_calloc(4, 4));
+    ASSERT_EQ(p_mem1, p_mem2);
+    for (uint32_t i = 0; i < 16; ++i)
+    {
+        ASSERT_EQ(0, p_mem2[i]);
+    }
+    ASSERT_EQ(nullptr, http_server_arena_calloc(SIZE_MAX / 2, 4));
+    http_server_arena_end();
+}
+
+TEST_F(TestHttpServerArena, test_cjson_in_scope) // NOLINT
+{
+    http_server_arena_begin();
+    cJSON* const p_json = cJSON_Parse(R"({"ssid":"my_ssid","password":"my_password"})");
+    ASSERT_NE(nullptr, p_json);
+    ASSERT_EQ(string("my_ssid"), string(cJSON_GetStringValue(cJSON_GetObjectItem(p_json, "ssid"))));
+    cJSON_Delete(p_json);
+    http_server_arena_end();
+    ASSERT_EQ(0, this->m_cnt_heap_allocated);
+}
+
+TEST_F(TestHttpServerArena, test_cjson_outside_of_scope) // NOLINT
+{
+    cJSON* const p_json = cJSON_Parse(R"({"ssid":"my_ssid"})");
+    ASSERT_NE(nullptr, p_json);
+    ASSERT_NE(0, this->m_cnt_heap_allocated);
+    cJSON_Delete(p_json);
+    ASSERT_TRUE(this->m_heap_mem.empty());
+}
@@ -0,0 +1,143 @@
+/**
+ * @file test_http_server_conn_pool.cpp
+ * @author TheSomeMan
+ * @date 2026-10-17
+ * @copyright Ruuvi Innovations Ltd, license BSD-3-Clause.
+ */
+
+#include "gtest/gtest.h"
+#include "http_server_conn_pool.h"
+#include <vector>
+#include "http_server.h"
+#include "http_server_cfg.h"
+#include "os_mutex.h"
+
+using namespace std;
+
+/*** Google-test class implementation *********************************************************************************/
+
+class TestHttpServerConnPool;
+
+static TestHttpServerConnPool* g_pTestObj;
+
+class TestHttpServerConnPool : public ::testing::Test
+{
+private:
+protected:
+    void
+    SetUp() override
+    {
+        g_pTestObj         = this;
+        this->m_cnt_lock   = 0;
+        this->m_cnt_unlock = 0;
+        http_server_conn_pool_init();
+    }
+
+    void
+    TearDown() override
+    {
+        g_pTestObj = nullptr;
+    }
+
+public:
+    uint32_t m_cnt_lock;
+    uint32_t m_cnt_unlock;
+
+    TestHttpServerConnPool();
+
+    ~TestHttpServerConnPool() override;
+};
+
+TestHttpServerConnPool::TestHttpServerConnPool()
+    : Test()
+    , m_cnt_lock(0)
+    , m_cnt_unlock(0)
+{
+}
+
+TestHttpServerConnPool::~TestHttpServerConnPool() = default;
+
+extern "C" {
+
+os_mutex_t
+os_mutex_create_static(os_mutex_static_t* const p_mutex_static)
+{
+    return reinterpret_cast<os_mutex_t>(p_mutex_static);
+}
+
+void
+os_mutex_lock(os_mutex_t const h_mutex)
+{
+    g_pTestObj->m_cnt_lock += 1;
+}
+
+void
+os_mutex_unlock(os_mutex_t const h_mutex)
+{
+    g_pTestObj->m_cnt_unlock += 1;
+}
+
+} // extern "C"
+
+/*** Unit-Tests *******************************************************************************************************/
+
+TEST_F(TestHttpServerConnPool, test_acquire_all_and_release) // NOLINT
+{
+    http_server_conn_pool_stat_t stat_before = { 0 };
+    http_server_get_conn_pool_stat(&stat_before);
+    ASSERT_EQ(HTTP_SERVER_CONN_POOL_SIZE, stat_before.pool_size);
+    ASSERT_EQ(0, stat_before.num_used);
+
+    vector<http_server_conn_ctx_t*> contexts;
+    for (uint32_t i = 0; i < HTTP_SERVER_CONN_POOL_SIZE; ++i)
+    {
+        http_server_conn_ctx_t* const p_ctx = http_server_conn_pool_acquire();
+        ASSERT_NE(nullptr, p_ctx);
+        ASSERT_NE(nullptr, p_ctx->p_lin_buf);
+        ASSERT_NE(nullptr, p_ctx->writer.p_chunk_buf);
+        for (const auto p_prev_ctx : contexts)
+        {
+            ASSERT_NE(p_prev_ctx, p_ctx);
+            ASSERT_NE(p_prev_ctx->p_lin_buf, p_ctx->p_lin_buf);
+            ASSERT_NE(p_prev_ctx->writer.p_chunk_buf, p_ctx->writer.p_chunk_buf);
+        }
+        contexts.push_back(p_ctx);
+    }
+
+    // The pool is exhausted
+    ASSERT_EQ(nullptr, http_server_conn_pool_acquire());
+
+    http_server_conn_pool_stat_t stat = { 0 };
+    http_server_get_conn_pool_stat(&stat);
+    ASSERT_EQ(HTTP_SERVER_CONN_POOL_SIZE, stat.num_used);
+    ASSERT_EQ(HTTP_SERVER_CONN_POOL_SIZE, stat.num_used_max);
+    ASSERT_EQ(stat_before.cnt_exhausted + 1, stat.cnt_exhausted);
+
+    http_server_conn_ctx_t* const p_released_ctx = contexts.back();
+    contexts.pop_back();
+    http_server_conn_pool_release(p_released_ctx);
+    ASSERT_EQ(p_released_ctx, http_server_conn_pool_acquire());
+    contexts.push_back(p_released_ctx);
+
+    for (const auto p_ctx : contexts)
+    {
+        http_server_conn_pool_release(p_ctx);
+    }
+    http_server_get_conn_pool_stat(&stat);
+    ASSERT_EQ(0, stat.num_used);
+    ASSERT_EQ(this->m_cnt_lock, this->m_cnt_unlock);
+}
+
+TEST_F(TestHttpServerConnPool, test_buffers_are_kept_after_release) // NOLINT
+{
+    http_server_conn_ctx_t* const p_ctx       = http_server_conn_pool_acquire();
+    char* const                   p_lin_buf   = p_ctx->p_lin_buf;
+    uint8_t* const                p_chunk_buf = p_ctx->writer.p_chunk_buf;
+    http_server_conn_pool_release(p_ctx);
+
+    http_server_conn_ctx_t* const p_ctx2 = http_server_conn_pool_acquire();
+    ASSERT_EQ(p_ctx, p_ctx2);
+    ASSERT_EQ(p_lin_buf, p_ctx2->p_lin_buf);
+    ASSERT_EQ(p_chunk_buf, p_ctx2->writer.p_chunk_buf);
+    http_server_conn_pool_release(p_ctx2);
+}
@@ -125,7 +125,7 @@ TEST_F(TestHttpServerHandleReqGetAuth, test_req_get_auth_allow) // NOLINT
             = R"({"gateway_name": "RuuviGatewayEEFF", "fw_ver": "1.13.0", "nrf52_fw_ver": "1.0.0", "lan_auth_type": "lan_auth_allow", "lan": true})";
         ASSERT_EQ(HTTP_RESP_CODE_200, resp.http_resp_code);
         ASSERT_EQ(HTTP_CONTENT_LOCATION_STATIC_MEM, resp.content_location);
-        ASSERT_TRUE(resp.flag_no_cache);
+        ASSERT_EQ(HTTP_CACHE_CONTROL_NO_STORE, resp.cache_policy.type);
         ASSERT_TRUE(resp.flag_add_header_date);
         ASSERT_EQ(HTTP_CONTENT_TYPE_APPLICATION_JSON, resp.content_type);
         ASSERT_EQ(nullptr, resp.p_content_type_param);
@@ -174,7 +174,7 @@ TEST_F(TestHttpServerHandleReqGetAuth, test_req_get_auth_allow) // NOLINT
             = R"({"gateway_name": "RuuviGatewayEEFF", "fw_ver": "1.13.0", "nrf52_fw_ver": "1.0.0", "lan_auth_type": "lan_auth_allow", "lan": true})";
         ASSERT_EQ(HTTP_RESP_CODE_200, resp.http_resp_code);
         ASSERT_EQ(HTTP_CONTENT_LOCATION_STATIC_MEM, resp.content_location);
-        ASSERT_TRUE(resp.flag_no_cache);
+        ASSERT_EQ(HTTP_CACHE_CONTROL_NO_STORE, resp.cache_policy.type);
         ASSERT_TRUE(resp.flag_add_header_date);
         ASSERT_EQ(HTTP_CONTENT_TYPE_APPLICATION_JSON, resp.content_type);
         ASSERT_EQ(nullptr, resp.p_content_type_param);
@@ -217,7 +217,7 @@ TEST_F(TestHttpServerHandleReqGetAuth, test_req_get_auth_allow) // NOLINT
             = R"({"gateway_name": "RuuviGatewayEEFF", "fw_ver": "1.13.0", "nrf52_fw_ver": "1.0.0", "lan_auth_type": "lan_auth_allow", "lan": true})";
         ASSERT_EQ(HTTP_RESP_CODE_200, resp.http_resp_code);
         ASSERT_EQ(HTTP_CONTENT_LOCATION_STATIC_MEM, resp.content_location);
-        ASSERT_TRUE(resp.flag_no_cache);
+        ASSERT_EQ(HTTP_CACHE_CONTROL_NO_STORE, resp.cache_policy.type);
         ASSERT_TRUE(resp.flag_add_header_date);
         ASSERT_EQ(HTTP_CONTENT_TYPE_APPLICATION_JSON, resp.content_type);
         ASSERT_EQ(nullptr, resp.p_content_type_param);
@@ -256,7 +256,7 @@ TEST_F(TestHttpServerHandleReqGetAuth, test_req_get_auth_allow) // NOLINT
             = R"({"gateway_name": "RuuviGatewayEEFF", "fw_ver": "1.13.0", "nrf52_fw_ver": "1.0.0", "lan_auth_type": "lan_auth_allow", "lan": true})";
         ASSERT_EQ(HTTP_RESP_CODE_200, resp.http_resp_code);
         ASSERT_EQ(HTTP_CONTENT_LOCATION_STATIC_MEM, resp.content_location);
-        ASSERT_TRUE(resp.flag_no_cache);
+        ASSERT_EQ(HTTP_CACHE_CONTROL_NO_STORE, resp.cache_policy.type);
         ASSERT_TRUE(resp.flag_add_header_date);
         ASSERT_EQ(HTTP_CONTENT_TYPE_APPLICATION_JSON, resp.content_type);
         ASSERT_EQ(nullptr, resp.p_content_type_param);
@@ -295,7 +295,7 @@ TEST_F(TestHttpServerHandleReqGetAuth, test_req_get_auth_allow) // NOLINT
             = R"({"gateway_name": "RuuviGatewayEEFF", "fw_ver": "1.13.0", "nrf52_fw_ver": "1.0.0", "lan_auth_type": "lan_auth_allow", "lan": true})";
         ASSERT_EQ(HTTP_RESP_CODE_200, resp.http_resp_code);
         ASSERT_EQ(HTTP_CONTENT_LOCATION_STATIC_MEM, resp.content_location);
-        ASSERT_TRUE(resp.flag_no_cache);
+        ASSERT_EQ(HTTP_CACHE_CONTROL_NO_STORE, resp.cache_policy.type);
         ASSERT_TRUE(resp.flag_add_header_date);
         ASSERT_EQ(HTTP_CONTENT_TYPE_APPLICATION_JSON, resp.content_type);
         ASSERT_EQ(nullptr, resp.p_content_type_param);
@@ -347,7 +347,7 @@ TEST_F(TestHttpServerHandleReqGetAuth, test_req_check_auth_allow) // NOLINT
     ASSERT_FALSE(flag_access_by_bearer_token);
     ASSERT_EQ(HTTP_RESP_CODE_200, resp.http_resp_code);
     ASSERT_EQ(HTTP_CONTENT_LOCATION_STATIC_MEM, resp.content_location);
-    ASSERT_TRUE(resp.flag_no_cache);
+    ASSERT_EQ(HTTP_CACHE_CONTROL_NO_STORE, resp.cache_policy.type);
     ASSERT_TRUE(resp.flag_add_header_date);
     ASSERT_EQ(HTTP_CONTENT_TYPE_APPLICATION_JSON, resp.content_type);
     ASSERT_EQ(nullptr, resp.p_content_type_param);
@@ -388,7 +388,7 @@ TEST_F(TestHttpServerHandleReqGetAuth, test_auth_allow_when_access_not_from_lan)
         = R"({"gateway_name": "RuuviGatewayEEFF", "fw_ver": "1.13.0", "nrf52_fw_ver": "1.0.0", "lan_auth_type": "lan_auth_allow", "lan": false})";
     ASSERT_EQ(HTTP_RESP_CODE_200, resp.http_resp_code);
     ASSERT_EQ(HTTP_CONTENT_LOCATION_STATIC_MEM, resp.content_location);
-    ASSERT_TRUE(resp.flag_no_cache);
+    ASSERT_EQ(HTTP_CACHE_CONTROL_NO_STORE, resp.cache_policy.type);
     ASSERT_TRUE(resp.flag_add_header_date);
     ASSERT_EQ(HTTP_CONTENT_TYPE_APPLICATION_JSON, resp.content_type);
     ASSERT_EQ(nullptr, resp.p_content_type_param);
@@ -428,7 +428,7 @@ TEST_F(TestHttpServerHandleReqGetAuth, test_auth_deny) // NOLINT
         = R"({"gateway_name": "RuuviGatewayEEFF", "fw_ver": "1.13.0", "nrf52_fw_ver": "1.0.0", "lan_auth_type": "lan_auth_deny", "lan": true})";
     ASSERT_EQ(HTTP_RESP_CODE_403, resp.http_resp_code);
     ASSERT_EQ(HTTP_CONTENT_LOCATION_STATIC_MEM, resp.content_location);
-    ASSERT_TRUE(resp.flag_no_cache);
+    ASSERT_EQ(HTTP_CACHE_CONTROL_NO_STORE, resp.cache_policy.type);
     ASSERT_TRUE(resp.flag_add_header_date);
     ASSERT_EQ(HTTP_CONTENT_TYPE_APPLICATION_JSON, resp.content_type);
     ASSERT_EQ(nullptr, resp.p_content_type_param);
@@ -481,7 +481,7 @@ TEST_F(TestHttpServerHandleReqGetAuth, test_auth_basic_success) // NOLINT
         = R"({"gateway_name": "RuuviGatewayEEFF", "fw_ver": "1.13.0", "nrf52_fw_ver": "1.0.0", "lan_auth_type": "lan_auth_basic", "lan": true})";
     ASSERT_EQ(HTTP_RESP_CODE_200, resp.http_resp_code);
     ASSERT_EQ(HTTP_CONTENT_LOCATION_STATIC_MEM, resp.content_location);
-    ASSERT_TRUE(resp.flag_no_cache);
+    ASSERT_EQ(HTTP_CACHE_CONTROL_NO_STORE, resp.cache_policy.type);
     ASSERT_TRUE(resp.flag_add_header_date);
     ASSERT_EQ(HTTP_CONTENT_TYPE_APPLICATION_JSON, resp.content_type);
     ASSERT_EQ(nullptr, resp.p_content_type_param);
@@ -533,7 +533,7 @@ TEST_F(TestHttpServerHandleReqGetAuth, test_auth_basic_fail_no_header_authorizat
         = R"({"gateway_name": "RuuviGatewayEEFF", "fw_ver": "1.13.0", "nrf52_fw_ver": "1.0.0", "lan_auth_type": "lan_auth_basic", "lan": true})";
     ASSERT_EQ(HTTP_RESP_CODE_401, resp.http_resp_code);
     ASSERT_EQ(HTTP_CONTENT_LOCATION_STATIC_MEM, resp.content_location);
-    ASSERT_TRUE(resp.flag_no_cache);
+    ASSERT_EQ(HTTP_CACHE_CONTROL_NO_STORE, resp.cache_policy.type);
     ASSERT_TRUE(resp.flag_add_header_date);
     ASSERT_EQ(HTTP_CONTENT_TYPE_APPLICATION_JSON, resp.content_type);
     ASSERT_EQ(nullptr, resp.p_content_type_param);
@@ -588,7 +588,7 @@ TEST_F(TestHttpServerHandleReqGetAuth, test_auth_basic_fail_wrong_header_authori
         = R"({"gateway_name": "RuuviGatewayEEFF", "fw_ver": "1.13.0", "nrf52_fw_ver": "1.0.0", "lan_auth_type": "lan_auth_basic", "lan": true})";
     ASSERT_EQ(HTTP_RESP_CODE_401, resp.http_resp_code);
     ASSERT_EQ(HTTP_CONTENT_LOCATION_STATIC_MEM, resp.content_location);
-    ASSERT_TRUE(resp.flag_no_cache);
+    ASSERT_EQ(HTTP_CACHE_CONTROL_NO_STORE, resp.cache_policy.type);
     ASSERT_TRUE(resp.flag_add_header_date);
     ASSERT_EQ(HTTP_CONTENT_TYPE_APPLICATION_JSON, resp.content_type);
     ASSERT_EQ(nullptr, resp.p_content_type_param);
@@ -643,7 +643,7 @@ TEST_F(TestHttpServerHandleReqGetAuth, test_auth_basic_fail_short_password) // N
         = R"({"gateway_name": "RuuviGatewayEEFF", "fw_ver": "1.13.0", "nrf52_fw_ver": "1.0.0", "lan_auth_type": "lan_auth_basic", "lan": true})";
     ASSERT_EQ(HTTP_RESP_CODE_401, resp.http_resp_code);
     ASSERT_EQ(HTTP_CONTENT_LOCATION_STATIC_MEM, resp.content_location);
-    ASSERT_TRUE(resp.flag_no_cache);
+    ASSERT_EQ(HTTP_CACHE_CONTROL_NO_STORE, resp.cache_policy.type);
     ASSERT_TRUE(resp.flag_add_header_date);
     ASSERT_EQ(HTTP_CONTENT_TYPE_APPLICATION_JSON, resp.content_type);
     ASSERT_EQ(nullptr, resp.p_content_type_param);
@@ -698,7 +698,7 @@ TEST_F(TestHttpServerHandleReqGetAuth, test_auth_basic_fail_incorrect_password)
         = R"({"gateway_name": "RuuviGatewayEEFF", "fw_ver": "1.13.0", "nrf52_fw_ver": "1.0.0", "lan_auth_type": "lan_auth_basic", "lan": true})";
     ASSERT_EQ(HTTP_RESP_CODE_401, resp.http_resp_code);
     ASSERT_EQ(HTTP_CONTENT_LOCATION_STATIC_MEM, resp.content_location);
-    ASSERT_TRUE(resp.flag_no_cache);
+    ASSERT_EQ(HTTP_CACHE_CONTROL_NO_STORE, resp.cache_policy.type);
     ASSERT_TRUE(resp.flag_add_header_date);
     ASSERT_EQ(HTTP_CONTENT_TYPE_APPLICATION_JSON, resp.content_type);
     ASSERT_EQ(nullptr, resp.p_content_type_param);
@@ -757,7 +757,7 @@ TEST_F(TestHttpServerHandleReqGetAuth, test_auth_digest_success) // NOLINT
         = R"({"gateway_name": "RuuviGatewayEEFF", "fw_ver": "1.13.0", "nrf52_fw_ver": "1.0.0", "lan_auth_type": "lan_auth_digest", "lan": true})";
     ASSERT_EQ(HTTP_RESP_CODE_200, resp.http_resp_code);
     ASSERT_EQ(HTTP_CONTENT_LOCATION_STATIC_MEM, resp.content_location);
-    ASSERT_TRUE(resp.flag_no_cache);
+    ASSERT_EQ(HTTP_CACHE_CONTROL_NO_STORE, resp.cache_policy.type);
     ASSERT_TRUE(resp.flag_add_header_date);
     ASSERT_EQ(HTTP_CONTENT_TYPE_APPLICATION_JSON, resp.content_type);
     ASSERT_EQ(nullptr, resp.p_content_type_param);
@@ -811,7 +811,7 @@ TEST_F(TestHttpServerHandleReqGetAuth, test_auth_digest_fail_no_header_authoriza
         = R"({"gateway_name": "RuuviGatewayEEFF", "fw_ver": "1.13.0", "nrf52_fw_ver": "1.0.0", "lan_auth_type": "lan_auth_digest", "lan": true})";
     ASSERT_EQ(HTTP_RESP_CODE_401, resp.http_resp_code);
     ASSERT_EQ(HTTP_CONTENT_LOCATION_STATIC_MEM, resp.content_location);
-    ASSERT_TRUE(resp.flag_no_cache);
+    ASSERT_EQ(HTTP_CACHE_CONTROL_NO_STORE, resp.cache_policy.type);
     ASSERT_TRUE(resp.flag_add_header_date);
     ASSERT_EQ(HTTP_CONTENT_TYPE_APPLICATION_JSON, resp.content_type);
     ASSERT_EQ(nullptr, resp.p_content_type_param);
@@ -869,7 +869,7 @@ TEST_F(TestHttpServerHandleReqGetAuth, test_auth_digest_fail_wrong_header_author
         = R"({"gateway_name": "RuuviGatewayEEFF", "fw_ver": "1.13.0", "nrf52_fw_ver": "1.0.0", "lan_auth_type": "lan_auth_digest", "lan": true})";
     ASSERT_EQ(HTTP_RESP_CODE_401, resp.http_resp_code);
     ASSERT_EQ(HTTP_CONTENT_LOCATION_STATIC_MEM, resp.content_location);
-    ASSERT_TRUE(resp.flag_no_cache);
+    ASSERT_EQ(HTTP_CACHE_CONTROL_NO_STORE, resp.cache_policy.type);
     ASSERT_TRUE(resp.flag_add_header_date);
     ASSERT_EQ(HTTP_CONTENT_TYPE_APPLICATION_JSON, resp.content_type);
     ASSERT_EQ(nullptr, resp.p_content_type_param);
@@ -928,7 +928,7 @@ TEST_F(TestHttpServerHandleReqGetAuth, test_auth_digest_fail_wrong_password) //
         = R"({"gateway_name": "RuuviGatewayEEFF", "fw_ver": "1.13.0", "nrf52_fw_ver": "1.0.0", "lan_auth_type": "lan_auth_digest", "lan": true})";
     ASSERT_EQ(HTTP_RESP_CODE_401, resp.http_resp_code);
     ASSERT_EQ(HTTP_CONTENT_LOCATION_STATIC_MEM, resp.content_location);
-    ASSERT_TRUE(resp.flag_no_cache);
+    ASSERT_EQ(HTTP_CACHE_CONTROL_NO_STORE, resp.cache_policy.type);
     ASSERT_TRUE(resp.flag_add_header_date);
     ASSERT_EQ(HTTP_CONTENT_TYPE_APPLICATION_JSON, resp.content_type);
     ASSERT_EQ(nullptr, resp.p_content_type_param);
@@ -987,7 +987,7 @@ TEST_F(TestHttpServerHandleReqGetAuth, test_auth_digest_fail_wrong_user) // NOLI
         = R"({"gateway_name": "RuuviGatewayEEFF", "fw_ver": "1.13.0", "nrf52_fw_ver": "1.0.0", "lan_auth_type": "lan_auth_digest", "lan": true})";
     ASSERT_EQ(HTTP_RESP_CODE_401, resp.http_resp_code);
     ASSERT_EQ(HTTP_CONTENT_LOCATION_STATIC_MEM, resp.content_location);
-    ASSERT_TRUE(resp.flag_no_cache);
+    ASSERT_EQ(HTTP_CACHE_CONTROL_NO_STORE, resp.cache_policy.type);
     ASSERT_TRUE(resp.flag_add_header_date);
     ASSERT_EQ(HTTP_CONTENT_TYPE_APPLICATION_JSON, resp.content_type);
     ASSERT_EQ(nullptr, resp.p_content_type_param);
@@ -1046,7 +1046,7 @@ TEST_F(TestHttpServerHandleReqGetAuth, test_auth_ruuvi_success) // NOLINT
             = R"({"gateway_name": "RuuviGatewayEEFF", "fw_ver": "1.13.0", "nrf52_fw_ver": "1.0.0", "lan_auth_type": "lan_auth_ruuvi", "lan": true})";
         ASSERT_EQ(HTTP_RESP_CODE_401, resp.http_resp_code);
         ASSERT_EQ(HTTP_CONTENT_LOCATION_STATIC_MEM, resp.content_location);
-        ASSERT_TRUE(resp.flag_no_cache);
+        ASSERT_EQ(HTTP_CACHE_CONTROL_NO_STORE, resp.cache_policy.type);
         ASSERT_TRUE(resp.flag_add_header_date);
         ASSERT_EQ(HTTP_CONTENT_TYPE_APPLICATION_JSON, resp.content_type);
         ASSERT_EQ(nullptr, resp.p_content_type_param);
@@ -1093,7 +1093,7 @@ TEST_F(TestHttpServerHandleReqGetAuth, test_auth_ruuvi_success) // NOLINT
             = R"({"gateway_name": "RuuviGatewayEEFF", "fw_ver": "1.13.0", "nrf52_fw_ver": "1.0.0", "lan_auth_type": "lan_auth_ruuvi", "lan": true})";
         ASSERT_EQ(HTTP_RESP_CODE_200, resp.http_resp_code);
         ASSERT_EQ(HTTP_CONTENT_LOCATION_STATIC_MEM, resp.content_location);
-        ASSERT_TRUE(resp.flag_no_cache);
+        ASSERT_EQ(HTTP_CACHE_CONTROL_NO_STORE, resp.cache_policy.type);
         ASSERT_TRUE(resp.flag_add_header_date);
         ASSERT_EQ(HTTP_CONTENT_TYPE_APPLICATION_JSON, resp.content_type);
         ASSERT_EQ(nullptr, resp.p_content_type_param);
@@ -1123,7 +1123,7 @@ TEST_F(TestHttpServerHandleReqGetAuth, test_auth_ruuvi_success) // NOLINT
             = R"({"gateway_name": "RuuviGatewayEEFF", "fw_ver": "1.13.0", "nrf52_fw_ver": "1.0.0", "lan_auth_type": "lan_auth_ruuvi", "lan": true})";
         ASSERT_EQ(HTTP_RESP_CODE_200, resp.http_resp_code);
         ASSERT_EQ(HTTP_CONTENT_LOCATION_STATIC_MEM, resp.content_location);
-        ASSERT_TRUE(resp.flag_no_cache);
+        ASSERT_EQ(HTTP_CACHE_CONTROL_NO_STORE, resp.cache_policy.type);
         ASSERT_TRUE(resp.flag_add_header_date);
         ASSERT_EQ(HTTP_CONTENT_TYPE_APPLICATION_JSON, resp.content_type);
         ASSERT_EQ(nullptr, resp.p_content_type_param);
@@ -1147,7 +1147,7 @@ TEST_F(TestHttpServerHandleReqGetAuth, test_auth_ruuvi_success) // NOLINT
         const string exp_json_resp = R"({})";
         ASSERT_EQ(HTTP_RESP_CODE_200, resp.http_resp_code);
         ASSERT_EQ(HTTP_CONTENT_LOCATION_STATIC_MEM, resp.content_location);
-        ASSERT_TRUE(resp.flag_no_cache);
+        ASSERT_EQ(HTTP_CACHE_CONTROL_NO_STORE, resp.cache_policy.type);
         ASSERT_TRUE(resp.flag_add_header_date);
         ASSERT_EQ(HTTP_CONTENT_TYPE_APPLICATION_JSON, resp.content_type);
         ASSERT_EQ(nullptr, resp.p_content_type_param);
@@ -1176,7 +1176,7 @@ TEST_F(TestHttpServerHandleReqGetAuth, test_auth_ruuvi_success) // NOLINT
             = R"({"gateway_name": "RuuviGatewayEEFF", "fw_ver": "1.13.0", "nrf52_fw_ver": "1.0.0", "lan_auth_type": "lan_auth_ruuvi", "lan": true})";
         ASSERT_EQ(HTTP_RESP_CODE_401, resp.http_resp_code);
         ASSERT_EQ(HTTP_CONTENT_LOCATION_STATIC_MEM, resp.content_location);
-        ASSERT_TRUE(resp.flag_no_cache);
+        ASSERT_EQ(HTTP_CACHE_CONTROL_NO_STORE, resp.cache_policy.type);
         ASSERT_TRUE(resp.flag_add_header_date);
         ASSERT_EQ(HTTP_CONTENT_TYPE_APPLICATION_JSON, resp.content_type);
         ASSERT_EQ(nullptr, resp.p_content_type_param);
@@ -1237,7 +1237,7 @@ TEST_F(TestHttpServerHandleReqGetAuth, test_auth_ruuvi_fail_wrong_password) // N
             = R"({"gateway_name": "RuuviGatewayEEFF", "fw_ver": "1.13.0", "nrf52_fw_ver": "1.0.0", "lan_auth_type": "lan_auth_ruuvi", "lan": true})";
         ASSERT_EQ(HTTP_RESP_CODE_401, resp.http_resp_code);
         ASSERT_EQ(HTTP_CONTENT_LOCATION_STATIC_MEM, resp.content_location);
-        ASSERT_TRUE(resp.flag_no_cache);
+        ASSERT_EQ(HTTP_CACHE_CONTROL_NO_STORE, resp.cache_policy.type);
         ASSERT_TRUE(resp.flag_add_header_date);
         ASSERT_EQ(HTTP_CONTENT_TYPE_APPLICATION_JSON, resp.content_type);
         ASSERT_EQ(nullptr, resp.p_content_type_param);
@@ -1286,7 +1286,7 @@ TEST_F(TestHttpServerHandleReqGetAuth, test_auth_ruuvi_fail_wrong_password) // N
             = R"({"gateway_name": "RuuviGatewayEEFF", "fw_ver": "1.13.0", "nrf52_fw_ver": "1.0.0", "lan_auth_type": "lan_auth_ruuvi", "lan": true})";
         ASSERT_EQ(HTTP_RESP_CODE_401, resp.http_resp_code);
         ASSERT_EQ(HTTP_CONTENT_LOCATION_STATIC_MEM, resp.content_location);
-        ASSERT_TRUE(resp.flag_no_cache);
+        ASSERT_EQ(HTTP_CACHE_CONTROL_NO_STORE, resp.cache_policy.type);
         ASSERT_TRUE(resp.flag_add_header_date);
         ASSERT_EQ(HTTP_CONTENT_TYPE_APPLICATION_JSON, resp.content_type);
         ASSERT_EQ(nullptr, resp.p_content_type_param);
@@ -1347,7 +1347,7 @@ TEST_F(TestHttpServerHandleReqGetAuth, test_auth_ruuvi_fail_wrong_user) // NOLIN
             = R"({"gateway_name": "RuuviGatewayEEFF", "fw_ver": "1.13.0", "nrf52_fw_ver": "1.0.0", "lan_auth_type": "lan_auth_ruuvi", "lan": true})";
         ASSERT_EQ(HTTP_RESP_CODE_401, resp.http_resp_code);
         ASSERT_EQ(HTTP_CONTENT_LOCATION_STATIC_MEM, resp.content_location);
-        ASSERT_TRUE(resp.flag_no_cache);
+        ASSERT_EQ(HTTP_CACHE_CONTROL_NO_STORE, resp.cache_policy.type);
         ASSERT_TRUE(resp.flag_add_header_date);
         ASSERT_EQ(HTTP_CONTENT_TYPE_APPLICATION_JSON, resp.content_type);
         ASSERT_EQ(nullptr, resp.p_content_type_param);
@@ -1396,7 +1396,7 @@ TEST_F(TestHttpServerHandleReqGetAuth, test_auth_ruuvi_fail_wrong_user) // NOLIN
             = R"({"gateway_name": "RuuviGatewayEEFF", "fw_ver": "1.13.0", "nrf52_fw_ver": "1.0.0", "lan_auth_type": "lan_auth_ruuvi", "lan": true})";
         ASSERT_EQ(HTTP_RESP_CODE_401, resp.http_resp_code);
         ASSERT_EQ(HTTP_CONTENT_LOCATION_STATIC_MEM, resp.content_location);
-        ASSERT_TRUE(resp.flag_no_cache);
+        ASSERT_EQ(HTTP_CACHE_CONTROL_NO_STORE, resp.cache_policy.type);
         ASSERT_TRUE(resp.flag_add_header_date);
         ASSERT_EQ(HTTP_CONTENT_TYPE_APPLICATION_JSON, resp.content_type);
         ASSERT_EQ(nullptr, resp.p_content_type_param);
@@ -1457,7 +1457,7 @@ TEST_F(TestHttpServerHandleReqGetAuth, test_auth_ruuvi_fail_empty_user) // NOLIN
             = R"({"gateway_name": "RuuviGatewayEEFF", "fw_ver": "1.13.0", "nrf52_fw_ver": "1.0.0", "lan_auth_type": "lan_auth_ruuvi", "lan": true})";
         ASSERT_EQ(HTTP_RESP_CODE_401, resp.http_resp_code);
         ASSERT_EQ(HTTP_CONTENT_LOCATION_STATIC_MEM, resp.content_location);
-        ASSERT_TRUE(resp.flag_no_cache);
+        ASSERT_EQ(HTTP_CACHE_CONTROL_NO_STORE, resp.cache_policy.type);
         ASSERT_TRUE(resp.flag_add_header_date);
         ASSERT_EQ(HTTP_CONTENT_TYPE_APPLICATION_JSON, resp.content_type);
         ASSERT_EQ(nullptr, resp.p_content_type_param);
@@ -1506,7 +1506,7 @@ TEST_F(TestHttpServerHandleReqGetAuth, test_auth_ruuvi_fail_empty_user) // NOLIN
             = R"({"gateway_name": "RuuviGatewayEEFF", "fw_ver": "1.13.0", "nrf52_fw_ver": "1.0.0", "lan_auth_type": "lan_auth_ruuvi", "lan": true})";
         ASSERT_EQ(HTTP_RESP_CODE_401, resp.http_resp_code);
         ASSERT_EQ(HTTP_CONTENT_LOCATION_STATIC_MEM, resp.content_location);
-        ASSERT_TRUE(resp.flag_no_cache);
+        ASSERT_EQ(HTTP_CACHE_CONTROL_NO_STORE, resp.cache_policy.type);
         ASSERT_TRUE(resp.flag_add_header_date);
         ASSERT_EQ(HTTP_CONTENT_TYPE_APPLICATION_JSON, resp.content_type);
         ASSERT_EQ(nullptr, resp.p_content_type_param);
@@ -1567,7 +1567,7 @@ TEST_F(TestHttpServerHandleReqGetAuth, test_auth_ruuvi_fail_wrong_realm) // NOLI
             = R"({"gateway_name": "RuuviGatewayEEFF", "fw_ver": "1.13.0", "nrf52_fw_ver": "1.0.0", "lan_auth_type": "lan_auth_ruuvi", "lan": true})";
         ASSERT_EQ(HTTP_RESP_CODE_401, resp.http_resp_code);
         ASSERT_EQ(HTTP_CONTENT_LOCATION_STATIC_MEM, resp.content_location);
-        ASSERT_TRUE(resp.flag_no_cache);
+        ASSERT_EQ(HTTP_CACHE_CONTROL_NO_STORE, resp.cache_policy.type);
         ASSERT_TRUE(resp.flag_add_header_date);
         ASSERT_EQ(HTTP_CONTENT_TYPE_APPLICATION_JSON, resp.content_type);
         ASSERT_EQ(nullptr, resp.p_content_type_param);
@@ -1616,7 +1616,7 @@ TEST_F(TestHttpServerHandleReqGetAuth, test_auth_ruuvi_fail_wrong_realm) // NOLI
             = R"({"gateway_name": "RuuviGatewayEEFF", "fw_ver": "1.13.0", "nrf52_fw_ver": "1.0.0", "lan_auth_type": "lan_auth_ruuvi", "lan": true})";
         ASSERT_EQ(HTTP_RESP_CODE_401, resp.http_resp_code);
         ASSERT_EQ(HTTP_CONTENT_LOCATION_STATIC_MEM, resp.content_location);
-        ASSERT_TRUE(resp.flag_no_cache);
+        ASSERT_EQ(HTTP_CACHE_CONTROL_NO_STORE, resp.cache_policy.type);
         ASSERT_TRUE(resp.flag_add_header_date);
         ASSERT_EQ(HTTP_CONTENT_TYPE_APPLICATION_JSON, resp.content_type);
         ASSERT_EQ(nullptr, resp.p_content_type_param);
@@ -1677,7 +1677,7 @@ TEST_F(TestHttpServerHandleReqGetAuth, test_auth_ruuvi_fail_wrong_remote_ip) //
             = R"({"gateway_name": "RuuviGatewayEEFF", "fw_ver": "1.13.0", "nrf52_fw_ver": "1.0.0", "lan_auth_type": "lan_auth_ruuvi", "lan": true})";
         ASSERT_EQ(HTTP_RESP_CODE_401, resp.http_resp_code);
         ASSERT_EQ(HTTP_CONTENT_LOCATION_STATIC_MEM, resp.content_location);
-        ASSERT_TRUE(resp.flag_no_cache);
+        ASSERT_EQ(HTTP_CACHE_CONTROL_NO_STORE, resp.cache_policy.type);
         ASSERT_TRUE(resp.flag_add_header_date);
         ASSERT_EQ(HTTP_CONTENT_TYPE_APPLICATION_JSON, resp.content_type);
         ASSERT_EQ(nullptr, resp.p_content_type_param);
@@ -1726,7 +1726,7 @@ TEST_F(TestHttpServerHandleReqGetAuth, test_auth_ruuvi_fail_wrong_remote_ip) //
             = R"({"gateway_name": "RuuviGatewayEEFF", "fw_ver": "1.13.0", "nrf52_fw_ver": "1.0.0", "lan_auth_type": "lan_auth_ruuvi", "lan": true})";
         ASSERT_EQ(HTTP_RESP_CODE_401, resp.http_resp_code);
         ASSERT_EQ(HTTP_CONTENT_LOCATION_STATIC_MEM, resp.content_location);
-        ASSERT_TRUE(resp.flag_no_cache);
+        ASSERT_EQ(HTTP_CACHE_CONTROL_NO_STORE, resp.cache_policy.type);
         ASSERT_TRUE(resp.flag_add_header_date);
         ASSERT_EQ(HTTP_CONTENT_TYPE_APPLICATION_JSON, resp.content_type);
         ASSERT_EQ(nullptr, resp.p_content_type_param);
@@ -1787,7 +1787,7 @@ TEST_F(TestHttpServerHandleReqGetAuth, test_auth_ruuvi_fail_wrong_session_id) //
             = R"({"gateway_name": "RuuviGatewayEEFF", "fw_ver": "1.13.0", "nrf52_fw_ver": "1.0.0", "lan_auth_type": "lan_auth_ruuvi", "lan": true})";
         ASSERT_EQ(HTTP_RESP_CODE_401, resp.http_resp_code);
         ASSERT_EQ(HTTP_CONTENT_LOCATION_STATIC_MEM, resp.content_location);
-        ASSERT_TRUE(resp.flag_no_cache);
+        ASSERT_EQ(HTTP_CACHE_CONTROL_NO_STORE, resp.cache_policy.type);
         ASSERT_TRUE(resp.flag_add_header_date);
         ASSERT_EQ(HTTP_CONTENT_TYPE_APPLICATION_JSON, resp.content_type);
         ASSERT_EQ(nullptr, resp.p_content_type_param);
@@ -1836,7 +1836,7 @@ TEST_F(TestHttpServerHandleReqGetAuth, test_auth_ruuvi_fail_wrong_session_id) //
             = R"({"gateway_name": "RuuviGatewayEEFF", "fw_ver": "1.13.0", "nrf52_fw_ver": "1.0.0", "lan_auth_type": "lan_auth_ruuvi", "lan": true})";
         ASSERT_EQ(HTTP_RESP_CODE_401, resp.http_resp_code);
         ASSERT_EQ(HTTP_CONTENT_LOCATION_STATIC_MEM, resp.content_location);
-        ASSERT_TRUE(resp.flag_no_cache);
+        ASSERT_EQ(HTTP_CACHE_CONTROL_NO_STORE, resp.cache_policy.type);
         ASSERT_TRUE(resp.flag_add_header_date);
         ASSERT_EQ(HTTP_CONTENT_TYPE_APPLICATION_JSON, resp.content_type);
         ASSERT_EQ(nullptr, resp.p_content_type_param);
@@ -1897,7 +1897,7 @@ TEST_F(TestHttpServerHandleReqGetAuth, test_auth_ruuvi_fail_empty_session_id) //
             = R"({"gateway_name": "RuuviGatewayEEFF", "fw_ver": "1.13.0", "nrf52_fw_ver": "1.0.0", "lan_auth_type": "lan_auth_ruuvi", "lan": true})";
         ASSERT_EQ(HTTP_RESP_CODE_401, resp.http_resp_code);
         ASSERT_EQ(HTTP_CONTENT_LOCATION_STATIC_MEM, resp.content_location);
-        ASSERT_TRUE(resp.flag_no_cache);
+        ASSERT_EQ(HTTP_CACHE_CONTROL_NO_STORE, resp.cache_policy.type);
         ASSERT_TRUE(resp.flag_add_header_date);
         ASSERT_EQ(HTTP_CONTENT_TYPE_APPLICATION_JSON, resp.content_type);
         ASSERT_EQ(nullptr, resp.p_content_type_param);
@@ -1946,7 +1946,7 @@ TEST_F(TestHttpServerHandleReqGetAuth, test_auth_ruuvi_fail_empty_session_id) //
             = R"({"gateway_name": "RuuviGatewayEEFF", "fw_ver": "1.13.0", "nrf52_fw_ver": "1.0.0", "lan_auth_type": "lan_auth_ruuvi", "lan": true})";
         ASSERT_EQ(HTTP_RESP_CODE_401, resp.http_resp_code);
         ASSERT_EQ(HTTP_CONTENT_LOCATION_STATIC_MEM, resp.content_location);
-        ASSERT_TRUE(resp.flag_no_cache);
+        ASSERT_EQ(HTTP_CACHE_CONTROL_NO_STORE, resp.cache_policy.type);
         ASSERT_TRUE(resp.flag_add_header_date);
         ASSERT_EQ(HTTP_CONTENT_TYPE_APPLICATION_JSON, resp.content_type);
         ASSERT_EQ(nullptr, resp.p_content_type_param);
@@ -2007,7 +2007,7 @@ TEST_F(TestHttpServerHandleReqGetAuth, test_auth_ruuvi_fail_no_session_id) // NO
             = R"({"gateway_name": "RuuviGatewayEEFF", "fw_ver": "1.13.0", "nrf52_fw_ver": "1.0.0", "lan_auth_type": "lan_auth_ruuvi", "lan": true})";
         ASSERT_EQ(HTTP_RESP_CODE_401, resp.http_resp_code);
         ASSERT_EQ(HTTP_CONTENT_LOCATION_STATIC_MEM, resp.content_location);
-        ASSERT_TRUE(resp.flag_no_cache);
+        ASSERT_EQ(HTTP_CACHE_CONTROL_NO_STORE, resp.cache_policy.type);
         ASSERT_TRUE(resp.flag_add_header_date);
         ASSERT_EQ(HTTP_CONTENT_TYPE_APPLICATION_JSON, resp.content_type);
         ASSERT_EQ(nullptr, resp.p_content_type_param);
@@ -2055,7 +2055,7 @@ TEST_F(TestHttpServerHandleReqGetAuth, test_auth_ruuvi_fail_no_session_id) // NO
             = R"({"gateway_name": "RuuviGatewayEEFF", "fw_ver": "1.13.0", "nrf52_fw_ver": "1.0.0", "lan_auth_type": "lan_auth_ruuvi", "lan": true})";
         ASSERT_EQ(HTTP_RESP_CODE_401, resp.http_resp_code);
         ASSERT_EQ(HTTP_CONTENT_LOCATION_STATIC_MEM, resp.content_location);
-        ASSERT_TRUE(resp.flag_no_cache);
+        ASSERT_EQ(HTTP_CACHE_CONTROL_NO_STORE, resp.cache_policy.type);
         ASSERT_TRUE(resp.flag_add_header_date);
         ASSERT_EQ(HTTP_CONTENT_TYPE_APPLICATION_JSON, resp.content_type);
         ASSERT_EQ(nullptr, resp.p_content_type_param);
@@ -2116,7 +2116,7 @@ TEST_F(TestHttpServerHandleReqGetAuth, test_auth_ruuvi_fail_bad_body_missing_quo
             = R"({"gateway_name": "RuuviGatewayEEFF", "fw_ver": "1.13.0", "nrf52_fw_ver": "1.0.0", "lan_auth_type": "lan_auth_ruuvi", "lan": true})";
         ASSERT_EQ(HTTP_RESP_CODE_401, resp.http_resp_code);
         ASSERT_EQ(HTTP_CONTENT_LOCATION_STATIC_MEM, resp.content_location);
-        ASSERT_TRUE(resp.flag_no_cache);
+        ASSERT_EQ(HTTP_CACHE_CONTROL_NO_STORE, resp.cache_policy.type);
         ASSERT_TRUE(resp.flag_add_header_date);
         ASSERT_EQ(HTTP_CONTENT_TYPE_APPLICATION_JSON, resp.content_type);
         ASSERT_EQ(nullptr, resp.p_content_type_param);
@@ -2165,7 +2165,7 @@ TEST_F(TestHttpServerHandleReqGetAuth, test_auth_ruuvi_fail_bad_body_missing_quo
             = R"({"gateway_name": "RuuviGatewayEEFF", "fw_ver": "1.13.0", "nrf52_fw_ver": "1.0.0", "lan_auth_type": "lan_auth_ruuvi", "lan": true})";
         ASSERT_EQ(HTTP_RESP_CODE_401, resp.http_resp_code);
         ASSERT_EQ(HTTP_CONTENT_LOCATION_STATIC_MEM, resp.content_location);
-        ASSERT_TRUE(resp.flag_no_cache);
+        ASSERT_EQ(HTTP_CACHE_CONTROL_NO_STORE, resp.cache_policy.type);
         ASSERT_TRUE(resp.flag_add_header_date);
         ASSERT_EQ(HTTP_CONTENT_TYPE_APPLICATION_JSON, resp.content_type);
         ASSERT_EQ(nullptr, resp.p_content_type_param);
@@ -2226,7 +2226,7 @@ TEST_F(TestHttpServerHandleReqGetAuth, test_auth_ruuvi_fail_bad_body_no_username
             = R"({"gateway_name": "RuuviGatewayEEFF", "fw_ver": "1.13.0", "nrf52_fw_ver": "1.0.0", "lan_auth_type": "lan_auth_ruuvi", "lan": true})";
         ASSERT_EQ(HTTP_RESP_CODE_401, resp.http_resp_code);
         ASSERT_EQ(HTTP_CONTENT_LOCATION_STATIC_MEM, resp.content_location);
-        ASSERT_TRUE(resp.flag_no_cache);
+        ASSERT_EQ(HTTP_CACHE_CONTROL_NO_STORE, resp.cache_policy.type);
         ASSERT_TRUE(resp.flag_add_header_date);
         ASSERT_EQ(HTTP_CONTENT_TYPE_APPLICATION_JSON, resp.content_type);
         ASSERT_EQ(nullptr, resp.p_content_type_param);
@@ -2274,7 +2274,7 @@ TEST_F(TestHttpServerHandleReqGetAuth, test_auth_ruuvi_fail_bad_body_no_username
             = R"({"gateway_name": "RuuviGatewayEEFF", "fw_ver": "1.13.0", "nrf52_fw_ver": "1.0.0", "lan_auth_type": "lan_auth_ruuvi", "lan": true})";
         ASSERT_EQ(HTTP_RESP_CODE_401, resp.http_resp_code);
         ASSERT_EQ(HTTP_CONTENT_LOCATION_STATIC_MEM, resp.content_location);
-        ASSERT_TRUE(resp.flag_no_cache);
+        ASSERT_EQ(HTTP_CACHE_CONTROL_NO_STORE, resp.cache_policy.type);
         ASSERT_TRUE(resp.flag_add_header_date);
         ASSERT_EQ(HTTP_CONTENT_TYPE_APPLICATION_JSON, resp.content_type);
         ASSERT_EQ(nullptr, resp.p_content_type_param);
@@ -2335,7 +2335,7 @@ TEST_F(TestHttpServerHandleReqGetAuth, test_auth_ruuvi_fail_bad_body_no_password
             = R"({"gateway_name": "RuuviGatewayEEFF", "fw_ver": "1.13.0", "nrf52_fw_ver": "1.0.0", "lan_auth_type": "lan_auth_ruuvi", "lan": true})";
         ASSERT_EQ(HTTP_RESP_CODE_401, resp.http_resp_code);
         ASSERT_EQ(HTTP_CONTENT_LOCATION_STATIC_MEM, resp.content_location);
-        ASSERT_TRUE(resp.flag_no_cache);
+        ASSERT_EQ(HTTP_CACHE_CONTROL_NO_STORE, resp.cache_policy.type);
         ASSERT_TRUE(resp.flag_add_header_date);
         ASSERT_EQ(HTTP_CONTENT_TYPE_APPLICATION_JSON, resp.content_type);
         ASSERT_EQ(nullptr, resp.p_content_type_param);
@@ -2372,7 +2372,7 @@ TEST_F(TestHttpServerHandleReqGetAuth, test_auth_ruuvi_fail_bad_body_no_password
             = R"({"gateway_name": "RuuviGatewayEEFF", "fw_ver": "1.13.0", "nrf52_fw_ver": "1.0.0", "lan_auth_type": "lan_auth_ruuvi", "lan": true})";
         ASSERT_EQ(HTTP_RESP_CODE_401, resp.http_resp_code);
         ASSERT_EQ(HTTP_CONTENT_LOCATION_STATIC_MEM, resp.content_location);
-        ASSERT_TRUE(resp.flag_no_cache);
+        ASSERT_EQ(HTTP_CACHE_CONTROL_NO_STORE, resp.cache_policy.type);
         ASSERT_TRUE(resp.flag_add_header_date);
         ASSERT_EQ(HTTP_CONTENT_TYPE_APPLICATION_JSON, resp.content_type);
         ASSERT_EQ(nullptr, resp.p_content_type_param);
@@ -2440,7 +2440,7 @@ TEST_F(TestHttpServerHandleReqGetAuth, test_auth_bearer_non_empty_success) // NO
         = R"({"gateway_name": "RuuviGatewayEEFF", "fw_ver": "1.13.0", "nrf52_fw_ver": "1.0.0", "lan_auth_type": "lan_auth_bearer", "lan": true})";
     ASSERT_EQ(HTTP_RESP_CODE_200, resp.http_resp_code);
     ASSERT_EQ(HTTP_CONTENT_LOCATION_STATIC_MEM, resp.content_location);
-    ASSERT_TRUE(resp.flag_no_cache);
+    ASSERT_EQ(HTTP_CACHE_CONTROL_NO_STORE, resp.cache_policy.type);
     ASSERT_TRUE(resp.flag_add_header_date);
     ASSERT_EQ(HTTP_CONTENT_TYPE_APPLICATION_JSON, resp.content_type);
     ASSERT_EQ(nullptr, resp.p_content_type_param);
@@ -2510,7 +2510,7 @@ TEST_F(TestHttpServerHandleReqGetAuth, test_auth_bearer_non_empty_rw_access_to_r
         = R"({"gateway_name": "RuuviGatewayEEFF", "fw_ver": "1.13.0", "nrf52_fw_ver": "1.0.0", "lan_auth_type": "lan_auth_bearer", "lan": true})";
     ASSERT_EQ(HTTP_RESP_CODE_200, resp.http_resp_code);
     ASSERT_EQ(HTTP_CONTENT_LOCATION_STATIC_MEM, resp.content_location);
-    ASSERT_TRUE(resp.flag_no_cache);
+    ASSERT_EQ(HTTP_CACHE_CONTROL_NO_STORE, resp.cache_policy.type);
     ASSERT_TRUE(resp.flag_add_header_date);
     ASSERT_EQ(HTTP_CONTENT_TYPE_APPLICATION_JSON, resp.content_type);
     ASSERT_EQ(nullptr, resp.p_content_type_param);
@@ -2580,7 +2580,7 @@ TEST_F(TestHttpServerHandleReqGetAuth, test_auth_bearer_non_empty_rw_access_to_r
         = R"({"gateway_name": "RuuviGatewayEEFF", "fw_ver": "1.13.0", "nrf52_fw_ver": "1.0.0", "lan_auth_type": "lan_auth_bearer", "lan": true})";
     ASSERT_EQ(HTTP_RESP_CODE_200, resp.http_resp_code);
     ASSERT_EQ(HTTP_CONTENT_LOCATION_STATIC_MEM, resp.content_location);
-    ASSERT_TRUE(resp.flag_no_cache);
+    ASSERT_EQ(HTTP_CACHE_CONTROL_NO_STORE, resp.cache_policy.type);
     ASSERT_TRUE(resp.flag_add_header_date);
     ASSERT_EQ(HTTP_CONTENT_TYPE_APPLICATION_JSON, resp.content_type);
     ASSERT_EQ(nullptr, resp.p_content_type_param);
@@ -2650,7 +2650,7 @@ TEST_F(TestHttpServerHandleReqGetAuth, test_auth_bearer_non_empty_ro_access_to_r
         = R"({"gateway_name": "RuuviGatewayEEFF", "fw_ver": "1.13.0", "nrf52_fw_ver": "1.0.0", "lan_auth_type": "lan_auth_bearer", "lan": true})";
     ASSERT_EQ(HTTP_RESP_CODE_401, resp.http_resp_code);
     ASSERT_EQ(HTTP_CONTENT_LOCATION_STATIC_MEM, resp.content_location);
-    ASSERT_TRUE(resp.flag_no_cache);
+    ASSERT_EQ(HTTP_CACHE_CONTROL_NO_STORE, resp.cache_policy.type);
     ASSERT_TRUE(resp.flag_add_header_date);
     ASSERT_EQ(HTTP_CONTENT_TYPE_APPLICATION_JSON, resp.content_type);
     ASSERT_EQ(nullptr, resp.p_content_type_param);
@@ -2715,7 +2715,7 @@ TEST_F(TestHttpServerHandleReqGetAuth, test_auth_bearer_non_empty_failed_differe
         &flag_access_by_bearer_token);
     ASSERT_EQ(HTTP_RESP_CODE_401, resp.http_resp_code);
     ASSERT_EQ(HTTP_CONTENT_LOCATION_STATIC_MEM, resp.content_location);
-    ASSERT_TRUE(resp.flag_no_cache);
+    ASSERT_EQ(HTTP_CACHE_CONTROL_NO_STORE, resp.cache_policy.type);
     ASSERT_TRUE(resp.flag_add_header_date);
     ASSERT_EQ(HTTP_CONTENT_TYPE_APPLICATION_JSON, resp.content_type);
     ASSERT_EQ(nullptr, resp.p_content_type_param);
@@ -2779,7 +2779,7 @@ TEST_F(TestHttpServerHandleReqGetAuth, test_auth_bearer_non_empty_failed_wrong_a
         &flag_access_by_bearer_token);
     ASSERT_EQ(HTTP_RESP_CODE_401, resp.http_resp_code);
     ASSERT_EQ(HTTP_CONTENT_LOCATION_STATIC_MEM, resp.content_location);
-    ASSERT_TRUE(resp.flag_no_cache);
+    ASSERT_EQ(HTTP_CACHE_CONTROL_NO_STORE, resp.cache_policy.type);
     ASSERT_TRUE(resp.flag_add_header_date);
     ASSERT_EQ(HTTP_CONTENT_TYPE_APPLICATION_JSON, resp.content_type);
     ASSERT_EQ(nullptr, resp.p_content_type_param);
@@ -2842,7 +2842,7 @@ TEST_F(TestHttpServerHandleReqGetAuth, test_auth_bearer_empty_1) // NOLINT
         &flag_access_by_bearer_token);
     ASSERT_EQ(HTTP_RESP_CODE_401, resp.http_resp_code);
     ASSERT_EQ(HTTP_CONTENT_LOCATION_STATIC_MEM, resp.content_location);
-    ASSERT_TRUE(resp.flag_no_cache);
+    ASSERT_EQ(HTTP_CACHE_CONTROL_NO_STORE, resp.cache_policy.type);
     ASSERT_TRUE(resp.flag_add_header_date);
     ASSERT_EQ(HTTP_CONTENT_TYPE_APPLICATION_JSON, resp.content_type);
     ASSERT_EQ(nullptr, resp.p_content_type_param);
@@ -2904,7 +2904,7 @@ TEST_F(TestHttpServerHandleReqGetAuth, test_auth_bearer_empty_2) // NOLINT
         &flag_access_by_bearer_token);
     ASSERT_EQ(HTTP_RESP_CODE_401, resp.http_resp_code);
     ASSERT_EQ(HTTP_CONTENT_LOCATION_STATIC_MEM, resp.content_location);
-    ASSERT_TRUE(resp.flag_no_cache);
+    ASSERT_EQ(HTTP_CACHE_CONTROL_NO_STORE, resp.cache_policy.type);
     ASSERT_TRUE(resp.flag_add_header_date);
     ASSERT_EQ(HTTP_CONTENT_TYPE_APPLICATION_JSON, resp.content_type);
     ASSERT_EQ(nullptr, resp.p_content_type_param);
@@ -2965,7 +2965,7 @@ TEST_F(TestHttpServerHandleReqGetAuth, test_auth_bearer_no_auth_not_used) // NOL
         &flag_access_by_bearer_token);
     ASSERT_EQ(HTTP_RESP_CODE_401, resp.http_resp_code);
     ASSERT_EQ(HTTP_CONTENT_LOCATION_STATIC_MEM, resp.content_location);
-    ASSERT_TRUE(resp.flag_no_cache);
+    ASSERT_EQ(HTTP_CACHE_CONTROL_NO_STORE, resp.cache_policy.type);
     ASSERT_TRUE(resp.flag_add_header_date);
     ASSERT_EQ(HTTP_CONTENT_TYPE_APPLICATION_JSON, resp.content_type);
     ASSERT_EQ(nullptr, resp.p_content_type_param);
@@ -3027,7 +3027,7 @@ TEST_F(TestHttpServerHandleReqGetAuth, test_auth_bearer_wrong_auth_not_used) //
         &flag_access_by_bearer_token);
     ASSERT_EQ(HTTP_RESP_CODE_401, resp.http_resp_code);
     ASSERT_EQ(HTTP_CONTENT_LOCATION_STATIC_MEM, resp.content_location);
-    ASSERT_TRUE(resp.flag_no_cache);
+    ASSERT_EQ(HTTP_CACHE_CONTROL_NO_STORE, resp.cache_policy.type);
     ASSERT_TRUE(resp.flag_add_header_date);
     ASSERT_EQ(HTTP_CONTENT_TYPE_APPLICATION_JSON, resp.content_type);
     ASSERT_EQ(nullptr, resp.p_content_type_param);
@@ -8,6 +8,8 @@
 #include "gtest/gtest.h"
 #include "http_server_resp.h"
 #include "http_server_auth.h"
+#include "http_server_cfg.h"
+#include "http_req.h"
 #include <string>
 
 using namespace std;
@@ -89,7 +91,7 @@ TEST_F(TestHttpServerResp, resp_400) // NOLINT
     const http_server_resp_t resp = http_server_resp_400();
     ASSERT_EQ(HTTP_RESP_CODE_400, resp.http_resp_code);
     ASSERT_EQ(HTTP_CONTENT_LOCATION_NO_CONTENT, resp.content_location);
-    ASSERT_TRUE(resp.flag_no_cache);
+    ASSERT_EQ(HTTP_CACHE_CONTROL_NO_STORE, resp.cache_policy.type);
     ASSERT_EQ(HTTP_CONTENT_TYPE_TEXT_HTML, resp.content_type);
     ASSERT_EQ(nullptr, resp.p_content_type_param);
     ASSERT_EQ(0, resp.content_len);
@@ -102,7 +104,7 @@ TEST_F(TestHttpServerResp, resp_404) // NOLINT
     const http_server_resp_t resp = http_server_resp_404();
     ASSERT_EQ(HTTP_RESP_CODE_404, resp.http_resp_code);
     ASSERT_EQ(HTTP_CONTENT_LOCATION_NO_CONTENT, resp.content_location);
-    ASSERT_TRUE(resp.flag_no_cache);
+    ASSERT_EQ(HTTP_CACHE_CONTROL_NO_STORE, resp.cache_policy.type);
     ASSERT_EQ(HTTP_CONTENT_TYPE_TEXT_HTML, resp.content_type);
     ASSERT_EQ(nullptr, resp.p_content_type_param);
     ASSERT_EQ(0, resp.content_len);
@@ -115,7 +117,7 @@ TEST_F(TestHttpServerResp, resp_409) // NOLINT
     const http_server_resp_t resp = http_server_resp_409();
     ASSERT_EQ(HTTP_RESP_CODE_409, resp.http_resp_code);
     ASSERT_EQ(HTTP_CONTENT_LOCATION_NO_CONTENT, resp.content_location);
-    ASSERT_TRUE(resp.flag_no_cache);
+    ASSERT_EQ(HTTP_CACHE_CONTROL_NO_STORE, resp.cache_policy.type);
     ASSERT_EQ(HTTP_CONTENT_TYPE_TEXT_HTML, resp.content_type);
     ASSERT_EQ(nullptr, resp.p_content_type_param);
     ASSERT_EQ(0, resp.content_len);
@@ -123,12 +125,42 @@ TEST_F(TestHttpServerResp, resp_409) // NOLINT
     ASSERT_EQ(nullptr, resp.select_location.memory.p_buf);
 }
 
+TEST_F(TestHttpServerResp, resp_413) // NOLINT
+{
+    const http_server_resp_t resp = http_server_resp_413();
+    ASSERT_EQ(HTTP_RESP_CODE_413, resp.http_resp_code);
+    ASSERT_EQ(HTTP_CONTENT_LOCATION_NO_CONTENT, resp.content_location);
+    ASSERT_EQ(HTTP_CACHE_CONTROL_NO_STORE, resp.cache_policy.type);
+    ASSERT_EQ(HTTP_CONTENT_TYPE_TEXT_HTML, resp.content_type);
+    ASSERT_EQ(nullptr, resp.p_content_type_param);
+    ASSERT_EQ(0, resp.content_len);
+    ASSERT_EQ(HTTP_CONTENT_ENCODING_NONE, resp.content_encoding);
+    ASSERT_EQ(nullptr, resp.select_location.memory.p_buf);
+}
+
+TEST_F(TestHttpServerResp, resp_200_json_generator) // NOLINT
+{
+    // The generator must not be called while preparing the response, so a dummy pointer is enough
+    uint8_t                  dummy_json_gen = 0;
+    json_stream_gen_t* const p_json_gen     = reinterpret_cast<json_stream_gen_t*>(&dummy_json_gen);
+
+    const http_server_resp_t resp = http_server_resp_200_json_generator(p_json_gen);
+    ASSERT_EQ(HTTP_RESP_CODE_200, resp.http_resp_code);
+    ASSERT_EQ(HTTP_CONTENT_LOCATION_JSON_GENERATOR, resp.content_location);
+    ASSERT_EQ(HTTP_CACHE_CONTROL_NO_STORE, resp.cache_policy.type);
+    ASSERT_EQ(HTTP_CONTENT_TYPE_APPLICATION_JSON, resp.content_type);
+    ASSERT_EQ(nullptr, resp.p_content_type_param);
+    ASSERT_EQ(SIZE_MAX, resp.content_len);
+    ASSERT_EQ(HTTP_CONTENT_ENCODING_NONE, resp.content_encoding);
+    ASSERT_EQ(p_json_gen, resp.select_location.json_generator.p_json_gen);
+}
+
 TEST_F(TestHttpServerResp, resp_503) // NOLINT
 {
     const http_server_resp_t resp = http_server_resp_503();
     ASSERT_EQ(HTTP_RESP_CODE_503, resp.http_resp_code);
     ASSERT_EQ(HTTP_CONTENT_LOCATION_NO_CONTENT, resp.content_location);
-    ASSERT_TRUE(resp.flag_no_cache);
+    ASSERT_EQ(HTTP_CACHE_CONTROL_NO_STORE, resp.cache_policy.type);
     ASSERT_EQ(HTTP_CONTENT_TYPE_TEXT_HTML, resp.content_type);
     ASSERT_EQ(nullptr, resp.p_content_type_param);
     ASSERT_EQ(0, resp.content_len);
@@ -149,7 +181,7 @@ TEST_F(TestHttpServerResp, resp_data_in_flash_html) // NOLINT
         true);
     ASSERT_EQ(HTTP_RESP_CODE_200, resp.http_resp_code);
     ASSERT_EQ(HTTP_CONTENT_LOCATION_FLASH_MEM, resp.content_location);
-    ASSERT_TRUE(resp.flag_no_cache);
+    ASSERT_EQ(HTTP_CACHE_CONTROL_NO_STORE, resp.cache_policy.type);
     ASSERT_EQ(HTTP_CONTENT_TYPE_TEXT_HTML, resp.content_type);
     ASSERT_EQ(nullptr, resp.p_content_type_param);
     ASSERT_EQ(3, resp.content_len);
@@ -171,7 +203,7 @@ TEST_F(TestHttpServerResp, resp_data_in_flash_js_gzipped_with_param) // NOLINT
         true);
     ASSERT_EQ(HTTP_RESP_CODE_200, resp.http_resp_code);
     ASSERT_EQ(HTTP_CONTENT_LOCATION_FLASH_MEM, resp.content_location);
-    ASSERT_TRUE(resp.flag_no_cache);
+    ASSERT_EQ(HTTP_CACHE_CONTROL_NO_STORE, resp.cache_policy.type);
     ASSERT_EQ(HTTP_CONTENT_TYPE_TEXT_JAVASCRIPT, resp.content_type);
     ASSERT_EQ(param_str, resp.p_content_type_param);
     ASSERT_EQ(3, resp.content_len);
@@ -195,7 +227,7 @@ TEST_F(TestHttpServerResp, resp_data_in_static_mem_plain_text_with_caching) // N
         flag_add_date);
     ASSERT_EQ(HTTP_RESP_CODE_200, resp.http_resp_code);
     ASSERT_EQ(HTTP_CONTENT_LOCATION_STATIC_MEM, resp.content_location);
-    ASSERT_EQ(flag_no_cache, resp.flag_no_cache);
+    ASSERT_EQ(flag_no_cache ? HTTP_CACHE_CONTROL_NO_STORE : HTTP_CACHE_CONTROL_DEFAULT, resp.cache_policy.type);
     ASSERT_EQ(HTTP_CONTENT_TYPE_TEXT_PLAIN, resp.content_type);
     ASSERT_EQ(nullptr, resp.p_content_type_param);
     ASSERT_EQ(4, resp.content_len);
@@ -219,7 +251,7 @@ TEST_F(TestHttpServerResp, resp_data_in_static_mem_plain_text_without_caching) /
         flag_add_date);
     ASSERT_EQ(HTTP_RESP_CODE_200, resp.http_resp_code);
     ASSERT_EQ(HTTP_CONTENT_LOCATION_STATIC_MEM, resp.content_location);
-    ASSERT_EQ(flag_no_cache, resp.flag_no_cache);
+    ASSERT_EQ(flag_no_cache ? HTTP_CACHE_CONTROL_NO_STORE : HTTP_CACHE_CONTROL_DEFAULT, resp.cache_policy.type);
     ASSERT_EQ(HTTP_CONTENT_TYPE_TEXT_PLAIN, resp.content_type);
     ASSERT_EQ(nullptr, resp.p_content_type_param);
     ASSERT_EQ(4, resp.content_len);
@@ -243,7 +275,7 @@ TEST_F(TestHttpServerResp, resp_data_in_heap_json_with_caching) // NOLINT
         flag_add_date);
     ASSERT_EQ(HTTP_RESP_CODE_200, resp.http_resp_code);
     ASSERT_EQ(HTTP_CONTENT_LOCATION_HEAP, resp.content_location);
-    ASSERT_EQ(flag_no_cache, resp.flag_no_cache);
+    ASSERT_EQ(flag_no_cache ? HTTP_CACHE_CONTROL_NO_STORE : HTTP_CACHE_CONTROL_DEFAULT, resp.cache_policy.type);
     ASSERT_EQ(HTTP_CONTENT_TYPE_APPLICATION_JSON, resp.content_type);
     ASSERT_EQ(nullptr, resp.p_content_type_param);
     ASSERT_EQ(4, resp.content_len);
@@ -267,7 +299,7 @@ TEST_F(TestHttpServerResp, resp_data_in_heap_json_without_caching) // NOLINT
         flag_add_date);
     ASSERT_EQ(HTTP_RESP_CODE_200, resp.http_resp_code);
     ASSERT_EQ(HTTP_CONTENT_LOCATION_HEAP, resp.content_location);
-    ASSERT_EQ(flag_no_cache, resp.flag_no_cache);
+    ASSERT_EQ(flag_no_cache ? HTTP_CACHE_CONTROL_NO_STORE : HTTP_CACHE_CONTROL_DEFAULT, resp.cache_policy.type);
     ASSERT_EQ(HTTP_CONTENT_TYPE_APPLICATION_JSON, resp.content_type);
     ASSERT_EQ(nullptr, resp.p_content_type_param);
     ASSERT_EQ(4, resp.content_len);
@@ -381,7 +413,7 @@ TEST_F(TestHttpServerResp, test_http_server_resp_200_auth_allow_with_new_session
         &extra_header_fields);
     ASSERT_EQ(HTTP_RESP_CODE_200, resp.http_resp_code);
     ASSERT_EQ(HTTP_CONTENT_LOCATION_STATIC_MEM, resp.content_location);
-    ASSERT_EQ(flag_no_cache, resp.flag_no_cache);
+    ASSERT_EQ(flag_no_cache ? HTTP_CACHE_CONTROL_NO_STORE : HTTP_CACHE_CONTROL_DEFAULT, resp.cache_policy.type);
     ASSERT_EQ(HTTP_CONTENT_TYPE_APPLICATION_JSON, resp.content_type);
     ASSERT_EQ(nullptr, resp.p_content_type_param);
     ASSERT_EQ(123, resp.content_len);
@@ -402,3 +434,158 @@ TEST_F(TestHttpServerResp, test_http_server_resp_200_auth_allow_with_new_session
     ASSERT_EQ("AAAAAAAAAAAAAAAA", string(p_session->session_id.buf));
     ASSERT_EQ(string(remote_ip.buf), string(p_session->remote_ip.buf));
 }
+
+TEST_F(TestHttpServerResp, test_calc_etag) // NOLINT
+{
+    const char* const p_content = "qwer";
+    const uint32_t    etag      = http_server_resp_calc_etag(
+        reinterpret_cast<const uint8_t*>(p_content),
+        strlen(p_content));
+    ASSERT_NE(0, etag);
+    ASSERT_EQ(etag, http_server_resp_calc_etag(reinterpret_cast<const uint8_t*>("qwer"), 4));
+    ASSERT_NE(etag, http_server_resp_calc_etag(reinterpret_cast<const uint8_t*>("qwes"), 4));
+    ASSERT_EQ(0x811c9dc5U, http_server_resp_calc_etag(nullptr, 0));
+
+    const uint32_t etag_file = http_server_resp_calc_etag_for_file(100, 1600000000);
+    ASSERT_NE(0, etag_file);
+    ASSERT_NE(etag_file, http_server_resp_calc_etag_for_file(101, 1600000000));
+    ASSERT_NE(etag_file, http_server_resp_calc_etag_for_file(100, 1600000001));
+}
+
+TEST_F(TestHttpServerResp, test_set_validators) // NOLINT
+{
+    http_server_resp_t resp = http_server_resp_data_in_flash(
+        HTTP_CONTENT_TYPE_TEXT_HTML,
+        nullptr,
+        4,
+        HTTP_CONTENT_ENCODING_NONE,
+        reinterpret_cast<const uint8_t*>("qwer"),
+        false);
+    ASSERT_EQ(0, resp.etag);
+    ASSERT_EQ(0, resp.last_modified);
+    http_server_resp_set_validators(&resp, 0x0123abcdU, 1600000000);
+    ASSERT_EQ(0x0123abcdU, resp.etag);
+    ASSERT_EQ(1600000000, resp.last_modified);
+}
+
+TEST_F(TestHttpServerResp, test_is_fingerprinted_path) // NOLINT
+{
+    ASSERT_TRUE(http_server_resp_is_fingerprinted_path("app.3f9a1c2b.js"));
+    ASSERT_TRUE(http_server_resp_is_fingerprinted_path("assets/app-3F9A1C2B.min.css"));
+    ASSERT_TRUE(http_server_resp_is_fingerprinted_path("3f9a1c2b.js"));
+    ASSERT_FALSE(http_server_resp_is_fingerprinted_path("index.html"));
+    ASSERT_FALSE(http_server_resp_is_fingerprinted_path("app.3f9a1c2.js"));
+    ASSERT_FALSE(http_server_resp_is_fingerprinted_path("app.3f9a1c2x.js"));
+    ASSERT_FALSE(http_server_resp_is_fingerprinted_path("app.3f9a1c2b"));
+    ASSERT_FALSE(http_server_resp_is_fingerprinted_path("3f9a1c2b.dir/app.js"));
+    ASSERT_FALSE(http_server_resp_is_fingerprinted_path(""));
+}
+
+TEST_F(TestHttpServerResp, test_set_default_cache_policy) // NOLINT
+{
+    const uint8_t* const p_content = reinterpret_cast<const uint8_t*>("qwer");
+
+    http_server_resp_t resp = http_server_resp_data_in_flash(
+        HTTP_CONTENT_TYPE_TEXT_JAVASCRIPT,
+        nullptr,
+        4,
+        HTTP_CONTENT_ENCODING_NONE,
+        p_content,
+        false);
+    http_server_resp_set_default_cache_policy(&resp, "app.js");
+    ASSERT_EQ(HTTP_CACHE_CONTROL_DEFAULT, resp.cache_policy.type);
+    http_server_resp_set_default_cache_policy(&resp, "app.3f9a1c2b.js");
+    ASSERT_EQ(HTTP_CACHE_CONTROL_IMMUTABLE, resp.cache_policy.type);
+    ASSERT_EQ(HTTP_SERVER_CACHE_IMMUTABLE_MAX_AGE, resp.cache_policy.max_age);
+
+    // The policy which is set explicitly is not changed
+    resp = http_server_resp_data_from_file(
+        HTTP_RESP_CODE_200,
+        HTTP_CONTENT_TYPE_TEXT_JAVASCRIPT,
+        nullptr,
+        4,
+        HTTP_CONTENT_ENCODING_NONE,
+        7,
+        false);
+    http_server_resp_set_cache_policy(&resp, HTTP_CACHE_CONTROL_MAX_AGE, 600);
+    http_server_resp_set_default_cache_policy(&resp, "app.3f9a1c2b.js");
+    ASSERT_EQ(HTTP_CACHE_CONTROL_MAX_AGE, resp.cache_policy.type);
+    ASSERT_EQ(600, resp.cache_policy.max_age);
+
+    // The content from memory is not made immutable
+    resp = http_server_resp_data_in_static_mem(
+        HTTP_CONTENT_TYPE_TEXT_JAVASCRIPT,
+        nullptr,
+        4,
+        HTTP_CONTENT_ENCODING_NONE,
+        p_content,
+        false,
+        false);
+    http_server_resp_set_default_cache_policy(&resp, "app.3f9a1c2b.js");
+    ASSERT_EQ(HTTP_CACHE_CONTROL_DEFAULT, resp.cache_policy.type);
+}
+
+TEST_F(TestHttpServerResp, test_select_variant) // NOLINT
+{
+    const uint8_t* const                p_identity  = reinterpret_cast<const uint8_t*>("qwertyuiop");
+    const uint8_t* const                p_gzip      = reinterpret_cast<const uint8_t*>("qwerty");
+    const uint8_t* const                p_br        = reinterpret_cast<const uint8_t*>("qwer");
+    const http_server_content_variant_t variants[2] = {
+        { HTTP_CONTENT_ENCODING_GZIP, 6, p_gzip, 0x11111111U },
+        { HTTP_CONTENT_ENCODING_BR, 4, p_br, 0x22222222U },
+    };
+
+    http_server_resp_t resp = http_server_resp_data_in_flash_with_variants(
+        HTTP_CONTENT_TYPE_TEXT_JAVASCRIPT,
+        nullptr,
+        10,
+        p_identity,
+        &variants[0],
+        2,
+        false);
+    ASSERT_EQ(HTTP_CONTENT_LOCATION_FLASH_MEM, resp.content_location);
+    ASSERT_EQ(&variants[0], resp.p_variants);
+    ASSERT_EQ(2, resp.num_variants);
+    ASSERT_FALSE(resp.flag_vary_encoding);
+
+    // The smallest acceptable variant is selected
+    http_server_resp_t resp_br = resp;
+    http_server_resp_select_variant(
+        &resp_br,
+        HTTP_REQ_ACCEPT_ENCODING_IDENTITY | HTTP_REQ_ACCEPT_ENCODING_GZIP | HTTP_REQ_ACCEPT_ENCODING_BR);
+    ASSERT_EQ(HTTP_CONTENT_ENCODING_BR, resp_br.content_encoding);
+    ASSERT_EQ(4, resp_br.content_len);
+    ASSERT_EQ(p_br, resp_br.select_location.memory.p_buf);
+    ASSERT_EQ(0x22222222U, resp_br.etag);
+    ASSERT_EQ(nullptr, resp_br.p_variants);
+    ASSERT_EQ(0, resp_br.num_variants);
+    ASSERT_TRUE(resp_br.flag_vary_encoding);
+
+    http_server_resp_t resp_gzip = resp;
+    http_server_resp_select_variant(&resp_gzip, HTTP_REQ_ACCEPT_ENCODING_IDENTITY | HTTP_REQ_ACCEPT_ENCODING_GZIP);
+    ASSERT_EQ(HTTP_CONTENT_ENCODING_GZIP, resp_gzip.content_encoding);
+    ASSERT_EQ(6, resp_gzip.content_len);
+    ASSERT_EQ(p_gzip, resp_gzip.select_location.memory.p_buf);
+    ASSERT_EQ(0x11111111U, resp_gzip.etag);
+    ASSERT_TRUE(resp_gzip.flag_vary_encoding);
+
+    // Fall back to the uncompressed content if none of the variants is acceptable
+    http_server_resp_t resp_identity = resp;
+    http_server_resp_select_variant(&resp_identity, HTTP_REQ_ACCEPT_ENCODING_IDENTITY);
+    ASSERT_EQ(HTTP_CONTENT_ENCODING_NONE, resp_identity.content_encoding);
+    ASSERT_EQ(10, resp_identity.content_len);
+    ASSERT_EQ(p_identity, resp_identity.select_location.memory.p_buf);
+    ASSERT_TRUE(resp_identity.flag_vary_encoding);
+
+    // The response without variants is not changed
+    http_server_resp_t resp_no_variants = http_server_resp_data_in_flash(
+        HTTP_CONTENT_TYPE_TEXT_JAVASCRIPT,
+        nullptr,
+        4,
+        HTTP_CONTENT_ENCODING_GZIP,
+        p_br,
+        false);
+    http_server_resp_select_variant(&resp_no_variants, HTTP_REQ_ACCEPT_ENCODING_IDENTITY);
+    ASSERT_EQ(HTTP_CONTENT_ENCODING_GZIP, resp_no_variants.content_encoding);
+    ASSERT_FALSE(resp_no_variants.flag_vary_encoding);
+}
@@ -0,0 +1,201 @@
+/**
+ * @file test_http_server_resp_hdr.cpp
+ * @author TheSomeMan
+ * @date 2026-10-17
+ * @copyright Ruuvi Innovations Ltd, license BSD-3-Clause.
+ */
+
+#include "gtest/gtest.h"
+#include "http_server_resp_hdr.h"
+#include <string>
+#include "os_mutex.h"
+
+using namespace std;
+
+/*** Google-test class implementation *********************************************************************************/
+
+class TestHttpServerRespHdr;
+
+static TestHttpServerRespHdr* g_pTestObj;
+
+class TestHttpServerRespHdr : public ::testing::Test
+{
+private:
+protected:
+    void
+    SetUp() override
+    {
+        g_pTestObj         = this;
+        this->m_cnt_lock   = 0;
+        this->m_cnt_unlock = 0;
+        http_server_resp_hdr_init();
+    }
+
+    void
+    TearDown() override
+    {
+        g_pTestObj = nullptr;
+    }
+
+public:
+    uint32_t m_cnt_lock;
+    uint32_t m_cnt_unlock;
+
+    TestHttpServerRespHdr();
+
+    ~TestHttpServerRespHdr() override;
+};
+
+TestHttpServerRespHdr::TestHttpServerRespHdr()
+    : Test()
+    , m_cnt_lock(0)
+    , m_cnt_unlock(0)
+{
+}
+
+TestHttpServerRespHdr::~TestHttpServerRespHdr() = default;
+
+extern "C" {
+
+os_mutex_t
+os_mutex_create_static(os_mutex_static_t* const p_mutex_static)
+{
+    return reinterpret_cast<os_mutex_t>(p_mutex_static);
+}
+
+void
+os_mutex_lock(os_mutex_t const h_mutex)
+{
+    g_pTestObj->m_cnt_lock += 1;
+}
+
+void
+os_mutex_unlock(os_mutex_t const h_mutex)
+{
+    g_pTestObj->m_cnt_unlock += 1;
+}
+
+} // extern "C"
+
+/*** Unit-Tests *******************************************************************************************************/
+
+TEST_F(TestHttpServerRespHdr, test_add_str_and_uint) // NOLINT
+{
+    char                   buf[64];
+    http_server_resp_hdr_t hdr = {};
+    http_server_resp_hdr_begin(&hdr, buf, sizeof(buf));
+    http_server_resp_hdr_add_str(&hdr, "Content-Length: ");
+    http_server_resp_hdr_add_uint(&hdr, 0);
+    http_server_resp_hdr_add_str(&hdr, ", ");
+    http_server_resp_hdr_add_uint(&hdr, 4294967295U);
+    http_server_resp_hdr_add_mem(&hdr, "\r\nabc", 2);
+    ASSERT_TRUE(http_server_resp_hdr_end(&hdr));
+    ASSERT_EQ(string("Content-Length: 0, 4294967295\r\n"), string(buf));
+    ASSERT_EQ(strlen(buf), hdr.len);
+}
+
+TEST_F(TestHttpServerRespHdr, test_status_line) // NOLINT
+{
+    char                   buf[64];
+    http_server_resp_hdr_t hdr = {};
+    http_server_resp_hdr_begin(&hdr, buf, sizeof(buf));
+    http_server_resp_hdr_add_status_line(&hdr, true, HTTP_RESP_CODE_200, "OK");
+    ASSERT_TRUE(http_server_resp_hdr_end(&hdr));
+    ASSERT_EQ(string("HTTP/1.1 200 OK\r\n"), string(buf));
+
+    http_server_resp_hdr_begin(&hdr, buf, sizeof(buf));
+    http_server_resp_hdr_add_status_line(&hdr, false, HTTP_RESP_CODE_404, "Not Found");
+    ASSERT_TRUE(http_server_resp_hdr_end(&hdr));
+    ASSERT_EQ(string("HTTP/1.0 404 Not Found\r\n"), string(buf));
+}
+
+TEST_F(TestHttpServerRespHdr, test_overflow) // NOLINT
+{
+    char                   buf[8];
+    http_server_resp_hdr_t hdr = {};
+    http_server_resp_hdr_begin(&hdr, buf, sizeof(buf));
+    http_server_resp_hdr_add_str(&hdr, "1234567");
+    ASSERT_FALSE(hdr.flag_overflow);
+    http_server_resp_hdr_add_str(&hdr, "8");
+    ASSERT_TRUE(hdr.flag_overflow);
+    ASSERT_EQ(7, hdr.len);
+    ASSERT_FALSE(http_server_resp_hdr_end(&hdr));
+}
+
+TEST_F(TestHttpServerRespHdr, test_date) // NOLINT
+{
+    char                   buf[128];
+    http_server_resp_hdr_t hdr = {};
+    http_server_resp_hdr_begin(&hdr, buf, sizeof(buf));
+    http_server_resp_hdr_add_date(&hdr);
+    http_server_resp_hdr_add_date(&hdr);
+    ASSERT_TRUE(http_server_resp_hdr_end(&hdr));
+    const size_t date_len = strlen(HTTP_SERVER_RESP_HDR_DATE_EXAMPLE);
+    ASSERT_EQ(2 * date_len, hdr.len);
+    const string date1 = string(buf, date_len);
+    const string date2 = string(&buf[date_len], date_len);
+    ASSERT_EQ(string("Date: "), date1.substr(0, 6));
+    ASSERT_EQ(string(" GMT\r\n"), date1.substr(date_len - 6));
+    ASSERT_EQ(date1.substr(0, date_len - 8), date2.substr(0, date_len - 8));
+    ASSERT_EQ(2, this->m_cnt_lock);
+    ASSERT_EQ(2, this->m_cnt_unlock);
+}
+
+TEST_F(TestHttpServerRespHdr, test_validators) // NOLINT
+{
+    char                   buf[128];
+    http_server_resp_hdr_t hdr  = {};
+    http_server_resp_t     resp = {};
+    resp.etag                   = 0x0123abcdU;
+    resp.last_modified          = 784111777; // Sun, 06 Nov 1994 08:49:37 GMT
+    http_server_resp_hdr_begin(&hdr, buf, sizeof(buf));
+    http_server_resp_hdr_add_validators(&hdr, &resp);
+    ASSERT_TRUE(http_server_resp_hdr_end(&hdr));
+    ASSERT_EQ(
+        string("ETag: \"0123abcd\"\r\n"
+               "Last-Modified: Sun, 06 Nov 1994 08:49:37 GMT\r\n"),
+        string(buf));
+
+    resp.etag          = 0;
+    resp.last_modified = 0;
+    http_server_resp_hdr_begin(&hdr, buf, sizeof(buf));
+    http_server_resp_hdr_add_validators(&hdr, &resp);
+    ASSERT_TRUE(http_server_resp_hdr_end(&hdr));
+    ASSERT_EQ(string(""), string(buf));
+}
+
+TEST_F(TestHttpServerRespHdr, test_cache_control) // NOLINT
+{
+    char                   buf[128];
+    http_server_resp_hdr_t hdr  = {};
+    http_server_resp_t     resp = {};
+
+    resp.cache_policy.type = HTTP_CACHE_CONTROL_DEFAULT;
+    http_server_resp_hdr_begin(&hdr, buf, sizeof(buf));
+    http_server_resp_hdr_add_cache_control(&hdr, &resp);
+    ASSERT_TRUE(http_server_resp_hdr_end(&hdr));
+    ASSERT_EQ(string(""), string(buf));
+
+    resp.cache_policy.type = HTTP_CACHE_CONTROL_NO_STORE;
+    http_server_resp_hdr_begin(&hdr, buf, sizeof(buf));
+    http_server_resp_hdr_add_cache_control(&hdr, &resp);
+    ASSERT_TRUE(http_server_resp_hdr_end(&hdr));
+    ASSERT_EQ(
+        string("Cache-Control: no-store, no-cache, must-revalidate, max-age=0\r\n"
+               "Pragma: no-cache\r\n"),
+        string(buf));
+
+    resp.cache_policy.type    = HTTP_CACHE_CONTROL_MAX_AGE;
+    resp.cache_policy.max_age = 600;
+    http_server_resp_hdr_begin(&hdr, buf, sizeof(buf));
+    http_server_resp_hdr_add_cache_control(&hdr, &resp);
+    ASSERT_TRUE(http_server_resp_hdr_end(&hdr));
+    ASSERT_EQ(string("Cache-Control: max-age=600\r\n"), string(buf));
+
+    resp.cache_policy.type    = HTTP_CACHE_CONTROL_IMMUTABLE;
+    resp.cache_policy.max_age = 31536000;
+    http_server_resp_hdr_begin(&hdr, buf, sizeof(buf));
+    http_server_resp_hdr_add_cache_control(&hdr, &resp);
+    ASSERT_TRUE(http_server_resp_hdr_end(&hdr));
+    ASSERT_EQ(string("Cache-Control: public, max-age=31536000, immutable\r\n"), string(buf));
+}
@@ -0,0 +1,256 @@
+/**
+ * @file test_http_server_route.cpp
+ * @author TheSomeMan
+ * @date 2026-10-17
+ * @copyright Ruuvi Innovations Ltd, license BSD-3-Clause.
+ */
+
+#include "gtest/gtest.h"
+#include "http_server_route.h"
+#include "http_server_route_internal.h"
+#include <string>
+#include <vector>
+#include "http_server_cfg.h"
+#include "os_mutex.h"
+
+using namespace std;
+
+/*** Google-test class implementation *********************************************************************************/
+
+class TestHttpServerRoute;
+
+static TestHttpServerRoute* g_pTestObj;
+
+class TestHttpServerRoute : public ::testing::Test
+{
+private:
+protected:
+    void
+    SetUp() override
+    {
+        g_pTestObj         = this;
+        this->m_cnt_lock   = 0;
+        this->m_cnt_unlock = 0;
+        http_server_route_init();
+    }
+
+    void
+    TearDown() override
+    {
+        g_pTestObj = nullptr;
+    }
+
+public:
+    uint32_t m_cnt_lock;
+    uint32_t m_cnt_unlock;
+
+    TestHttpServerRoute();
+
+    ~TestHttpServerRoute() override;
+};
+
+TestHttpServerRoute::TestHttpServerRoute()
+    : Test()
+    , m_cnt_lock(0)
+    , m_cnt_unlock(0)
+{
+}
+
+TestHttpServerRoute::~TestHttpServerRoute() = default;
+
+extern "C" {
+
+os_mutex_t
+os_mutex_create_static(os_mutex_static_t* const p_mutex_static)
+{
+    return reinterpret_cast<os_mutex_t>(p_mutex_static);
+}
+
+void
+os_mutex_lock(os_mutex_t const h_mutex)
+{
+    g_pTestObj->m_cnt_lock += 1;
+}
+
+void
+os_mutex_unlock(os_mutex_t const h_mutex)
+{
+    g_pTestObj->m_cnt_unlock += 1;
+}
+
+} // extern "C"
+
+/*** Unit-Tests *******************************************************************************************************/
+
+static http_server_resp_t
+test_handler(const http_server_route_req_t* const p_req, void* const p_user_data)
+{
+    http_server_resp_t resp = {};
+    resp.http_resp_code     = HTTP_RESP_CODE_200;
+    return resp;
+}
+
+static http_server_resp_t
+test_handler2(const http_server_route_req_t* const p_req, void* const p_user_data)
+{
+    http_server_resp_t resp = {};
+    resp.http_resp_code     = HTTP_RESP_CODE_404;
+    return resp;
+}
+
+TEST_F(TestHttpServerRoute, test_parse_method) // NOLINT
+{
+    http_server_route_method_e method = HTTP_SERVER_ROUTE_METHOD_GET;
+    ASSERT_TRUE(http_server_route_parse_method("POST", &method));
+    ASSERT_EQ(HTTP_SERVER_ROUTE_METHOD_POST, method);
+    ASSERT_TRUE(http_server_route_parse_method("DELETE", &method));
+    ASSERT_EQ(HTTP_SERVER_ROUTE_METHOD_DELETE, method);
+    ASSERT_TRUE(http_server_route_parse_method("GET", &method));
+    ASSERT_EQ(HTTP_SERVER_ROUTE_METHOD_GET, method);
+    method = HTTP_SERVER_ROUTE_METHOD_POST;
+    ASSERT_TRUE(http_server_route_parse_method("HEAD", &method));
+    ASSERT_EQ(HTTP_SERVER_ROUTE_METHOD_GET, method);
+    ASSERT_FALSE(http_server_route_parse_method("PUT", &method));
+    ASSERT_FALSE(http_server_route_parse_method("get", &method));
+}
+
+TEST_F(TestHttpServerRoute, test_find_builtin) // NOLINT
+{
+    struct
+    {
+        http_server_route_method_e method;
+        const char*                p_path;
+        http_server_route_id_e     id;
+    } const routes[] = {
+        { HTTP_SERVER_ROUTE_METHOD_GET, "auth", HTTP_SERVER_ROUTE_ID_GET_AUTH },
+        { HTTP_SERVER_ROUTE_METHOD_GET, "ap.json", HTTP_SERVER_ROUTE_ID_GET_AP_JSON },
+        { HTTP_SERVER_ROUTE_METHOD_GET, "status.json", HTTP_SERVER_ROUTE_ID_GET_STATUS_JSON },
+        { HTTP_SERVER_ROUTE_METHOD_POST, "auth", HTTP_SERVER_ROUTE_ID_POST_AUTH },
+        { HTTP_SERVER_ROUTE_METHOD_POST, "connect.json", HTTP_SERVER_ROUTE_ID_POST_CONNECT_JSON },
+        { HTTP_SERVER_ROUTE_METHOD_POST, "connect_wps", HTTP_SERVER_ROUTE_ID_POST_CONNECT_WPS },
+        { HTTP_SERVER_ROUTE_METHOD_DELETE, "auth", HTTP_SERVER_ROUTE_ID_DELETE_AUTH },
+        { HTTP_SERVER_ROUTE_METHOD_DELETE, "connect.json", HTTP_SERVER_ROUTE_ID_DELETE_CONNECT_JSON },
+    };
+    for (const auto& item : routes)
+    {
+        http_server_route_t route = {};
+        ASSERT_TRUE(http_server_route_find(item.method, item.p_path, &route)) << item.p_path;
+        ASSERT_EQ(item.id, route.id);
+        ASSERT_EQ(item.method, route.method);
+        ASSERT_EQ(string(item.p_path), string(route.p_path));
+        ASSERT_EQ(nullptr, route.handler);
+    }
+    // The built-in routes are found without locking the mutex
+    ASSERT_EQ(0, this->m_cnt_lock);
+
+    http_server_route_t route = {};
+    ASSERT_FALSE(http_server_route_find(HTTP_SERVER_ROUTE_METHOD_DELETE, "ap.json", &route));
+    ASSERT_FALSE(http_server_route_find(HTTP_SERVER_ROUTE_METHOD_GET, "connect_wps", &route));
+    ASSERT_FALSE(http_server_route_find(HTTP_SERVER_ROUTE_METHOD_GET, "index.html", &route));
+    ASSERT_FALSE(http_server_route_find(HTTP_SERVER_ROUTE_METHOD_GET, "auth2", &route));
+}
+
+TEST_F(TestHttpServerRoute, test_policy_of_builtin) // NOLINT
+{
+    http_server_route_t route = {};
+    ASSERT_TRUE(http_server_route_find(HTTP_SERVER_ROUTE_METHOD_GET, "status.json", &route));
+    ASSERT_EQ(HTTP_SERVER_ROUTE_AUTH_REQUIRED, route.policy.auth);
+    ASSERT_TRUE(route.policy.flag_lan_allowed);
+
+    ASSERT_TRUE(http_server_route_find(HTTP_SERVER_ROUTE_METHOD_POST, "connect.json", &route));
+    ASSERT_EQ(HTTP_SERVER_ROUTE_AUTH_BEARER_RW, route.policy.auth);
+    ASSERT_FALSE(route.policy.flag_lan_allowed);
+
+    ASSERT_TRUE(http_server_route_find(HTTP_SERVER_ROUTE_METHOD_POST, "auth", &route));
+    ASSERT_EQ(HTTP_SERVER_ROUTE_AUTH_NONE, route.policy.auth);
+}
+
+TEST_F(TestHttpServerRoute, test_register_and_unregister) // NOLINT
+{
+    const http_server_route_policy_t policy = {
+        .auth             = HTTP_SERVER_ROUTE_AUTH_BEARER_RW,
+        .flag_lan_allowed = false,
+    };
+    int user_data = 0;
+    ASSERT_TRUE(http_server_route_register(
+        HTTP_SERVER_ROUTE_METHOD_POST,
+        "/bluetooth_scanning",
+        policy,
+        &test_handler,
+        &user_data));
+    ASSERT_TRUE(http_server_route_register(
+        HTTP_SERVER_ROUTE_METHOD_GET,
+        "bluetooth_scanning",
+        policy,
+        &test_handler2,
+        nullptr));
+
+    // Duplicates, built-in routes and routes without a handler are rejected
+    ASSERT_FALSE(http_server_route_register(
+        HTTP_SERVER_ROUTE_METHOD_POST,
+        "bluetooth_scanning",
+        policy,
+        &test_handler,
+        nullptr));
+    ASSERT_FALSE(http_server_route_register(
+        HTTP_SERVER_ROUTE_METHOD_GET,
+        "/status.json",
+        policy,
+        &test_handler,
+        nullptr));
+    ASSERT_FALSE(http_server_route_register(HTTP_SERVER_ROUTE_METHOD_GET, "metrics", policy, nullptr, nullptr));
+
+    http_server_route_t route = {};
+    ASSERT_TRUE(http_server_route_find(HTTP_SERVER_ROUTE_METHOD_POST, "bluetooth_scanning", &route));
+    ASSERT_EQ(HTTP_SERVER_ROUTE_ID_APP, route.id);
+    ASSERT_EQ(HTTP_SERVER_ROUTE_METHOD_POST, route.method);
+    ASSERT_EQ(string("bluetooth_scanning"), string(route.p_path));
+    ASSERT_EQ(HTTP_SERVER_ROUTE_AUTH_BEARER_RW, route.policy.auth);
+    ASSERT_FALSE(route.policy.flag_lan_allowed);
+    ASSERT_EQ(&test_handler, route.handler);
+    ASSERT_EQ(&user_data, route.p_user_data);
+
+    ASSERT_TRUE(http_server_route_find(HTTP_SERVER_ROUTE_METHOD_GET, "bluetooth_scanning", &route));
+    ASSERT_EQ(&test_handler2, route.handler);
+    ASSERT_FALSE(http_server_route_find(HTTP_SERVER_ROUTE_METHOD_DELETE, "bluetooth_scanning", &route));
+
+    ASSERT_TRUE(http_server_route_unregister(HTTP_SERVER_ROUTE_METHOD_POST, "/bluetooth_scanning"));
+    ASSERT_FALSE(http_server_route_unregister(HTTP_SERVER_ROUTE_METHOD_POST, "bluetooth_scanning"));
+    ASSERT_FALSE(http_server_route_find(HTTP_SERVER_ROUTE_METHOD_POST, "bluetooth_scanning", &route));
+    ASSERT_TRUE(http_server_route_unregister(HTTP_SERVER_ROUTE_METHOD_GET, "bluetooth_scanning"));
+    ASSERT_EQ(this->m_cnt_lock, this->m_cnt_unlock);
+}
+
+TEST_F(TestHttpServerRoute, test_register_table_full) // NOLINT
+{
+    const http_server_route_policy_t policy = {
+        .auth             = HTTP_SERVER_ROUTE_AUTH_REQUIRED,
+        .flag_lan_allowed = true,
+    };
+    std::vector<string> paths;
+    for (uint32_t i = 0; i <= HTTP_SERVER_MAX_APP_ROUTES; ++i)
+    {
+        paths.push_back("path" + std::to_string(i));
+    }
+    for (uint32_t i = 0; i < HTTP_SERVER_MAX_APP_ROUTES; ++i)
+    {
+        ASSERT_TRUE(http_server_route_register(
+            HTTP_SERVER_ROUTE_METHOD_GET,
+            paths[i].c_str(),
+            policy,
+            &test_handler,
+            nullptr));
+    }
+    ASSERT_FALSE(http_server_route_register(
+        HTTP_SERVER_ROUTE_METHOD_GET,
+        paths[HTTP_SERVER_MAX_APP_ROUTES].c_str(),
+        policy,
+        &test_handler,
+        nullptr));
+    for (uint32_t i = 0; i < HTTP_SERVER_MAX_APP_ROUTES; ++i)
+    {
+        http_server_route_t route = {};
+        ASSERT_TRUE(http_server_route_find(HTTP_SERVER_ROUTE_METHOD_GET, paths[i].c_str(), &route));
+        ASSERT_TRUE(http_server_route_unregister(HTTP_SERVER_ROUTE_METHOD_GET, paths[i].c_str()));
+    }
+}